@@ -16,35 +16,42 @@ fn main() {
     // Get the target architecture
     let target_arch = env::var("CARGO_CFG_TARGET_ARCH").unwrap();
 
+    // With the `host-test` feature the crate is built as an ordinary hosted
+    // binary so unit tests can run on the build machine; the bare-metal
+    // linker setup must not apply there.
+    let host_test = env::var("CARGO_FEATURE_HOST_TEST").is_ok();
+
     // Only build C code for x86_64
     if target_arch == "x86_64" {
-        build_x86_64_c();
-        configure_linker_x86_64();
+        build_x86_64_c(host_test);
+        if !host_test {
+            configure_linker_x86_64();
+        }
     }
 }
 
 fn configure_linker_x86_64() {
     // Use custom linker script for bare-metal kernel
-    println!("cargo:rustc-link-arg=-Tsrc/kernel/kernel_minimal.ld");
+    println!("cargo:rustc-link-arg-bin=rustux=-Tsrc/kernel/kernel_minimal.ld");
 
     // Set entry point
-    println!("cargo:rustc-link-arg=-entry=kmain");
+    println!("cargo:rustc-link-arg-bin=rustux=-entry=kmain");
 
     // Disable standard library startup files
-    println!("cargo:rustc-link-arg=-nostartfiles");
+    println!("cargo:rustc-link-arg-bin=rustux=-nostartfiles");
 
     // Disable PIE
-    println!("cargo:rustc-link-arg=-no-pie");
+    println!("cargo:rustc-link-arg-bin=rustux=-no-pie");
 
     // Use rust-lld
-    println!("cargo:rustc-link-arg=-fuse-ld=lld");
+    println!("cargo:rustc-link-arg-bin=rustux=-fuse-ld=lld");
 
     // Include all objects from sys_x86
-    println!("cargo:rustc-link-arg=-Wl,--whole-archive");
-    println!("cargo:rustc-link-arg=-Wl,-Bstatic");
+    println!("cargo:rustc-link-arg-bin=rustux=-Wl,--whole-archive");
+    println!("cargo:rustc-link-arg-bin=rustux=-Wl,-Bstatic");
 }
 
-fn build_x86_64_c() {
+fn build_x86_64_c(host_test: bool) {
     // Get the output directory
     let out_dir = PathBuf::from(env::var("OUT_DIR").unwrap());
     let manifest_dir = PathBuf::from(env::var("CARGO_MANIFEST_DIR").unwrap());
@@ -102,15 +109,17 @@ fn build_x86_64_c() {
     // Find and directly link the multiboot header object file
     // This ensures it's included even without references
     let multiboot_obj = out_dir.join("multiboot_header.o");
-    if multiboot_obj.exists() {
-        println!("cargo:rustc-link-arg={}", multiboot_obj.display());
+    if host_test {
+        // Hosted test binaries must not carry the multiboot header.
+    } else if multiboot_obj.exists() {
+        println!("cargo:rustc-link-arg-bin=rustux={}", multiboot_obj.display());
     } else {
         // Try to find it with a hash prefix
         if let Ok(entries) = std::fs::read_dir(&out_dir) {
             for entry in entries.flatten() {
                 let path = entry.path();
                 if path.to_string_lossy().contains("multiboot_header") {
-                    println!("cargo:rustc-link-arg={}", path.display());
+                    println!("cargo:rustc-link-arg-bin=rustux={}", path.display());
                     break;
                 }
             }
@@ -164,7 +164,10 @@ unsafe impl GlobalAlloc for LinkedListAllocator {
 }
 
 /// Global allocator instance
-#[global_allocator]
+///
+/// Host test builds use the system allocator instead; the kernel heap
+/// is never initialized there.
+#[cfg_attr(not(test), global_allocator)]
 static ALLOCATOR: LinkedListAllocator = LinkedListAllocator {
     free_list: AtomicUsize::new(0),
 };
@@ -329,7 +329,13 @@ pub unsafe fn arch_thread_initialize(thread: *mut Thread) {
 ///
 /// Both pointers must be valid and this must only be called from proper context
 pub unsafe fn arch_context_switch(old_thread: *mut Thread, new_thread: *mut Thread) {
-    // TODO: Implement context switch
+    // Extended (FPU/SSE/AVX) state is handled lazily: the outgoing
+    // thread's state is saved only if it actually used the FPU since it
+    // was switched in, and the incoming thread's state is restored from
+    // the #NM trap on first use rather than here.
+    x86_extended_register_context_switch(old_thread, new_thread);
+
+    // TODO: Switch general register state (stack pointer, fs/gs bases)
     let _ = old_thread;
     let _ = new_thread;
 }
@@ -291,6 +291,16 @@ fn x86_invop_handler(frame: &mut X86Iframe) {
     exception_die(frame, "invalid opcode, halting\n");
 }
 
+/// Device not available (#NM) handler
+///
+/// First FPU/SSE instruction since this thread was switched in; restore
+/// its extended register state lazily instead of on every context switch.
+fn x86_nm_handler(_frame: &mut X86Iframe) {
+    unsafe {
+        x86_extended_register_nm_handler();
+    }
+}
+
 /// Double fault handler
 fn x86_df_handler(frame: &X86Iframe) {
     // Do not give the user exception handler the opportunity to handle double faults
@@ -424,7 +434,7 @@ pub unsafe extern "C" fn x86_exception_handler(frame: *mut X86Iframe, vector: u6
             x86_invop_handler(frame);
         }
         X86_INT_DEVICE_NA => {
-            exception_die(frame, "device na fault\n");
+            x86_nm_handler(frame);
         }
         X86_INT_DOUBLE_FAULT => {
             x86_df_handler(frame);
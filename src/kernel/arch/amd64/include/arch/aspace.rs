@@ -244,6 +244,8 @@ pub struct X86ArchVmAspace {
     size: usize,
     /// CPUs that are currently executing in this address space
     active_cpus: AtomicInt,
+    /// PCID tagging this space's TLB entries (MMU_X86_UNUSED_PCID if none)
+    pcid: u16,
 }
 
 /// Storage for either an MMU page table or an EPT
@@ -288,6 +290,7 @@ impl X86ArchVmAspace {
             base: 0,
             size: 0,
             active_cpus: AtomicInt::new(0),
+            pcid: MMU_X86_UNUSED_PCID,
         }
     }
 
@@ -341,8 +344,15 @@ impl X86ArchVmAspace {
                     return status;
                 }
             }
+
+            // Tag this space's TLB entries with a PCID so context
+            // switches away from it keep them warm. Allocation failure
+            // just leaves the flushing fallback in place.
+            if crate::kernel::arch::amd64::arch::is_user_address(base as usize) {
+                self.pcid = x86_pcid_alloc();
+            }
         }
-        
+
         status::OK
     }
 
@@ -362,11 +372,16 @@ impl X86ArchVmAspace {
             if status != status::OK {
                 return status;
             }
-            
+
             // Clear the pointer
             self.pt = core::ptr::null_mut();
         }
-        
+
+        // Shoot down any TLB entries still tagged for this space and
+        // return the PCID to the allocator.
+        x86_pcid_free(self.pcid);
+        self.pcid = MMU_X86_UNUSED_PCID;
+
         status::OK
     }
 
@@ -531,11 +546,31 @@ impl X86ArchVmAspace {
 
     /// Switch from one address space to another
     ///
+    /// When the target space carries a PCID the CR3 load is non-flushing:
+    /// its TLB entries are still warm from the last time it ran and every
+    /// other context's entries survive too. Spaces without a PCID fall
+    /// back to the flushing switch.
+    ///
     /// # Arguments
     ///
     /// * `from` - Address space to switch from (may be NULL)
     /// * `to` - Address space to switch to
     pub fn context_switch(from: Option<&mut Self>, to: &mut Self) {
+        debug_assert!(to.canary.assert_magic(VAAS_MAGIC));
+
+        // Record residency so TLB shootdowns can skip CPUs that have
+        // since switched away from the unmapped space.
+        let cpu = crate::kernel::percpu::get_local_percpu();
+        cpu.active_aspace.store(to as *const Self as u64, Ordering::Release);
+        cpu.aspace_generation.fetch_add(1, Ordering::Release);
+
+        if x86_pcid_enabled() && to.pcid != MMU_X86_UNUSED_PCID {
+            unsafe {
+                write_cr3(x86_pcid_cr3(to.arch_table_phys(), to.pcid));
+            }
+            return;
+        }
+
         unsafe {
             match from {
                 Some(from_aspace) => sys_x86_arch_vm_aspace_context_switch(from_aspace, to),
@@ -9,8 +9,17 @@
 //! This module provides page table management for x86-64.
 
 
+use core::sync::atomic::{AtomicBool, Ordering};
+
 use crate::rustux::types::*;
+use crate::kernel::arch::amd64::feature;
+use crate::kernel::arch::amd64::include::arch::defines::ARCH_PHYSMAP_SIZE;
 use crate::kernel::arch::amd64::page_tables::constants::*;
+use crate::kernel::arch::amd64::page_tables::mmu_flags::{
+    X86_MMU_PG_G, X86_MMU_PG_NX, X86_MMU_PG_P, X86_MMU_PG_PS, X86_MMU_PG_W, X86_PG_FRAME,
+};
+use crate::kernel::arch::amd64::registers::{cr, x86_get_cr4, x86_set_cr4};
+use crate::kernel::sync::spin::SpinMutex;
 
 // Page size constants
 pub const PAGE_SIZE: usize = 4096;
@@ -21,7 +30,10 @@ pub const IA32_PAT_MSR: u32 = 0x277;
 pub const IA32_MTRR_CAP_MSR: u32 = 0xFE;
 pub const IA32_MTRR_DEF_TYPE_MSR: u32 = 0x2FF;
 
-// PAT register default values (write-back caching)
+// PAT register value programmed on every CPU. Each byte is one PAT
+// entry: index 0 = WB (0x06), 1 = WC (0x01), 2 = UC- (0x07),
+// 3 = UC (0x00), mirrored into indices 4-7. Page table entries select
+// an index via PWT/PCD/PAT bits; see terminal_flags() in page_tables.
 pub const PAT_DEFAULT_VALUE: u64 = 0x0007010600070106;
 
 // Global page table state (simplified - in real kernel would be per-address space)
@@ -64,6 +76,9 @@ pub fn x86_mmu_init() {
         // Initialize large page support detection
         x86_detect_huge_page_support();
     }
+
+    // Turn on PCID-tagged TLB entries if the CPU supports them
+    x86_pcid_init();
 }
 
 /// Per-CPU MMU initialization
@@ -152,52 +167,201 @@ pub fn read_cr3() -> PAddr {
 /// Physical address of the PML4 table
 pub fn x86_boot_create_page_tables() -> PAddr {
     unsafe {
-        // Allocate page-aligned memory for page tables
-        // In a real kernel, this would come from a physical memory allocator
-        // For now, we use a simplified approach
-
-        // Page table entry flags
-        const PTE_P: u64 = 0x001;  // Present
-        const PTE_W: u64 = 0x002;  // Read/Write
-        const PTE_U: u64 = 0x004;  // User
-        const PTE_G: u64 = 0x100;  // Global
-
-        // Allocate PML4 (should be page-aligned)
-        let pml4_addr = 0x10000 as PAddr; // Placeholder - should be allocated
-        let pml4: *mut u64 = pml4_addr as *mut u64;
-
-        // Zero the PML4
-        for i in 0..512 {
-            *pml4.add(i) = 0;
-        }
+        x86_detect_huge_page_support();
+
+        let (pml4_addr, pml4) = boot_pt_alloc();
+
+        // Identity map the first 2GB for the transition off the boot
+        // mappings. This is torn down once the kernel is running high.
+        boot_pt_map_range(pml4, 0, 0, 2 * (HUGE_PAGE_SIZE as u64),
+                          X86_MMU_PG_P | X86_MMU_PG_W);
+
+        // Map the physmap with the largest pages the CPU has. With 1GB
+        // pages the whole physmap costs one TLB entry per gigabyte, which
+        // is what keeps PMM-heavy workloads from thrashing the dTLB; 2MB
+        // pages are the fallback on CPUs without pdpe1gb.
+        boot_pt_map_range(pml4, crate::kernel::arch::KERNEL_BASE as usize, 0,
+                          ARCH_PHYSMAP_SIZE as u64,
+                          X86_MMU_PG_P | X86_MMU_PG_W | X86_MMU_PG_G | X86_MMU_PG_NX);
+
+        // Now apply W^X over the kernel image in one batched pass: text
+        // becomes read-execute, rodata read-only no-execute, and data
+        // keeps write but loses execute. Large pages are kept wherever a
+        // whole 2MB chunk falls inside one section and only split at the
+        // (4K-aligned) section boundaries.
+        x86_boot_protect_kernel_image(pml4);
+
+        // Return the physical address of PML4
+        pml4_addr
+    }
+}
+
+// Boot page-table frames come from a watermark allocator over a low-memory
+// scratch region that the bootloader keeps free. Worst case is the 2MB
+// physmap fallback: 1 PML4 + 2 PDPTs + (2 + physmap-size/1GB) PDs + a
+// handful of PTs for the W^X boundary splits, comfortably inside the region.
+const BOOT_PT_BASE: PAddr = 0x10000;
+const BOOT_PT_LIMIT: PAddr = 0x90000;
+static mut BOOT_PT_NEXT: PAddr = BOOT_PT_BASE;
+
+// Physical-frame masks for large page table entries.
+const BOOT_PT_1GB_FRAME: u64 = 0x000F_FFFF_C000_0000;
+const BOOT_PT_2MB_FRAME: u64 = 0x000F_FFFF_FFE0_0000;
+
+/// Allocate and zero one boot page-table frame.
+///
+/// # Safety
+///
+/// Only usable while the boot identity mapping covers low memory.
+unsafe fn boot_pt_alloc() -> (PAddr, *mut u64) {
+    let pa = BOOT_PT_NEXT;
+    if pa + PAGE_SIZE as u64 > BOOT_PT_LIMIT {
+        panic!("out of boot page-table frames");
+    }
+    BOOT_PT_NEXT = pa + PAGE_SIZE as u64;
+
+    let table = pa as *mut u64;
+    for i in 0..NO_OF_PT_ENTRIES {
+        *table.add(i) = 0;
+    }
+    (pa, table)
+}
+
+/// Walk one level down from |entry|, allocating the next table on demand.
+unsafe fn boot_pt_get_table(entry: *mut u64) -> *mut u64 {
+    if *entry & X86_MMU_PG_P == 0 {
+        let (pa, table) = boot_pt_alloc();
+        *entry = pa as u64 | X86_MMU_PG_P | X86_MMU_PG_W;
+        table
+    } else {
+        (*entry & X86_PG_FRAME) as *mut u64
+    }
+}
 
-        // Allocate PDPTE, PDE, and PT (simplified - use 2MB pages)
-        let pdpt_addr = 0x11000 as PAddr;
-        let pd_addr = 0x12000 as PAddr;
+/// Map [paddr, paddr + size) at |vaddr| using the largest page size each
+/// chunk's alignment and the CPU allow: 1GB, then 2MB, then 4K.
+unsafe fn boot_pt_map_range(pml4: *mut u64, vaddr: usize, paddr: u64, size: u64, flags: u64) {
+    let use_1gb = HUGE_1GB_PAGES.load(Ordering::Relaxed);
+
+    let mut va = vaddr as u64;
+    let mut pa = paddr;
+    let end = paddr + size;
+    while pa < end {
+        let pml4e = pml4.add((va as usize >> PML4_SHIFT) & (NO_OF_PT_ENTRIES - 1));
+        let pdpt = boot_pt_get_table(pml4e);
+        let pdpte = pdpt.add((va as usize >> PDP_SHIFT) & (NO_OF_PT_ENTRIES - 1));
+
+        let huge = HUGE_PAGE_SIZE as u64;
+        if use_1gb && va % huge == 0 && pa % huge == 0 && end - pa >= huge {
+            *pdpte = pa | flags | X86_MMU_PG_PS;
+            va += huge;
+            pa += huge;
+            continue;
+        }
 
-        let pdpt: *mut u64 = pdpt_addr as *mut u64;
-        let pd: *mut u64 = pd_addr as *mut u64;
+        let pd = boot_pt_get_table(pdpte);
+        let pde = pd.add((va as usize >> PD_SHIFT) & (NO_OF_PT_ENTRIES - 1));
 
-        // Zero tables
-        for i in 0..512 {
-            *pdpt.add(i) = 0;
-            *pd.add(i) = 0;
+        let large = LARGE_PAGE_SIZE as u64;
+        if va % large == 0 && pa % large == 0 && end - pa >= large {
+            *pde = pa | flags | X86_MMU_PG_PS;
+            va += large;
+            pa += large;
+            continue;
         }
 
-        // Set up PML4[0] to point to PDPT
-        *pml4 = pdpt_addr | PTE_P | PTE_W;
+        let pt = boot_pt_get_table(pde);
+        let pte = pt.add((va as usize >> PT_SHIFT) & (NO_OF_PT_ENTRIES - 1));
+        *pte = pa | flags;
+        va += PAGE_SIZE as u64;
+        pa += PAGE_SIZE as u64;
+    }
+}
 
-        // Set up PDPTE[0] to point to PD
-        *pdpt = pd_addr | PTE_P | PTE_W;
+/// W^X flags for one kernel image address.
+fn kernel_image_flags(va: usize, code_end: usize, rodata_end: usize) -> u64 {
+    if va < code_end {
+        // text: read-execute
+        X86_MMU_PG_P | X86_MMU_PG_G
+    } else if va < rodata_end {
+        // rodata: read-only, no-execute
+        X86_MMU_PG_P | X86_MMU_PG_G | X86_MMU_PG_NX
+    } else {
+        // data/bss: read-write, no-execute
+        X86_MMU_PG_P | X86_MMU_PG_W | X86_MMU_PG_G | X86_MMU_PG_NX
+    }
+}
 
-        // Set up 2MB pages mapping the first 2GB of memory identically
-        for i in 0..1024 {
-            // Identity map with 2MB pages: present, writable, global
-            *pd.add(i) = (i * 0x200000) as u64 | PTE_P | PTE_W | PTE_G | 0x080; // PS=1 for 2MB pages
+/// Apply W^X permissions across the kernel image in one pass.
+///
+/// The image is covered by the physmap's large mappings; this walks the
+/// image range once, keeps 2MB mappings for chunks that lie entirely
+/// within one section, and splits only the chunks containing a section
+/// boundary down to 4K. Doing all sections in a single pass means there
+/// is never a window with text writable, and there are no per-section
+/// TLB shootdowns: the tables are not live until CR3 is loaded.
+unsafe fn x86_boot_protect_kernel_image(pml4: *mut u64) {
+    extern "C" {
+        static __code_start: u8;
+        static __code_end: u8;
+        static __rodata_end: u8;
+        static _end: u8;
+    }
+    let code_start = &__code_start as *const u8 as usize;
+    let code_end = &__code_end as *const u8 as usize;
+    let rodata_end = &__rodata_end as *const u8 as usize;
+    let image_end = &_end as *const u8 as usize;
+
+    let large = LARGE_PAGE_SIZE;
+    let mut va = code_start & !(large - 1);
+    while va < image_end {
+        let pml4e = pml4.add((va >> PML4_SHIFT) & (NO_OF_PT_ENTRIES - 1));
+        let pdpt = boot_pt_get_table(pml4e);
+        let pdpte = pdpt.add((va >> PDP_SHIFT) & (NO_OF_PT_ENTRIES - 1));
+
+        // The physmap may cover the image with a 1GB entry; split it into
+        // a PD of 2MB entries so permissions can vary within the image.
+        if *pdpte & X86_MMU_PG_PS != 0 {
+            let base = *pdpte & BOOT_PT_1GB_FRAME;
+            let flags = *pdpte & !BOOT_PT_1GB_FRAME & !X86_MMU_PG_PS;
+            let (pd_pa, pd) = boot_pt_alloc();
+            for i in 0..NO_OF_PT_ENTRIES {
+                *pd.add(i) = (base + (i * LARGE_PAGE_SIZE) as u64) | flags | X86_MMU_PG_PS;
+            }
+            *pdpte = pd_pa as u64 | X86_MMU_PG_P | X86_MMU_PG_W;
         }
 
-        // Return the physical address of PML4
-        pml4_addr
+        let pd = boot_pt_get_table(pdpte);
+        let pde = pd.add((va >> PD_SHIFT) & (NO_OF_PT_ENTRIES - 1));
+        let chunk_end = va + large;
+
+        let start_flags = kernel_image_flags(va.max(code_start), code_end, rodata_end);
+        let end_flags = kernel_image_flags((chunk_end - 1).min(image_end - 1),
+                                           code_end, rodata_end);
+
+        if start_flags == end_flags && va >= code_start && chunk_end <= image_end {
+            // Whole chunk inside one section: repermission the 2MB entry.
+            let base = *pde & BOOT_PT_2MB_FRAME;
+            *pde = base | start_flags | X86_MMU_PG_PS;
+        } else {
+            // Chunk straddles a section boundary (or the image edge):
+            // split to 4K and give each page its section's flags. Pages
+            // outside the image keep the physmap's RW/NX permissions.
+            let base = *pde & BOOT_PT_2MB_FRAME;
+            let (pt_pa, pt) = boot_pt_alloc();
+            for i in 0..NO_OF_PT_ENTRIES {
+                let page_va = va + i * PAGE_SIZE;
+                let flags = if page_va >= code_start && page_va < image_end {
+                    kernel_image_flags(page_va, code_end, rodata_end)
+                } else {
+                    X86_MMU_PG_P | X86_MMU_PG_W | X86_MMU_PG_G | X86_MMU_PG_NX
+                };
+                *pt.add(i) = (base + (i * PAGE_SIZE) as u64) | flags;
+            }
+            *pde = pt_pa as u64 | X86_MMU_PG_P | X86_MMU_PG_W;
+        }
+
+        va = chunk_end;
     }
 }
 
@@ -324,10 +488,21 @@ unsafe fn x86_validate_page_tables() {
     }
 }
 
+/// Whether the CPU supports 1GB (pdpe1gb) pages.
+static HUGE_1GB_PAGES: AtomicBool = AtomicBool::new(false);
+
 /// Detect huge page support
+///
+/// 2MB pages are architectural on x86-64; 1GB pages are advertised by
+/// CPUID.80000001H:EDX[26].
 unsafe fn x86_detect_huge_page_support() {
-    // TODO: Use CPUID to detect support for 1GB pages
-    // For now, assume 2MB pages are supported (standard on x86-64)
+    let result = feature::cpuid_query(0x8000_0001);
+    HUGE_1GB_PAGES.store(result.edx & (1 << 26) != 0, Ordering::Relaxed);
+}
+
+/// Returns true if the CPU supports 1GB pages.
+pub fn x86_huge_1gb_pages_supported() -> bool {
+    HUGE_1GB_PAGES.load(Ordering::Relaxed)
 }
 
 /// Invalidate a TLB entry
@@ -350,3 +525,178 @@ pub fn x86_kernel_cr3() -> PAddr {
         }
     }
 }
+
+/// ============================================================================
+/// PCID (Process-Context Identifier) Support
+/// ============================================================================
+///
+/// With CR4.PCIDE set, every CR3 load carries a 12-bit PCID that tags the
+/// TLB entries it creates, and a load with bit 63 (NOFLUSH) set preserves
+/// entries belonging to other PCIDs. Switching between address spaces then
+/// no longer wipes the whole TLB; stale entries for a specific space are
+/// removed with targeted INVPCID operations instead. This is the x86
+/// counterpart of the ASID management arm64 already does in its TTBR path.
+
+/// PCID value carried by an address space before one is allocated.
+/// Hardware treats PCID 0 as the "no PCID" context, so it doubles as the
+/// kernel/fallback value.
+pub const MMU_X86_UNUSED_PCID: u16 = 0;
+
+/// First PCID handed out to user address spaces.
+pub const MMU_X86_FIRST_USER_PCID: u16 = 1;
+
+/// Last usable PCID (the CR3 field is 12 bits wide).
+pub const MMU_X86_MAX_USER_PCID: u16 = 4095;
+
+/// PCID field in CR3.
+pub const X86_CR3_PCID_MASK: u64 = 0xfff;
+
+/// When set on a CR3 load with PCIDs enabled, TLB entries tagged with
+/// other PCIDs survive the load.
+pub const X86_CR3_NOFLUSH: u64 = 1 << 63;
+
+// INVPCID descriptor types
+const INVPCID_INDIVIDUAL_ADDRESS: u64 = 0;
+const INVPCID_SINGLE_CONTEXT: u64 = 1;
+
+/// Whether PCID use was enabled at boot.
+static PCID_ENABLED: AtomicBool = AtomicBool::new(false);
+
+/// Allocates PCIDs for user address spaces out of
+/// [MMU_X86_FIRST_USER_PCID, MMU_X86_MAX_USER_PCID], searching from the
+/// last allocated id and wrapping, like the arm64 ASID allocator.
+struct PcidAllocator {
+    last: u16,
+    bitmap: [u64; (MMU_X86_MAX_USER_PCID as usize + 1) / 64],
+}
+
+impl PcidAllocator {
+    const fn new() -> Self {
+        Self {
+            last: MMU_X86_FIRST_USER_PCID - 1,
+            bitmap: [0; (MMU_X86_MAX_USER_PCID as usize + 1) / 64],
+        }
+    }
+
+    fn alloc(&mut self) -> u16 {
+        let count = (MMU_X86_MAX_USER_PCID - MMU_X86_FIRST_USER_PCID + 1) as u32;
+        let mut candidate = self.last as u32 + 1;
+        for _ in 0..count {
+            if candidate > MMU_X86_MAX_USER_PCID as u32 {
+                candidate = MMU_X86_FIRST_USER_PCID as u32;
+            }
+            let word = (candidate / 64) as usize;
+            let bit = candidate % 64;
+            if self.bitmap[word] & (1u64 << bit) == 0 {
+                self.bitmap[word] |= 1u64 << bit;
+                self.last = candidate as u16;
+                return candidate as u16;
+            }
+            candidate += 1;
+        }
+        // Out of PCIDs; the caller falls back to flushing CR3 loads.
+        MMU_X86_UNUSED_PCID
+    }
+
+    fn free(&mut self, pcid: u16) {
+        let word = (pcid / 64) as usize;
+        let bit = pcid % 64;
+        debug_assert!(self.bitmap[word] & (1u64 << bit) != 0);
+        self.bitmap[word] &= !(1u64 << bit);
+    }
+}
+
+static PCID_ALLOCATOR: SpinMutex<PcidAllocator> = SpinMutex::new(PcidAllocator::new());
+
+/// Enable PCID-tagged TLB entries if the CPU supports them
+///
+/// Called once from x86_mmu_init(), before any user address space exists.
+pub fn x86_pcid_init() {
+    // CPUID.01H:ECX.PCID[17] and CPUID.07H:EBX.INVPCID[10]. Without
+    // INVPCID there is no way to shoot down a single context, so both
+    // are required.
+    if !feature::x86_feature_test(1, 0, 2, 17) || !feature::x86_feature_test(7, 0, 1, 10) {
+        return;
+    }
+
+    unsafe {
+        // CR4.PCIDE may only be set while CR3[11:0] is zero, which holds
+        // for the boot page tables.
+        x86_set_cr4(x86_get_cr4() | cr::CR4_PCIDE);
+    }
+    PCID_ENABLED.store(true, Ordering::Release);
+}
+
+/// Whether PCID use was enabled at boot
+pub fn x86_pcid_enabled() -> bool {
+    PCID_ENABLED.load(Ordering::Acquire)
+}
+
+/// Allocate a PCID for a user address space
+///
+/// Returns MMU_X86_UNUSED_PCID when PCIDs are disabled or exhausted;
+/// callers then fall back to flushing CR3 loads.
+pub fn x86_pcid_alloc() -> u16 {
+    if !x86_pcid_enabled() {
+        return MMU_X86_UNUSED_PCID;
+    }
+    PCID_ALLOCATOR.lock().alloc()
+}
+
+/// Free a PCID previously returned by x86_pcid_alloc()
+///
+/// Invalidates all TLB entries tagged with the PCID before it can be
+/// handed to another address space.
+pub fn x86_pcid_free(pcid: u16) {
+    if (pcid == MMU_X86_UNUSED_PCID) || !x86_pcid_enabled() {
+        return;
+    }
+    unsafe {
+        x86_invpcid(INVPCID_SINGLE_CONTEXT, pcid, 0);
+    }
+    PCID_ALLOCATOR.lock().free(pcid);
+}
+
+/// Execute INVPCID with the given descriptor type
+///
+/// # Safety
+///
+/// PCIDs must be enabled and the type/pcid/address combination must be
+/// valid per the instruction's rules.
+unsafe fn x86_invpcid(invtype: u64, pcid: u16, vaddr: VAddr) {
+    let descriptor: [u64; 2] = [pcid as u64, vaddr as u64];
+    core::arch::asm!(
+        "invpcid {}, [{}]",
+        in(reg) invtype,
+        in(reg) descriptor.as_ptr(),
+        options(nostack)
+    );
+}
+
+/// Invalidate a single TLB entry in a specific PCID context
+///
+/// Unlike invlpg, this reaches entries tagged for an address space that
+/// is not the current one.
+///
+/// # Safety
+///
+/// Caller must ensure the address is valid and page-aligned.
+pub unsafe fn x86_tlb_invalidate_page_pcid(pcid: u16, vaddr: VAddr) {
+    if pcid == MMU_X86_UNUSED_PCID || !x86_pcid_enabled() {
+        x86_tlb_invalidate_page(vaddr);
+        return;
+    }
+    x86_invpcid(INVPCID_INDIVIDUAL_ADDRESS, pcid, vaddr);
+}
+
+/// Compose the CR3 value for an address space
+///
+/// For a PCID-carrying space the load keeps every context's TLB entries:
+/// the switched-to space finds its own entries still warm from the last
+/// time it ran, and stale entries are removed by INVPCID on unmap.
+pub fn x86_pcid_cr3(pt_phys: PAddr, pcid: u16) -> u64 {
+    if pcid == MMU_X86_UNUSED_PCID {
+        return pt_phys;
+    }
+    (pt_phys & !X86_CR3_PCID_MASK) | pcid as u64 | X86_CR3_NOFLUSH
+}
@@ -8,6 +8,10 @@
 use core::sync::atomic::{AtomicUsize, Ordering};
 use core::ptr::{null_mut};
 use spin::mutex::{Mutex, MutexGuard}; // Using spin::mutex for #![no_std] compatibility
+use crate::kernel::{mp, percpu};
+use crate::kernel::vm::arch_vm_aspace as aspace_flags;
+use crate::kernel::arch::amd64::mmu::{read_cr3, write_cr3, x86_tlb_invalidate_page};
+use crate::kernel::arch::amd64::registers::{cr, x86_get_cr4, x86_set_cr4};
 use crate::rustux::types::{Status};
 use crate::rustux::types::status;
 
@@ -352,6 +356,109 @@ impl PendingTlbInvalidation {
     }
 }
 
+/// Apply a batch of pending TLB invalidations on the calling CPU
+///
+/// This is the shootdown IPI payload: one interrupt carries up to
+/// MAX_PENDING_INVALIDATIONS invlpg operations. Ranges that overflowed
+/// the batch collapse into a full flush, bouncing CR4.PGE when global
+/// entries are involved (a plain CR3 reload would keep them).
+///
+/// # Safety
+///
+/// `context` must point to a PendingTlbInvalidation that outlives every
+/// CPU's execution of this task.
+unsafe fn x86_tlb_apply(context: u64) {
+    let pending = &*(context as *const PendingTlbInvalidation);
+
+    if pending.full_shootdown {
+        if pending.contains_global {
+            let cr4 = x86_get_cr4();
+            x86_set_cr4(cr4 & !cr::CR4_PGE);
+            x86_set_cr4(cr4);
+        } else {
+            write_cr3(read_cr3());
+        }
+        return;
+    }
+
+    // invlpg reaches global entries too, so the batched path needs no
+    // special casing for them.
+    for ix in 0..pending.count {
+        x86_tlb_invalidate_page(pending.items[ix].addr());
+    }
+}
+
+/// PAT index for write-back cached memory
+const X86_PAT_INDEX_WB: u64 = 0;
+/// PAT index for write-combining memory
+const X86_PAT_INDEX_WC: u64 = 1;
+/// PAT index for uncached memory
+const X86_PAT_INDEX_UC: u64 = 3;
+
+/// PWT bit, the low bit of a PAT index
+const X86_MMU_PG_WT: u64 = 1 << 3;
+/// PCD bit, the middle bit of a PAT index
+const X86_MMU_PG_CD: u64 = 1 << 4;
+/// PAT bit (the high index bit) for 4K pages
+const X86_MMU_PG_PTE_PAT: u64 = 1 << 7;
+/// PAT bit (the high index bit) for 2M/1G pages
+const X86_MMU_PG_LARGE_PAT: u64 = 1 << 12;
+
+/// PAT index for an ARCH_MMU_FLAG_* cache policy
+///
+/// The indices line up with the table x86_pat_init() programs into
+/// IA32_PAT: 0 = WB, 1 = WC, 3 = UC. Device memory has no distinct
+/// type on x86 and maps to UC.
+fn pat_index_for(flags: u64) -> u64 {
+    match flags & aspace_flags::ARCH_MMU_FLAG_CACHE_MASK {
+        aspace_flags::ARCH_MMU_FLAG_WRITE_COMBINING => X86_PAT_INDEX_WC,
+        aspace_flags::ARCH_MMU_FLAG_UNCACHED
+        | aspace_flags::ARCH_MMU_FLAG_UNCACHED_DEVICE => X86_PAT_INDEX_UC,
+        _ => X86_PAT_INDEX_WB,
+    }
+}
+
+/// Page table bits encoding `pat_index` for a terminal entry at `level`
+///
+/// The low two index bits live in PWT/PCD at every level; the high bit
+/// is PTE bit 7 for 4K pages and bit 12 for large pages (bit 7 is the
+/// page-size bit there).
+fn x86_pat_selector(pat_index: u64, level: PageTableLevel) -> PtFlags {
+    let mut bits = 0u64;
+    if pat_index & 0x1 != 0 {
+        bits |= X86_MMU_PG_WT;
+    }
+    if pat_index & 0x2 != 0 {
+        bits |= X86_MMU_PG_CD;
+    }
+    if pat_index & 0x4 != 0 {
+        bits |= match level {
+            PageTableLevel::PT_L => X86_MMU_PG_PTE_PAT,
+            _ => X86_MMU_PG_LARGE_PAT,
+        };
+    }
+    bits
+}
+
+/// Decode the PAT index from a terminal entry at `level`
+fn x86_pat_index(flags: PtFlags, level: PageTableLevel) -> u64 {
+    let mut index = 0u64;
+    if flags & X86_MMU_PG_WT != 0 {
+        index |= 0x1;
+    }
+    if flags & X86_MMU_PG_CD != 0 {
+        index |= 0x2;
+    }
+    let high_bit = match level {
+        PageTableLevel::PT_L => X86_MMU_PG_PTE_PAT,
+        _ => X86_MMU_PG_LARGE_PAT,
+    };
+    if flags & high_bit != 0 {
+        index |= 0x4;
+    }
+    index
+}
+
 // Helper structures needed for implementation
 pub struct CacheLineFlusher;
 pub struct ConsistencyManager {
@@ -664,20 +771,28 @@ impl X86PageTableMmu {
         0b111  // P | RW | U
     }
 
-    pub fn terminal_flags(&self, _level: PageTableLevel, flags: u32) -> PtFlags {
-        // Convert input flags to x86-64 page table flags
-        // For now, set Present, Read/Write, User, and XD if not executable
+    pub fn terminal_flags(&self, level: PageTableLevel, flags: u32) -> PtFlags {
+        // Convert ARCH_MMU_FLAG_* mapping flags to x86-64 page table flags
         let present = 1u64 << 0;
         let rw = 1u64 << 1;
         let us = 1u64 << 2;
         let xd = 1u64 << 63;  // Execute disable
 
-        let mut pt_flags = present | rw | us | xd;
+        let mut pt_flags = present;
 
-        // If flags indicate executable, clear XD
-        if flags & 0x1 != 0 {  // Executable flag
-            pt_flags &= !xd;
+        if flags as u64 & aspace_flags::ARCH_MMU_FLAG_PERM_WRITE != 0 {
+            pt_flags |= rw;
+        }
+        if flags as u64 & aspace_flags::ARCH_MMU_FLAG_PERM_USER != 0 {
+            pt_flags |= us;
         }
+        if flags as u64 & aspace_flags::ARCH_MMU_FLAG_PERM_EXECUTE == 0 {
+            pt_flags |= xd;
+        }
+
+        // Cache policy selects a PAT index; x86_pat_init() programs the
+        // table so these indices resolve to WB/WC/UC.
+        pt_flags |= x86_pat_selector(pat_index_for(flags as u64), level);
 
         pt_flags
     }
@@ -688,31 +803,61 @@ impl X86PageTableMmu {
         flags & 0b111  // Keep P | RW | U
     }
 
-    pub fn tlb_invalidate(&self, _pending: &mut PendingTlbInvalidation) {
-        // Invalidate TLB entries
-        // For x86-64, we use INVLPG or do a full shootdown
+    pub fn tlb_invalidate(&self, pending: &mut PendingTlbInvalidation) {
+        if pending.count == 0 && !pending.full_shootdown {
+            return;
+        }
+
+        // Build the IPI target mask from per-CPU residency: only CPUs
+        // still running in this address space hold entries worth
+        // shooting down, so everyone who context-switched away since the
+        // mapping was touched skips the interrupt entirely.
+        let aspace = self.base.ctx() as u64;
+        let local = percpu::current_cpu_num();
+        let mut mask: mp::CpuMask = 0;
+        for cpu in 0..mp::mp_max_num_cpus() {
+            if cpu == local {
+                continue;
+            }
+            let p = unsafe { percpu::get_percpu(cpu as usize) };
+            if p.active_aspace.load(Ordering::Acquire) == aspace {
+                mask |= mp::cpu_num_to_mask(cpu);
+            }
+        }
+
+        // Flush the local CPU directly; a single pass covers up to
+        // MAX_PENDING_INVALIDATIONS batched invlpg operations.
         unsafe {
-            // For simplicity, do a full TLB shootdown
-            // INVLPG would be more targeted
-            core::arch::asm!(
-                "mov cr3, {0}",
-                "mov {0}, cr3",
-                in(reg) _pending as *const _ as usize,
-                options(nomem, nostack)
-            );
+            x86_tlb_apply(pending as *const _ as u64);
+        }
+
+        if mask != 0 {
+            mp::mp_sync_exec(mp::MpIpiTarget::Mask, mask, x86_tlb_apply,
+                             pending as *const _ as u64);
         }
     }
 
-    pub fn pt_flags_to_mmu_flags(&self, flags: PtFlags, _level: PageTableLevel) -> u32 {
-        // Convert page table flags back to MMU flags
-        let mut mmu_flags = 0u32;
+    pub fn pt_flags_to_mmu_flags(&self, flags: PtFlags, level: PageTableLevel) -> u32 {
+        // Convert page table flags back to ARCH_MMU_FLAG_* mapping flags
+        let mut mmu_flags = aspace_flags::ARCH_MMU_FLAG_PERM_READ;
 
-        if flags & (1 << 0) != 0 { mmu_flags |= 0x1; }  // Present
-        if flags & (1 << 1) != 0 { mmu_flags |= 0x2; }  // Read/Write
-        if flags & (1 << 2) != 0 { mmu_flags |= 0x4; }  // User
-        if flags & (1 << 63) != 0 { mmu_flags |= 0x8; } // Execute Disable
+        if flags & (1 << 1) != 0 {
+            mmu_flags |= aspace_flags::ARCH_MMU_FLAG_PERM_WRITE;
+        }
+        if flags & (1 << 2) != 0 {
+            mmu_flags |= aspace_flags::ARCH_MMU_FLAG_PERM_USER;
+        }
+        if flags & (1 << 63) == 0 {
+            mmu_flags |= aspace_flags::ARCH_MMU_FLAG_PERM_EXECUTE;
+        }
 
-        mmu_flags
+        mmu_flags |= match x86_pat_index(flags, level) {
+            X86_PAT_INDEX_WC => aspace_flags::ARCH_MMU_FLAG_WRITE_COMBINING,
+            X86_PAT_INDEX_UC => aspace_flags::ARCH_MMU_FLAG_UNCACHED,
+            _ => aspace_flags::ARCH_MMU_FLAG_CACHED,
+        };
+
+        mmu_flags as u32
     }
 
     /// Split a large page into smaller pages
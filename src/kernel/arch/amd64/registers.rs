@@ -7,9 +7,14 @@
 //! x86-64 Register Definitions
 //!
 //! This module provides MSR (Model Specific Register) and other
-//! register definitions for x86-64 processors.
+//! register definitions for x86-64 processors, along with management of
+//! the extended (FPU/SSE/AVX) register state.
 
 
+use core::sync::atomic::{AtomicU64, Ordering};
+
+use crate::kernel::thread::Thread;
+
 /// MSR (Model Specific Register) indices
 pub mod msr {
     /// IA32_GS_BASE - GS Segment Base Address
@@ -31,6 +36,9 @@ pub mod msr {
 /// Control register definitions
 pub mod cr {
     /// CR0 - Control Register 0
+    pub const CR0_MP: u64 = 1 << 1;   // Monitor Coprocessor
+    pub const CR0_EM: u64 = 1 << 2;   // Emulation
+    pub const CR0_TS: u64 = 1 << 3;   // Task Switched
     pub const CR0_PG: u64 = 1 << 31;  // Paging
     pub const CR0_CD: u64 = 1 << 30;  // Cache Disable
     pub const CR0_NW: u64 = 1 << 29;  // Not Write-through
@@ -359,3 +367,130 @@ pub unsafe fn x86_set_cr4(val: u64) {
     );
 }
 
+/// ============================================================================
+/// Extended Register (FPU/SSE/AVX) State Functions
+/// ============================================================================
+///
+/// Extended register state is managed lazily using CR0.TS: the context
+/// switch sets TS instead of restoring the incoming thread's state, and
+/// the first FPU/SSE instruction the thread executes raises #NM, whose
+/// handler clears TS and performs the restore. The outgoing thread's
+/// state is only saved if it actually took the #NM trap since it was
+/// switched in (TS clear at switch time); kernel-bound worker threads
+/// that never touch the FPU pay nothing on either edge.
+
+/// Number of context switches that had to save the outgoing thread's
+/// extended register state (the thread used the FPU while running).
+///
+/// Together with [`EXTENDED_REGISTER_LAZY_SKIPS`] this is the arch-layer
+/// analog of a kcounter pair; the ratio shows how often laziness pays.
+static EXTENDED_REGISTER_EAGER_SAVES: AtomicU64 = AtomicU64::new(0);
+
+/// Number of context switches that skipped the save because the outgoing
+/// thread never touched the FPU since it was switched in.
+static EXTENDED_REGISTER_LAZY_SKIPS: AtomicU64 = AtomicU64::new(0);
+
+/// Report (eager saves, lazy skips) accumulated across all context
+/// switches since boot.
+pub fn x86_extended_register_stats() -> (u64, u64) {
+    (
+        EXTENDED_REGISTER_EAGER_SAVES.load(Ordering::Relaxed),
+        EXTENDED_REGISTER_LAZY_SKIPS.load(Ordering::Relaxed),
+    )
+}
+
+/// Save the extended register state to a 512-byte FXSAVE area
+///
+/// # Safety
+///
+/// `area` must point to a 16-byte aligned buffer of at least
+/// [`X86_MAX_EXTENDED_REGISTER_SIZE`] bytes.
+#[inline]
+unsafe fn x86_fxsave(area: *mut core::ffi::c_void) {
+    core::arch::asm!(
+        "fxsave64 [{}]",
+        in(reg) area,
+        options(nostack)
+    );
+}
+
+/// Restore the extended register state from a 512-byte FXSAVE area
+///
+/// # Safety
+///
+/// `area` must point to a 16-byte aligned buffer of at least
+/// [`X86_MAX_EXTENDED_REGISTER_SIZE`] bytes holding a valid FXSAVE image.
+#[inline]
+unsafe fn x86_fxrstor(area: *const core::ffi::c_void) {
+    core::arch::asm!(
+        "fxrstor64 [{}]",
+        in(reg) area,
+        options(nostack)
+    );
+}
+
+/// Clear CR0.TS (CLTS)
+///
+/// # Safety
+///
+/// This function uses inline assembly to clear the Task Switched flag.
+#[inline]
+unsafe fn x86_clts() {
+    core::arch::asm!("clts", options(nomem, nostack));
+}
+
+/// Handle the extended register state on a context switch
+///
+/// If the outgoing thread used the FPU since it was switched in (CR0.TS
+/// is clear), its state is saved into its FXSAVE area; otherwise the
+/// save is skipped entirely. Either way TS is set so the incoming
+/// thread's first FPU/SSE instruction traps to
+/// [`x86_extended_register_nm_handler`], which performs the restore.
+///
+/// # Safety
+///
+/// `old_thread` must be valid and this must only be called from the
+/// context switch path with interrupts disabled.
+pub unsafe fn x86_extended_register_context_switch(old_thread: *mut Thread,
+                                                   _new_thread: *mut Thread) {
+    let cr0 = x86_get_cr0();
+    if cr0 & cr::CR0_TS == 0 {
+        // The outgoing thread took the #NM trap while running, so the
+        // live register contents belong to it and must be preserved.
+        let state = (*old_thread).arch.extended_register_state;
+        if !state.is_null() {
+            x86_fxsave(state);
+        }
+        EXTENDED_REGISTER_EAGER_SAVES.fetch_add(1, Ordering::Relaxed);
+        x86_set_cr0(cr0 | cr::CR0_TS);
+    } else {
+        // TS was never cleared: the thread ran without touching the
+        // FPU, and the save (and the incoming restore) cost nothing.
+        EXTENDED_REGISTER_LAZY_SKIPS.fetch_add(1, Ordering::Relaxed);
+    }
+}
+
+/// Handle a #NM (device not available) fault
+///
+/// Raised on the first FPU/SSE instruction a thread executes after being
+/// switched in. Clears TS and restores the current thread's extended
+/// register state, or resets the unit to its init state for a thread
+/// that has no saved state yet.
+///
+/// # Safety
+///
+/// Must only be called from the #NM exception handler.
+pub unsafe fn x86_extended_register_nm_handler() {
+    x86_clts();
+
+    match crate::kernel::thread::get_current_thread() {
+        Some(thread) if !thread.arch.extended_register_state.is_null() => {
+            x86_fxrstor(thread.arch.extended_register_state);
+        }
+        _ => {
+            // First use: hand the thread a freshly initialized unit.
+            core::arch::asm!("fninit", options(nomem, nostack));
+        }
+    }
+}
+
@@ -13,6 +13,7 @@
 use crate::kernel::arch::amd64;
 use crate::kernel::arch::amd64::apic;
 use crate::kernel::arch::amd64::apic::apic_send_ipi;
+use crate::kernel::arch::amd64::include::arch::amd64::apic as apic_hw;
 use crate::kernel::arch::amd64::bootstrap16;
 use crate::kernel::arch::amd64::mp;
 use crate::kernel::debug;
@@ -115,13 +116,28 @@ pub fn x86_bringup_aps(apic_ids: &[u32], count: u32) -> i32 {
     // Memory fence to ensure all writes are visible to APs
     core::sync::atomic::fence(Ordering::SeqCst);
 
+    // When every CPU in the system other than the booting one is coming
+    // up at once -- the whole-machine boot case -- a single broadcast
+    // INIT and broadcast SIPI replace one ICR round trip per AP. The
+    // trampoline's atomic cpu_id_counter already lets the APs claim
+    // their stacks and rendezvous concurrently. Hotplug of a subset
+    // still uses per-CPU unicast.
+    let broadcast = count + 1 >= crate::kernel::mp::mp_num_cpus();
+
     print!("booting apic ids: ");
     for i in 0..count as usize {
         print!("{:#x} ", apic_ids[i]);
-        unsafe { apic_send_ipi(0, apic_ids[i], DELIVERY_MODE_INIT) };
     }
     println!("");
 
+    if broadcast {
+        apic_hw::apic_send_broadcast_ipi(0, apic_hw::ApicInterruptDeliveryMode::Init);
+    } else {
+        for i in 0..count as usize {
+            unsafe { apic_send_ipi(0, apic_ids[i], DELIVERY_MODE_INIT) };
+        }
+    }
+
     // Wait 10 ms and then send the startup signals
     unsafe { thread_sleep_relative(10) };
 
@@ -132,11 +148,16 @@ pub fn x86_bringup_aps(apic_ids: &[u32], count: u32) -> i32 {
 
     // Try up to two times per CPU, as Intel recommends
     for _try in 0..2 {
-        for i in 0..count as usize {
-            let apic_id = apic_ids[i];
-
-            // This will cause the APs to begin executing at bootstrap_instr_ptr
-            unsafe { apic_send_ipi(vec as u32, apic_id, DELIVERY_MODE_STARTUP) };
+        if broadcast {
+            // One SIPI starts every waiting AP at bootstrap_instr_ptr
+            apic_hw::apic_send_broadcast_ipi(vec, apic_hw::ApicInterruptDeliveryMode::Startup);
+        } else {
+            for i in 0..count as usize {
+                let apic_id = apic_ids[i];
+
+                // This will cause the APs to begin executing at bootstrap_instr_ptr
+                unsafe { apic_send_ipi(vec as u32, apic_id, DELIVERY_MODE_STARTUP) };
+            }
         }
 
         if aps_still_booting.load(Ordering::SeqCst) == 0 {
@@ -127,7 +127,9 @@ pub fn x86_tsc_to_ns(ticks: u64) -> u64 {
     if freq == 0 {
         return 0;
     }
-    (ticks * 1_000_000_000) / freq
+    // Widen the intermediate product: raw tick counts are large enough to
+    // overflow u64 when scaled to nanoseconds.
+    ((ticks as u128 * 1_000_000_000) / freq as u128) as u64
 }
 
 /// Convert nanoseconds to TSC ticks
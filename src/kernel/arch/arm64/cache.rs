@@ -0,0 +1,159 @@
+// Copyright 2025 The Rustux Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+//! ARM64 batched cache maintenance
+//!
+//! `arch_sync_cache_range` (cache-ops.S) issues a full barrier set per
+//! call, which is the right thing for a single range. Callers that flip
+//! many pages at a time - the JIT W->X protect path flips hundreds per
+//! second - can instead accumulate ranges in a `CacheSyncBatch`: the
+//! data-cache clean runs by VA as ranges are added, and the
+//! instruction-cache invalidate plus the barriers are issued once for
+//! the whole batch. Line sizes come from CTR_EL0 (read at boot into
+//! `arm64_dcache_size`/`arm64_icache_size`).
+
+use core::sync::atomic::{AtomicU64, Ordering};
+
+use crate::arch::arm64::include::arch::arch_ops::{
+    arch_cycle_count, arch_dcache_line_size, arch_icache_line_size,
+};
+use crate::rustux::types::*;
+
+/// Ranges a batch can hold before it has to cycle its barriers early
+const CACHE_SYNC_BATCH_RANGES: usize = 16;
+
+/// Completed batches (one barrier set each)
+static CACHE_SYNC_BATCHES: AtomicU64 = AtomicU64::new(0);
+
+/// Cache lines touched by batched maintenance
+static CACHE_SYNC_LINES: AtomicU64 = AtomicU64::new(0);
+
+/// Cycles spent in batched maintenance (PMCCNTR_EL0)
+static CACHE_SYNC_CYCLES: AtomicU64 = AtomicU64::new(0);
+
+/// Clean the data cache to PoU by VA over a range, with no barrier
+///
+/// Returns the number of lines cleaned.
+fn dcache_clean_pou_range(addr: VAddr, len: usize) -> u64 {
+    let line = arch_dcache_line_size() as usize;
+    let end = addr + len;
+    let mut va = addr & !(line - 1);
+    let mut lines = 0u64;
+    while va < end {
+        unsafe {
+            core::arch::asm!("dc cvau, {}", in(reg) va);
+        }
+        va += line;
+        lines += 1;
+    }
+    lines
+}
+
+/// Invalidate the instruction cache by VA over a range, with no barrier
+///
+/// Returns the number of lines invalidated.
+fn icache_invalidate_range(addr: VAddr, len: usize) -> u64 {
+    let line = arch_icache_line_size() as usize;
+    let end = addr + len;
+    let mut va = addr & !(line - 1);
+    let mut lines = 0u64;
+    while va < end {
+        unsafe {
+            core::arch::asm!("ic ivau, {}", in(reg) va);
+        }
+        va += line;
+        lines += 1;
+    }
+    lines
+}
+
+/// Accumulates ranges that need dcache-clean/icache-invalidate and
+/// amortizes the barriers over the whole set
+///
+/// The data cache is cleaned as each range is added; the instruction
+/// cache invalidate needs the cleans to be complete, so those loops and
+/// the barriers around them wait for `flush`. Dropping a batch flushes
+/// it.
+pub struct CacheSyncBatch {
+    ranges: [(VAddr, usize); CACHE_SYNC_BATCH_RANGES],
+    count: usize,
+}
+
+impl CacheSyncBatch {
+    pub const fn new() -> Self {
+        Self {
+            ranges: [(0, 0); CACHE_SYNC_BATCH_RANGES],
+            count: 0,
+        }
+    }
+
+    /// Add a range to the batch and clean its data cache lines
+    pub fn sync_range(&mut self, addr: VAddr, len: usize) {
+        if len == 0 {
+            return;
+        }
+        if self.count == self.ranges.len() {
+            // Out of slots: complete the pending set so its barriers
+            // are issued before accumulating again.
+            self.flush();
+        }
+
+        let start = arch_cycle_count();
+        let lines = dcache_clean_pou_range(addr, len);
+        CACHE_SYNC_LINES.fetch_add(lines, Ordering::Relaxed);
+        CACHE_SYNC_CYCLES.fetch_add(arch_cycle_count().wrapping_sub(start), Ordering::Relaxed);
+
+        self.ranges[self.count] = (addr, len);
+        self.count += 1;
+    }
+
+    /// Invalidate the instruction cache for every accumulated range and
+    /// issue the batch's one barrier set
+    pub fn flush(&mut self) {
+        if self.count == 0 {
+            return;
+        }
+
+        let start = arch_cycle_count();
+
+        // Order the cleans done in sync_range against the invalidates
+        // below; one barrier covers every range in the batch.
+        unsafe {
+            core::arch::asm!("dsb ish");
+        }
+
+        let mut lines = 0u64;
+        for &(addr, len) in &self.ranges[..self.count] {
+            lines += icache_invalidate_range(addr, len);
+        }
+
+        unsafe {
+            core::arch::asm!("dsb ish");
+            core::arch::asm!("isb");
+        }
+
+        CACHE_SYNC_LINES.fetch_add(lines, Ordering::Relaxed);
+        CACHE_SYNC_CYCLES.fetch_add(arch_cycle_count().wrapping_sub(start), Ordering::Relaxed);
+        CACHE_SYNC_BATCHES.fetch_add(1, Ordering::Relaxed);
+
+        self.count = 0;
+    }
+}
+
+impl Drop for CacheSyncBatch {
+    fn drop(&mut self) {
+        self.flush();
+    }
+}
+
+/// Batched-maintenance counters: (batches, lines, cycles)
+pub fn cache_sync_stats() -> (u64, u64, u64) {
+    (
+        CACHE_SYNC_BATCHES.load(Ordering::Relaxed),
+        CACHE_SYNC_LINES.load(Ordering::Relaxed),
+        CACHE_SYNC_CYCLES.load(Ordering::Relaxed),
+    )
+}
@@ -1483,6 +1483,15 @@ impl ArmArchVmAspace {
                                    attrs, vaddr_base,
                                    top_size_shift, top_index_shift, page_size_shift);
 
+        // Becoming executable (the JIT W->X flip): make the icache
+        // coherent for the whole range as one batch, with a single
+        // barrier set, instead of a full sync per page.
+        if ret == 0 && (mmu_flags & ARCH_MMU_FLAG_PERM_EXECUTE) != 0 {
+            let mut batch = crate::arch::arm64::cache::CacheSyncBatch::new();
+            batch.sync_range(vaddr as usize, (count * (PAGE_SIZE as size_t)) as usize);
+            batch.flush();
+        }
+
         ret
     }
 
@@ -14,6 +14,7 @@
 pub mod aal;
 pub mod arch;
 pub mod aspace;
+pub mod cache;
 pub mod debugger;
 pub mod el2_state;
 pub mod exceptions;
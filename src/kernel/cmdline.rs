@@ -32,6 +32,8 @@
 //! ```
 
 
+use core::sync::atomic::{AtomicBool, AtomicU32, AtomicU64, Ordering};
+
 use crate::kernel::sync::spin::SpinMutex as Mutex;
 
 /// ============================================================================
@@ -101,18 +103,20 @@ pub fn cmdline_append(data: &str) {
 
     let mut found_equal = false;
     let mut i = size;
+    let mut j = 0;
 
     while i < max {
-        let c = if i < data_bytes.len() {
-            data_bytes[i]
+        let c = if j < data_bytes.len() {
+            data_bytes[j]
         } else {
             0
         };
+        j += 1;
 
         if c == 0 {
             // Finish in-progress argument
             unsafe {
-                if CMDLINE_DATA[i - 1] != 0 {
+                if i > 0 && CMDLINE_DATA[i - 1] != 0 {
                     if !found_equal {
                         CMDLINE_DATA[i] = b'=';
                         i += 1;
@@ -198,6 +202,12 @@ pub fn cmdline_get(key: &str) -> Option<&'static str> {
         }
     }
 
+    // Once the registry is frozen, lookups are a single hash probe
+    // instead of a scan over the whole command line.
+    if REGISTRY_BUILT.load(Ordering::Acquire) {
+        return registry_lookup(cmdline_hash(key), key);
+    }
+
     let key_bytes = key.as_bytes();
 
     unsafe {
@@ -221,8 +231,12 @@ pub fn cmdline_get(key: &str) -> Option<&'static str> {
                 let value_start = ptr + key_bytes.len();
                 if CMDLINE_DATA[value_start] == b'=' {
                     let value_ptr = value_start + 1;
+                    let mut value_end = value_ptr;
+                    while value_end < CMDLINE_MAX && CMDLINE_DATA[value_end] != 0 {
+                        value_end += 1;
+                    }
                     return Some(core::str::from_utf8_unchecked(
-                        &CMDLINE_DATA[value_ptr..],
+                        &CMDLINE_DATA[value_ptr..value_end],
                     ));
                 } else {
                     return Some("");
@@ -380,10 +394,320 @@ pub fn cmdline_count() -> usize {
     *CMDLINE_COUNT.lock()
 }
 
+/// ============================================================================
+/// Hashed Registry
+/// ============================================================================
+
+/// Registry hash table slots (power of two, well above any realistic
+/// entry count for a 4K command line)
+const REGISTRY_SLOTS: usize = 128;
+
+/// One parsed key=value entry in the registry
+#[derive(Debug, Clone, Copy)]
+struct RegistrySlot {
+    /// FNV-1a hash of the key (0 in unused slots)
+    key_hash: u64,
+    /// Key offset into CMDLINE_DATA
+    key_off: u32,
+    /// Key length in bytes
+    key_len: u16,
+    /// Value offset into CMDLINE_DATA
+    value_off: u32,
+    /// Value length in bytes
+    value_len: u16,
+    /// Whether this slot holds an entry
+    used: bool,
+}
+
+impl RegistrySlot {
+    /// An unused slot
+    const fn empty() -> Self {
+        Self {
+            key_hash: 0,
+            key_off: 0,
+            key_len: 0,
+            value_off: 0,
+            value_len: 0,
+            used: false,
+        }
+    }
+}
+
+/// Parsed registry, built once at freeze and read-only afterwards
+static mut REGISTRY: [RegistrySlot; REGISTRY_SLOTS] = [RegistrySlot::empty(); REGISTRY_SLOTS];
+
+/// Whether the registry has been built (publishes REGISTRY)
+static REGISTRY_BUILT: AtomicBool = AtomicBool::new(false);
+
+/// Reload generation counter
+///
+/// Bumped by [`cmdline_reload`]; subsystems holding derived state can
+/// compare against it instead of re-reading strings.
+static RELOAD_GENERATION: AtomicU64 = AtomicU64::new(0);
+
+/// FNV-1a hash of a key
+///
+/// Const so typed descriptors get their hash at compile time.
+pub const fn cmdline_hash(key: &str) -> u64 {
+    let bytes = key.as_bytes();
+    let mut hash: u64 = 0xcbf2_9ce4_8422_2325;
+    let mut i = 0;
+    while i < bytes.len() {
+        hash ^= bytes[i] as u64;
+        hash = hash.wrapping_mul(0x0000_0100_0000_01b3);
+        i += 1;
+    }
+    hash
+}
+
+/// Look up a key in the frozen registry (internal)
+fn registry_lookup(hash: u64, key: &str) -> Option<&'static str> {
+    let key_bytes = key.as_bytes();
+    let mut ix = hash as usize & (REGISTRY_SLOTS - 1);
+
+    unsafe {
+        for _ in 0..REGISTRY_SLOTS {
+            let slot = &REGISTRY[ix];
+            if !slot.used {
+                return None;
+            }
+            if slot.key_hash == hash
+                && slot.key_len as usize == key_bytes.len()
+                && &CMDLINE_DATA[slot.key_off as usize..slot.key_off as usize + slot.key_len as usize]
+                    == key_bytes
+            {
+                let value = &CMDLINE_DATA
+                    [slot.value_off as usize..slot.value_off as usize + slot.value_len as usize];
+                return Some(core::str::from_utf8_unchecked(value));
+            }
+            ix = (ix + 1) & (REGISTRY_SLOTS - 1);
+        }
+    }
+
+    None
+}
+
+/// Insert one parsed entry, linear probing from its hash slot (internal)
+///
+/// Later entries for the same key win, matching the scan order the
+/// linear lookup used.
+unsafe fn registry_insert(slot: RegistrySlot) {
+    let mut ix = slot.key_hash as usize & (REGISTRY_SLOTS - 1);
+
+    for _ in 0..REGISTRY_SLOTS {
+        let existing = &mut REGISTRY[ix];
+        let same_key = existing.used
+            && existing.key_hash == slot.key_hash
+            && existing.key_len == slot.key_len
+            && CMDLINE_DATA
+                [existing.key_off as usize..existing.key_off as usize + existing.key_len as usize]
+                == CMDLINE_DATA[slot.key_off as usize..slot.key_off as usize + slot.key_len as usize];
+        if !existing.used || same_key {
+            *existing = slot;
+            return;
+        }
+        ix = (ix + 1) & (REGISTRY_SLOTS - 1);
+    }
+    // Table full; the entry stays reachable via nothing. 128 slots for
+    // a 4K command line makes this unreachable in practice.
+}
+
+/// Parse CMDLINE_DATA into the registry (internal)
+unsafe fn registry_build() {
+    for slot in REGISTRY.iter_mut() {
+        *slot = RegistrySlot::empty();
+    }
+
+    let size = *CMDLINE_SIZE.lock();
+    let mut ptr = 0;
+
+    while ptr < size && CMDLINE_DATA[ptr] != 0 {
+        let entry_start = ptr;
+        while ptr < size && CMDLINE_DATA[ptr] != 0 {
+            ptr += 1;
+        }
+        let entry_end = ptr;
+        ptr += 1; // Skip the null separator.
+
+        // cmdline_append guarantees every entry has an '='.
+        let mut eq = entry_start;
+        while eq < entry_end && CMDLINE_DATA[eq] != b'=' {
+            eq += 1;
+        }
+        if eq == entry_start || eq == entry_end {
+            continue;
+        }
+
+        registry_insert(RegistrySlot {
+            key_hash: cmdline_hash(core::str::from_utf8_unchecked(
+                &CMDLINE_DATA[entry_start..eq],
+            )),
+            key_off: entry_start as u32,
+            key_len: (eq - entry_start) as u16,
+            value_off: (eq + 1) as u32,
+            value_len: (entry_end - eq - 1) as u16,
+            used: true,
+        });
+    }
+}
+
+/// ============================================================================
+/// Typed Descriptors and Freeze
+/// ============================================================================
+
+/// Typed uint32 command line value
+///
+/// Declared as a static with a const key descriptor; the key hash is
+/// computed at compile time. After [`cmdline_freeze`] the value lives
+/// in a plain atomic, so hot paths read a word instead of rescanning
+/// strings.
+pub struct CmdlineUint32 {
+    /// Command line key
+    key: &'static str,
+    /// Default when the key is absent or unparsable
+    default: u32,
+    /// Frozen value snapshot
+    value: AtomicU32,
+}
+
+impl CmdlineUint32 {
+    /// Create a new descriptor
+    pub const fn new(key: &'static str, default: u32) -> Self {
+        Self {
+            key,
+            default,
+            value: AtomicU32::new(default),
+        }
+    }
+
+    /// Read the frozen value
+    pub fn get(&self) -> u32 {
+        self.value.load(Ordering::Relaxed)
+    }
+
+    /// Re-snapshot from the command line
+    fn reload(&self) {
+        self.value
+            .store(cmdline_get_uint32(self.key, self.default), Ordering::Relaxed);
+    }
+}
+
+/// Typed uint64 command line value
+pub struct CmdlineUint64 {
+    /// Command line key
+    key: &'static str,
+    /// Default when the key is absent or unparsable
+    default: u64,
+    /// Frozen value snapshot
+    value: AtomicU64,
+}
+
+impl CmdlineUint64 {
+    /// Create a new descriptor
+    pub const fn new(key: &'static str, default: u64) -> Self {
+        Self {
+            key,
+            default,
+            value: AtomicU64::new(default),
+        }
+    }
+
+    /// Read the frozen value
+    pub fn get(&self) -> u64 {
+        self.value.load(Ordering::Relaxed)
+    }
+
+    /// Re-snapshot from the command line
+    fn reload(&self) {
+        self.value
+            .store(cmdline_get_uint64(self.key, self.default), Ordering::Relaxed);
+    }
+}
+
+/// Typed boolean command line value
+pub struct CmdlineBool {
+    /// Command line key
+    key: &'static str,
+    /// Default when the key is absent
+    default: bool,
+    /// Frozen value snapshot
+    value: AtomicBool,
+}
+
+impl CmdlineBool {
+    /// Create a new descriptor
+    pub const fn new(key: &'static str, default: bool) -> Self {
+        Self {
+            key,
+            default,
+            value: AtomicBool::new(default),
+        }
+    }
+
+    /// Read the frozen value
+    pub fn get(&self) -> bool {
+        self.value.load(Ordering::Relaxed)
+    }
+
+    /// Re-snapshot from the command line
+    fn reload(&self) {
+        self.value
+            .store(cmdline_get_bool(self.key, self.default), Ordering::Relaxed);
+    }
+}
+
+/// Hot values snapshotted at freeze
+///
+/// Paths that read a knob repeatedly go through these instead of
+/// cmdline_get; anything read once at init can keep using the string
+/// API.
+pub static CMDLINE_SMP_MAX_CPUS: CmdlineUint32 = CmdlineUint32::new("kernel.smp.maxcpus", 0);
+pub static CMDLINE_MEMORY_LIMIT_MB: CmdlineUint64 =
+    CmdlineUint64::new("kernel.memory-limit-mb", 0);
+pub static CMDLINE_TIMER_SLACK_NS: CmdlineUint64 =
+    CmdlineUint64::new("kernel.timer.slack.ns", 0);
+
+/// Snapshot every hot descriptor (internal)
+fn reload_hot_values() {
+    CMDLINE_SMP_MAX_CPUS.reload();
+    CMDLINE_MEMORY_LIMIT_MB.reload();
+    CMDLINE_TIMER_SLACK_NS.reload();
+}
+
+/// Freeze the command line
+///
+/// Call once at boot after the last cmdline_append: parses the raw
+/// string into the hashed registry (making every cmdline_get an O(1)
+/// probe) and snapshots the hot typed values into their globals.
+pub fn cmdline_freeze() {
+    unsafe {
+        registry_build();
+    }
+    REGISTRY_BUILT.store(true, Ordering::Release);
+    reload_hot_values();
+}
+
+/// Reload event
+///
+/// Rebuilds the registry and re-snapshots the typed values after a
+/// late cmdline_append, and bumps the reload generation so subsystems
+/// with derived state know to refresh. This is the supported way to
+/// pick up changes; hot paths never rescan strings themselves.
+pub fn cmdline_reload() {
+    cmdline_freeze();
+    RELOAD_GENERATION.fetch_add(1, Ordering::Release);
+}
+
+/// Get the current reload generation
+pub fn cmdline_reload_generation() -> u64 {
+    RELOAD_GENERATION.load(Ordering::Acquire)
+}
+
 /// Initialize the cmdline subsystem
 pub fn init() {
     // Cmdline is initialized through cmdline_append() calls
-    // from early boot parameters
+    // from early boot parameters; platform code calls cmdline_freeze()
+    // once the last source (ZBI items, bootloader args) is appended.
 }
 
 // ============================================================================
@@ -394,60 +718,122 @@ pub fn init() {
 mod tests {
     use super::*;
 
+    /// The command line storage is global, so tests that touch it must be
+    /// serialized and start from a clean buffer.
+    static TEST_LOCK: Mutex<()> = Mutex::new(());
+
+    fn with_clean_cmdline(f: impl FnOnce()) {
+        let _guard = TEST_LOCK.lock();
+        unsafe {
+            CMDLINE_DATA = [0; CMDLINE_MAX];
+        }
+        *CMDLINE_SIZE.lock() = 0;
+        *CMDLINE_COUNT.lock() = 0;
+        REGISTRY_BUILT.store(false, Ordering::Release);
+        f();
+    }
+
     #[test]
     fn test_cmdline_empty() {
-        assert!(cmdline_get("test").is_none());
-        assert_eq!(cmdline_count(), 0);
+        with_clean_cmdline(|| {
+            assert!(cmdline_get("test").is_none());
+            assert_eq!(cmdline_count(), 0);
+        });
     }
 
     #[test]
     fn test_cmdline_append_simple() {
-        cmdline_append("test=value");
-        assert_eq!(cmdline_get("test"), Some("value"));
+        with_clean_cmdline(|| {
+            cmdline_append("test=value");
+            assert_eq!(cmdline_get("test"), Some("value"));
+        });
     }
 
     #[test]
     fn test_cmdline_get_bool() {
-        cmdline_append("flag1=true");
-        cmdline_append("flag2=false");
-        cmdline_append("flag3=1");
-
-        assert!(cmdline_get_bool("flag1", false));
-        assert!(!cmdline_get_bool("flag2", true));
-        assert!(cmdline_get_bool("flag3", false));
-
-        // Test default for missing key
-        assert!(cmdline_get_bool("missing", true));
+        with_clean_cmdline(|| {
+            cmdline_append("flag1=true");
+            cmdline_append("flag2=false");
+            cmdline_append("flag3=1");
+
+            assert!(cmdline_get_bool("flag1", false));
+            assert!(!cmdline_get_bool("flag2", true));
+            assert!(cmdline_get_bool("flag3", false));
+
+            // Test default for missing key
+            assert!(cmdline_get_bool("missing", true));
+        });
     }
 
     #[test]
     fn test_cmdline_get_uint32() {
-        cmdline_append("num1=123");
-        cmdline_append("num2=0x1ff");
-        cmdline_append("num3=0XABC");
-
-        assert_eq!(cmdline_get_uint32("num1", 0), 123);
-        assert_eq!(cmdline_get_uint32("num2", 0), 0x1ff);
-        assert_eq!(cmdline_get_uint32("num3", 0), 0xABC);
-
-        // Test default for missing key
-        assert_eq!(cmdline_get_uint32("missing", 42), 42);
+        with_clean_cmdline(|| {
+            cmdline_append("num1=123");
+            cmdline_append("num2=0x1ff");
+            cmdline_append("num3=0XABC");
+
+            assert_eq!(cmdline_get_uint32("num1", 0), 123);
+            assert_eq!(cmdline_get_uint32("num2", 0), 0x1ff);
+            assert_eq!(cmdline_get_uint32("num3", 0), 0xABC);
+
+            // Test default for missing key
+            assert_eq!(cmdline_get_uint32("missing", 42), 42);
+        });
     }
 
     #[test]
     fn test_cmdline_get_uint64() {
-        cmdline_append("num1=123456789");
-        cmdline_append("num2=0x1ffffffff");
+        with_clean_cmdline(|| {
+            cmdline_append("num1=123456789");
+            cmdline_append("num2=0x1ffffffff");
 
-        assert_eq!(cmdline_get_uint64("num1", 0), 123456789);
-        assert_eq!(cmdline_get_uint64("num2", 0), 0x1ffffffff);
+            assert_eq!(cmdline_get_uint64("num1", 0), 123456789);
+            assert_eq!(cmdline_get_uint64("num2", 0), 0x1ffffffff);
+        });
     }
 
     #[test]
     fn test_cmdline_spaces() {
-        cmdline_append("key1=value1 key2=value2");
+        with_clean_cmdline(|| {
+            cmdline_append("key1=value1 key2=value2");
 
-        assert_eq!(cmdline_get("key1"), Some("value1"));
-        assert_eq!(cmdline_get("key2"), Some("value2"));
+            assert_eq!(cmdline_get("key1"), Some("value1"));
+            assert_eq!(cmdline_get("key2"), Some("value2"));
+        });
+    }
+
+    #[test]
+    fn test_cmdline_hash_is_const() {
+        // The descriptor path relies on compile-time hashing.
+        const HASH: u64 = cmdline_hash("kernel.smp.maxcpus");
+        assert_eq!(HASH, cmdline_hash("kernel.smp.maxcpus"));
+        assert_ne!(HASH, cmdline_hash("kernel.smp.maxcpu"));
+    }
+
+    #[test]
+    fn test_cmdline_freeze_registry() {
+        with_clean_cmdline(|| {
+        cmdline_append("frozen1=abc");
+        cmdline_append("kernel.smp.maxcpus=8");
+        cmdline_freeze();
+
+        // Registry lookups see the same entries the scan did.
+        assert_eq!(cmdline_get("frozen1"), Some("abc"));
+        assert_eq!(cmdline_get("no.such.key"), None);
+
+        // Hot descriptors were snapshotted at freeze.
+        assert_eq!(CMDLINE_SMP_MAX_CPUS.get(), 8);
+
+        // A late append needs the reload event to become visible.
+        let generation = cmdline_reload_generation();
+        cmdline_append("frozen2=xyz");
+        cmdline_reload();
+        assert_eq!(cmdline_get("frozen2"), Some("xyz"));
+        assert_eq!(cmdline_reload_generation(), generation + 1);
+
+        // Drop back to the scan path so other tests' appends are
+        // visible without a rebuild.
+        REGISTRY_BUILT.store(false, Ordering::Release);
+        });
     }
 }
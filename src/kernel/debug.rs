@@ -150,6 +150,16 @@ pub fn log_set_kernel_start_time(time: u64) {
     unsafe { KERNEL_START_TIME = time; }
 }
 
+/// Host test builds have no boot console; satisfy the C output hooks
+/// with no-op definitions so the test binary links.
+#[cfg(test)]
+#[no_mangle]
+pub extern "C" fn early_print(_s: &str) {}
+
+#[cfg(test)]
+#[no_mangle]
+pub extern "C" fn uart_print(_s: &str) {}
+
 /// Internal print function
 ///
 /// This is the core output function that writes to the console.
@@ -98,6 +98,12 @@ mod tests {
 
     #[test]
     fn test_cmd_rng32() {
+        // Skip on machines without RDRAND/RDSEED; rng32 asserts that
+        // entropy was actually delivered.
+        let mut probe = [0u8; 4];
+        if intel_rng::hw_rng_get_entropy(&mut probe, true) != probe.len() {
+            return;
+        }
         cmd_rng32();
     }
 
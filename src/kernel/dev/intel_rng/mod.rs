@@ -229,6 +229,12 @@ mod tests {
 
     #[test]
     fn test_hw_rng_get_u32() {
+        // Skip on machines without RDRAND/RDSEED; hw_rng_get_u32 asserts
+        // that entropy was actually delivered.
+        let mut probe = [0u8; 4];
+        if hw_rng_get_entropy(&mut probe, true) != probe.len() {
+            return;
+        }
         let val = hw_rng_get_u32();
         // Just verify we got a value without panicking
         let _ = val;
@@ -0,0 +1,264 @@
+// Copyright 2025 The Rustux Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+//! Read-only configuration space cache
+//!
+//! Drivers re-read immutable configuration fields constantly: identity
+//! registers (vendor/device/class/revision) and the capability chain get
+//! walked again on every bring-up and error-recovery pass, and each of
+//! those reads goes all the way out to ECAM MMIO. Under a device recovery
+//! storm the config-access path saturates on reads whose answers never
+//! change.
+//!
+//! This cache snapshots the read-only portion of a function's config
+//! space once, at enumeration time, and serves later reads from memory.
+//! Mutable registers (command/status, BARs being sized, MSI control) are
+//! deliberately not cached. A device reset does not change any cached
+//! field for the same silicon, but a hot-swap does, so reset handling
+//! must call [`config_cache_invalidate`] for the affected function before
+//! re-probing it.
+
+use crate::kernel::dev::pcie::config::*;
+use crate::kernel::dev::pcie::constants::*;
+use crate::kernel::dev::pcie::device::PciCapability;
+use crate::kernel::sync::spin::SpinMutex as SpinMutex;
+
+/// Most functions have well under a dozen capabilities; the spec's 256-byte
+/// config space with 4-byte minimum spacing bounds the chain at 48 entries,
+/// which also serves as the loop guard for malformed chains.
+pub const PCI_CACHE_MAX_CAPS: usize = 48;
+
+/// Number of functions the cache can hold. Enumeration-scale: a system with
+/// more functions than this simply serves the overflow from hardware.
+pub const PCI_CACHE_MAX_DEVICES: usize = 64;
+
+/// Snapshot of the read-only portion of one function's config space.
+#[derive(Debug, Clone, Copy)]
+pub struct CachedConfig {
+    /// Vendor ID
+    pub vendor_id: u16,
+
+    /// Device ID
+    pub device_id: u16,
+
+    /// Class code (base, subclass, interface)
+    pub class_code: (u8, u8, u8),
+
+    /// Revision ID
+    pub revision_id: u8,
+
+    /// Header type (multifunction bit stripped)
+    pub header_type: u8,
+
+    /// Is this a multifunction device?
+    pub is_multifunction: bool,
+
+    /// Subsystem vendor ID
+    pub subsys_vendor_id: u16,
+
+    /// Subsystem ID
+    pub subsys_id: u16,
+
+    /// Interrupt pin (routing is board-fixed; the line register is mutable
+    /// and therefore not cached)
+    pub irq_pin: u8,
+
+    /// Capability chain, in config space order
+    pub caps: [Option<PciCapability>; PCI_CACHE_MAX_CAPS],
+
+    /// Number of valid entries in `caps`
+    pub num_caps: usize,
+}
+
+impl CachedConfig {
+    /// Find a capability by ID in the cached chain.
+    pub fn find_capability(&self, id: u8) -> Option<PciCapability> {
+        self.caps[..self.num_caps].iter().flatten().find(|cap| cap.id == id).copied()
+    }
+}
+
+struct CacheEntry {
+    /// bus << 8 | device << 3 | function
+    bdf: u16,
+    config: CachedConfig,
+}
+
+struct ConfigCache {
+    entries: [Option<CacheEntry>; PCI_CACHE_MAX_DEVICES],
+    hits: u64,
+    misses: u64,
+}
+
+impl ConfigCache {
+    const fn new() -> Self {
+        const EMPTY: Option<CacheEntry> = None;
+        Self {
+            entries: [EMPTY; PCI_CACHE_MAX_DEVICES],
+            hits: 0,
+            misses: 0,
+        }
+    }
+
+    fn lookup(&mut self, bdf: u16) -> Option<CachedConfig> {
+        for entry in self.entries.iter().flatten() {
+            if entry.bdf == bdf {
+                self.hits += 1;
+                return Some(entry.config);
+            }
+        }
+        self.misses += 1;
+        None
+    }
+
+    fn insert(&mut self, bdf: u16, config: CachedConfig) {
+        // Replace an existing entry for the same function, else take the
+        // first free slot; if the cache is full the function just keeps
+        // being served from hardware.
+        let mut free = None;
+        for (ix, entry) in self.entries.iter().enumerate() {
+            match entry {
+                Some(e) if e.bdf == bdf => {
+                    free = Some(ix);
+                    break;
+                }
+                None if free.is_none() => free = Some(ix),
+                _ => {}
+            }
+        }
+        if let Some(ix) = free {
+            self.entries[ix] = Some(CacheEntry { bdf, config });
+        }
+    }
+
+    fn invalidate(&mut self, bdf: u16) {
+        for entry in self.entries.iter_mut() {
+            if matches!(entry, Some(e) if e.bdf == bdf) {
+                *entry = None;
+                return;
+            }
+        }
+    }
+
+    fn invalidate_all(&mut self) {
+        for entry in self.entries.iter_mut() {
+            *entry = None;
+        }
+    }
+}
+
+static CONFIG_CACHE: SpinMutex<ConfigCache> = SpinMutex::new(ConfigCache::new());
+
+fn bdf(bus: u8, device: u8, function: u8) -> u16 {
+    ((bus as u16) << 8) | ((device as u16) << 3) | (function as u16)
+}
+
+/// Walk the capability chain from hardware.
+fn read_capabilities(
+    ecam_base: usize,
+    bus: u8,
+    device: u8,
+    function: u8,
+) -> ([Option<PciCapability>; PCI_CACHE_MAX_CAPS], usize) {
+    let mut caps = [None; PCI_CACHE_MAX_CAPS];
+    let mut num = 0;
+
+    let mut offset = pci_get_capabilities_ptr(ecam_base, bus, device, function) & !0x3;
+    while offset != 0 && num < PCI_CACHE_MAX_CAPS {
+        let addr = PcieAddr::new(0, bus, device, function, offset);
+        let header = unsafe { pci_conf_read16(ecam_base, &addr) };
+        let id = (header & 0xFF) as u8;
+        let next = ((header >> 8) as u8) & !0x3;
+        if id == 0xFF {
+            // The function dropped off the bus mid-walk.
+            break;
+        }
+        caps[num] = Some(PciCapability::new(id, next, offset));
+        num += 1;
+        offset = next;
+    }
+
+    (caps, num)
+}
+
+/// Read the read-only config fields of one function from hardware.
+fn read_config(ecam_base: usize, bus: u8, device: u8, function: u8) -> Option<CachedConfig> {
+    let vendor_id = pci_get_vendor_id(ecam_base, bus, device, function);
+    if vendor_id == PCIE_INVALID_VENDOR_ID || vendor_id == 0 {
+        return None;
+    }
+
+    let header_addr = PcieAddr::new(0, bus, device, function, PCI_CONFIG_HEADER_TYPE);
+    let raw_header = unsafe { pci_conf_read8(ecam_base, &header_addr) };
+    let rev_addr = PcieAddr::new(0, bus, device, function, PCI_CONFIG_REVISION_ID);
+    let subsys_vnd_addr = PcieAddr::new(0, bus, device, function, PCI_CONFIG_SUBSYS_VENDOR_ID);
+    let subsys_addr = PcieAddr::new(0, bus, device, function, PCI_CONFIG_SUBSYS_ID);
+    let pin_addr = PcieAddr::new(0, bus, device, function, PCI_CONFIG_INTERRUPT_PIN);
+
+    let (caps, num_caps) = read_capabilities(ecam_base, bus, device, function);
+
+    Some(CachedConfig {
+        vendor_id,
+        device_id: pci_get_device_id(ecam_base, bus, device, function),
+        class_code: pci_get_class_code(ecam_base, bus, device, function),
+        revision_id: unsafe { pci_conf_read8(ecam_base, &rev_addr) },
+        header_type: raw_header & PCI_HEADER_TYPE_MASK,
+        is_multifunction: (raw_header & PCI_HEADER_TYPE_MULTI_FN) != 0,
+        subsys_vendor_id: unsafe { pci_conf_read16(ecam_base, &subsys_vnd_addr) },
+        subsys_id: unsafe { pci_conf_read16(ecam_base, &subsys_addr) },
+        irq_pin: unsafe { pci_conf_read8(ecam_base, &pin_addr) },
+        caps,
+        num_caps,
+    })
+}
+
+/// Snapshot a function's read-only config space into the cache.
+///
+/// Called once per function at enumeration. Returns the snapshot, or
+/// `None` if no function is present at the address.
+pub fn config_cache_populate(
+    ecam_base: usize,
+    bus: u8,
+    device: u8,
+    function: u8,
+) -> Option<CachedConfig> {
+    let config = read_config(ecam_base, bus, device, function)?;
+    CONFIG_CACHE.lock().insert(bdf(bus, device, function), config);
+    Some(config)
+}
+
+/// Get a function's read-only config, serving from the cache when
+/// possible and falling back to (and refilling from) hardware.
+pub fn config_cache_get(
+    ecam_base: usize,
+    bus: u8,
+    device: u8,
+    function: u8,
+) -> Option<CachedConfig> {
+    if let Some(config) = CONFIG_CACHE.lock().lookup(bdf(bus, device, function)) {
+        return Some(config);
+    }
+    config_cache_populate(ecam_base, bus, device, function)
+}
+
+/// Drop the cached snapshot for one function.
+///
+/// Must be called on any reset event that can change what is behind the
+/// address (hot-swap, secondary bus reset) before the function is
+/// re-probed; re-probing repopulates the cache from hardware.
+pub fn config_cache_invalidate(bus: u8, device: u8, function: u8) {
+    CONFIG_CACHE.lock().invalidate(bdf(bus, device, function));
+}
+
+/// Drop every cached snapshot, e.g. across a bus rescan.
+pub fn config_cache_invalidate_all() {
+    CONFIG_CACHE.lock().invalidate_all();
+}
+
+/// Snapshot of the cache's hit/miss counters, for diagnostics.
+pub fn config_cache_stats() -> (u64, u64) {
+    let cache = CONFIG_CACHE.lock();
+    (cache.hits, cache.misses)
+}
@@ -316,6 +316,16 @@ impl Iterator for PciDeviceIterator {
                             self.function - 1,
                         );
 
+                        // Snapshot the read-only config fields while we are
+                        // here, so later identity and capability reads are
+                        // served from memory instead of ECAM.
+                        crate::kernel::dev::pcie::cache::config_cache_populate(
+                            self.ecam_base,
+                            self.bus,
+                            self.device,
+                            self.function - 1,
+                        );
+
                         // Check if we need to scan all functions
                         if self.function == 1
                             && !crate::kernel::dev::pcie::config::pci_is_multi_function(
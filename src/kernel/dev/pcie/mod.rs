@@ -32,12 +32,14 @@
 //! ```
 
 
+pub mod cache;
 pub mod constants;
 pub mod config;
 pub mod device;
 pub mod ecam;
 
 // Re-exports
+pub use cache::*;
 pub use constants::*;
 pub use config::*;
 pub use device::*;
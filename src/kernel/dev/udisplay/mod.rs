@@ -15,6 +15,7 @@
 //! - Display info management
 //! - Gfxconsole binding
 //! - Crash screen support
+//! - Dirty-region tracking with vsync-paced partial flushes
 //!
 //! # Usage
 //!
@@ -33,6 +34,7 @@
 //! ```
 
 use crate::kernel::vm::{Result, VmError};
+use crate::kernel::vm::arch_vm_aspace::{ARCH_MMU_FLAG_CACHE_MASK, ARCH_MMU_FLAG_WRITE_COMBINING};
 
 /// Display pixel format
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
@@ -102,6 +104,13 @@ pub struct UDisplayState {
     /// Size of framebuffer in bytes
     framebuffer_size: usize,
 
+    /// Cache policy for the framebuffer mapping (ARCH_MMU_FLAG_* bits)
+    ///
+    /// Write-combining by default: framebuffer writes are streaming
+    /// stores that never read back, and WC batches them in the store
+    /// buffers instead of serializing each one like UC does.
+    cache_policy: u64,
+
     /// Display information
     info: DisplayInfo,
 }
@@ -112,6 +121,7 @@ impl UDisplayState {
         Self {
             framebuffer_virt: None,
             framebuffer_size: 0,
+            cache_policy: ARCH_MMU_FLAG_WRITE_COMBINING,
             info: DisplayInfo {
                 framebuffer: None,
                 format: PixelFormat::Xrgb8888,
@@ -138,6 +148,11 @@ impl UDisplayState {
     pub fn info(&self) -> &DisplayInfo {
         &self.info
     }
+
+    /// Get the framebuffer mapping cache policy
+    pub fn cache_policy(&self) -> u64 {
+        self.cache_policy
+    }
 }
 
 /// Global display state
@@ -206,7 +221,8 @@ pub fn clear_framebuffer_vmo() {
 pub fn set_framebuffer(vmo_addr: usize, size: usize) -> Result {
     clear_framebuffer_vmo();
 
-    // TODO: Create VMO mapping into kernel address space
+    // TODO: Create VMO mapping into kernel address space with
+    // GLOBAL_DISPLAY.cache_policy in the mapping flags
     // For now, just track the physical address
     unsafe {
         GLOBAL_DISPLAY.framebuffer_virt = Some(vmo_addr);
@@ -214,14 +230,40 @@ pub fn set_framebuffer(vmo_addr: usize, size: usize) -> Result {
     }
 
     crate::log_info!(
-        "Framebuffer mapped: addr={:#x}, size={}",
+        "Framebuffer mapped: addr={:#x}, size={}, cache_policy={:#x}",
         vmo_addr,
-        size
+        size,
+        unsafe { GLOBAL_DISPLAY.cache_policy() }
     );
 
     Ok(())
 }
 
+/// Set the framebuffer mapping cache policy
+///
+/// Must be called before `set_framebuffer`; the policy applies to the
+/// next mapping, not to an existing one.
+///
+/// # Arguments
+///
+/// * `policy` - ARCH_MMU_FLAG_* cache policy bits
+///
+/// # Returns
+///
+/// Ok(()) on success, or an error if the value has bits outside the
+/// cache policy mask
+pub fn set_cache_policy(policy: u64) -> Result {
+    if policy & !ARCH_MMU_FLAG_CACHE_MASK != 0 {
+        return Err(VmError::InvalidArgs);
+    }
+
+    unsafe {
+        GLOBAL_DISPLAY.cache_policy = policy;
+    }
+
+    Ok(())
+}
+
 /// Set display information
 ///
 /// Updates the display info structure with the provided information.
@@ -277,6 +319,133 @@ pub fn bind_gfxconsole() -> Result {
     Ok(())
 }
 
+/// ============================================================================
+/// Dirty-Region Tracking and Paced Flush
+/// ============================================================================
+///
+/// The framebuffer is divided into up to 64 horizontal bands, tracked in
+/// one bitmap word. The VM layer write-protects the framebuffer VMO after
+/// each flush; the first store to a clean page faults, marks its rows
+/// dirty here, and lifts the protection until the next flush re-arms it.
+/// `flush_frame` then copies only the dirty bands (coalesced into runs of
+/// adjacent bands) through the display's flush callback, and no more than
+/// once per vsync interval - a mostly-static screen costs a few faults
+/// and a couple of band copies instead of a full-frame copy at 60Hz.
+
+use core::sync::atomic::{AtomicU64, Ordering};
+
+/// Number of horizontal bands in the dirty bitmap
+pub const DIRTY_BANDS: u32 = 64;
+
+/// Bitmap of dirty bands (bit N = band N has been written since the
+/// last flush)
+static DIRTY: AtomicU64 = AtomicU64::new(0);
+
+/// Time of the last flush, for vsync pacing
+static LAST_FLUSH_NS: AtomicU64 = AtomicU64::new(0);
+
+/// Minimum interval between flushes (default 60Hz)
+static VSYNC_INTERVAL_NS: AtomicU64 = AtomicU64::new(16_666_667);
+
+/// Flushes skipped because the whole frame was clean
+static CLEAN_SKIPS: AtomicU64 = AtomicU64::new(0);
+
+/// Rows covered by each band for a framebuffer of `height` rows
+fn rows_per_band(height: u32) -> u32 {
+    // Round up so DIRTY_BANDS bands always cover the whole height.
+    ((height + DIRTY_BANDS - 1) / DIRTY_BANDS).max(1)
+}
+
+/// Mark a row range `[first_row, last_row]` dirty
+///
+/// Called from the VMO write-protect fault path when userspace first
+/// touches a clean framebuffer page.
+pub fn mark_dirty_rows(first_row: u32, last_row: u32) {
+    let height = unsafe { GLOBAL_DISPLAY.info.height };
+    if height == 0 {
+        return;
+    }
+    let rows = rows_per_band(height);
+    let first = (first_row / rows).min(DIRTY_BANDS - 1);
+    let last = (last_row / rows).min(DIRTY_BANDS - 1);
+
+    let mut mask = 0u64;
+    for band in first..=last {
+        mask |= 1u64 << band;
+    }
+    DIRTY.fetch_or(mask, Ordering::Relaxed);
+}
+
+/// Mark the entire frame dirty (e.g. after a mode switch or remap)
+pub fn mark_dirty_all() {
+    DIRTY.store(u64::MAX, Ordering::Relaxed);
+}
+
+/// Set the flush pacing interval
+///
+/// Callers should pass the display's real refresh period; 0 disables
+/// pacing (every flush_frame call flushes).
+pub fn set_vsync_interval(interval_ns: u64) {
+    VSYNC_INTERVAL_NS.store(interval_ns, Ordering::Relaxed);
+}
+
+/// Flush the dirty portion of the frame to the display
+///
+/// Returns true if anything was flushed. A clean frame costs one atomic
+/// load; a call inside the current vsync interval is deferred (the dirty
+/// bits stay set and the next on-pace call picks them up).
+pub fn flush_frame() -> bool {
+    flush_frame_at(crate::kernel::timer::current_time())
+}
+
+/// Pacing and flush logic with an explicit clock, split out for testing
+fn flush_frame_at(now_ns: u64) -> bool {
+    if DIRTY.load(Ordering::Relaxed) == 0 {
+        CLEAN_SKIPS.fetch_add(1, Ordering::Relaxed);
+        return false;
+    }
+
+    let interval = VSYNC_INTERVAL_NS.load(Ordering::Relaxed);
+    let last = LAST_FLUSH_NS.load(Ordering::Relaxed);
+    if interval != 0 && now_ns.saturating_sub(last) < interval {
+        // Mid-interval: leave the dirty bits for the next paced call.
+        return false;
+    }
+    LAST_FLUSH_NS.store(now_ns, Ordering::Relaxed);
+
+    let dirty = DIRTY.swap(0, Ordering::Relaxed);
+    let (height, flush) = unsafe { (GLOBAL_DISPLAY.info.height, GLOBAL_DISPLAY.info.flush) };
+    if height == 0 {
+        return false;
+    }
+
+    let Some(flush) = flush else {
+        // No flush callback: the write-combined mapping is the
+        // framebuffer itself and the stores have already landed.
+        return true;
+    };
+
+    // Walk runs of adjacent dirty bands so each run costs one callback.
+    let rows = rows_per_band(height);
+    let mut band = 0u32;
+    while band < DIRTY_BANDS {
+        if dirty & (1u64 << band) == 0 {
+            band += 1;
+            continue;
+        }
+        let first = band;
+        while band < DIRTY_BANDS && dirty & (1u64 << band) != 0 {
+            band += 1;
+        }
+        let y0 = first * rows;
+        let y1 = (band * rows).min(height);
+        if y0 < height {
+            unsafe { flush(y0, y1) };
+        }
+    }
+    true
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -312,6 +481,47 @@ mod tests {
 
         assert!(state.framebuffer_virt().is_none());
         assert_eq!(state.framebuffer_size(), 0);
+        assert_eq!(state.cache_policy(), ARCH_MMU_FLAG_WRITE_COMBINING);
+    }
+
+    #[test]
+    fn test_set_cache_policy_rejects_non_policy_bits() {
+        assert!(set_cache_policy(ARCH_MMU_FLAG_CACHE_MASK + 1).is_err());
+        assert!(set_cache_policy(ARCH_MMU_FLAG_WRITE_COMBINING).is_ok());
+    }
+
+    #[test]
+    fn test_dirty_bands_and_pacing() {
+        // 640 rows over 64 bands: 10 rows per band.
+        unsafe {
+            GLOBAL_DISPLAY.info.height = 640;
+        }
+        set_vsync_interval(0);
+        DIRTY.store(0, Ordering::Relaxed);
+
+        mark_dirty_rows(0, 9);
+        mark_dirty_rows(25, 25);
+        assert_eq!(DIRTY.load(Ordering::Relaxed), 0b101);
+
+        // No flush callback: the flush still consumes the dirty bits.
+        assert!(flush_frame_at(0));
+        assert_eq!(DIRTY.load(Ordering::Relaxed), 0);
+
+        // Clean frame: nothing to do.
+        assert!(!flush_frame_at(0));
+
+        // A mid-interval call defers and keeps the dirty bits; the next
+        // on-pace call flushes them.
+        set_vsync_interval(16_000_000);
+        LAST_FLUSH_NS.store(100, Ordering::Relaxed);
+        mark_dirty_all();
+        assert!(!flush_frame_at(8_000_100));
+        assert_ne!(DIRTY.load(Ordering::Relaxed), 0);
+        assert!(flush_frame_at(16_000_100));
+
+        unsafe {
+            GLOBAL_DISPLAY.info.height = 0;
+        }
     }
 
     #[test]
@@ -11,10 +11,16 @@
 //!
 //! # Design
 //!
-//! - **Per-CPU DPC queues**: Each CPU has its own DPC queue
+//! - **Per-CPU DPC queues**: Each CPU has its own DPC queues
+//! - **Lock-free lanes**: Queueing is a compare-exchange push, safe from
+//!   interrupt context with no lock to contend on
+//! - **Priority lanes**: A high lane for latency-sensitive work (driver
+//!   completions) and a low lane for bulk work (object cleanup); the worker
+//!   polls the high lane between low-lane items so completion DPCs never
+//!   wait behind a slow cleanup
+//! - **Latency counters**: Per-lane queue-to-execution latency statistics
 //! - **Dedicated thread**: Each CPU has a DPC worker thread
-//! - **Deferred execution**: Work can be queued from interrupt context
-//! - **FIFO ordering**: DPCs executed in order they were queued
+//! - **FIFO ordering**: DPCs executed in order they were queued, per lane
 //!
 //! # Usage
 //!
@@ -23,8 +29,11 @@
 //!     // Do work
 //! });
 //!
-//! // Queue for later execution
+//! // Queue for later execution (bulk lane)
 //! dpc.queue(true)?;
+//!
+//! // Latency-sensitive work goes on the high lane
+//! dpc.queue_with_priority(DpcPriority::High, true)?;
 //! ```
 
 
@@ -32,7 +41,8 @@ use crate::kernel::sync::{Event, EventFlags, Mutex};
 use crate::kernel::thread::ThreadId;
 use crate::rustux::types::*;
 use crate::rustux::types::err::*;
-use core::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+use core::ptr;
+use core::sync::atomic::{AtomicBool, AtomicPtr, AtomicU64, Ordering};
 
 // Import logging macros
 use crate::{log_debug, log_info};
@@ -47,6 +57,20 @@ pub type DpcCallback = unsafe fn(dpc: &Dpc);
 /// DPC priority level
 pub const DPC_THREAD_PRIORITY: u8 = 32; // Higher than default
 
+/// DPC queue lane
+#[repr(usize)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum DpcPriority {
+    /// Bulk work (object cleanup, teardown)
+    Low = 0,
+
+    /// Latency-sensitive work (driver completions)
+    High = 1,
+}
+
+/// Number of priority lanes per CPU
+pub const DPC_NUM_LANES: usize = 2;
+
 /// DPC structure
 ///
 /// Represents a deferred procedure call that can be queued for later execution.
@@ -57,11 +81,14 @@ pub struct Dpc {
     /// Opaque argument passed to callback
     pub arg: u64,
 
-    /// Node for linked list
-    pub next: Mutex<Option<&'static Dpc>>,
+    /// Intrusive link used by the lock-free lane
+    pub next: AtomicPtr<Dpc>,
 
     /// Whether this DPC is currently queued
     pub queued: AtomicBool,
+
+    /// Time this DPC was queued, for the lane latency counters
+    pub enqueue_time: AtomicU64,
 }
 
 unsafe impl Send for Dpc {}
@@ -72,8 +99,9 @@ impl Dpc {
         Self {
             func: Mutex::new(None),
             arg: 0,
-            next: Mutex::new(None),
+            next: AtomicPtr::new(ptr::null_mut()),
             queued: AtomicBool::new(false),
+            enqueue_time: AtomicU64::new(0),
         }
     }
 
@@ -82,8 +110,9 @@ impl Dpc {
         Self {
             func: Mutex::new(Some(callback)),
             arg: 0,
-            next: Mutex::new(None),
+            next: AtomicPtr::new(ptr::null_mut()),
             queued: AtomicBool::new(false),
+            enqueue_time: AtomicU64::new(0),
         }
     }
 
@@ -97,7 +126,7 @@ impl Dpc {
         self.arg = arg;
     }
 
-    /// Queue the DPC for execution
+    /// Queue the DPC for execution on the bulk (low priority) lane
     ///
     /// # Arguments
     ///
@@ -108,40 +137,59 @@ impl Dpc {
     /// - `Ok(())` if queued successfully
     /// - `Err(RX_ERR_ALREADY_EXISTS)` if already queued
     pub fn queue(&self, reschedule: bool) -> Result {
-        // Check if already queued
-        if self.queued.load(Ordering::Acquire) {
+        self.queue_with_priority(DpcPriority::Low, reschedule)
+    }
+
+    /// Queue the DPC on a specific priority lane
+    ///
+    /// # Arguments
+    ///
+    /// * `priority` - Lane to queue on; High for latency-sensitive work
+    /// * `reschedule` - Whether to trigger immediate rescheduling
+    ///
+    /// # Returns
+    ///
+    /// - `Ok(())` if queued successfully
+    /// - `Err(RX_ERR_ALREADY_EXISTS)` if already queued
+    pub fn queue_with_priority(&self, priority: DpcPriority, reschedule: bool) -> Result {
+        // Claim the queued flag atomically so concurrent queuers can't
+        // link the same node into a lane twice.
+        if self
+            .queued
+            .compare_exchange(false, true, Ordering::AcqRel, Ordering::Acquire)
+            .is_err()
+        {
             return Err(RX_ERR_ALREADY_EXISTS);
         }
 
-        // Get current CPU's DPC queue
-        let cpu_num = crate::kernel::percpu::current_cpu_num() as usize;
+        self.enqueue_time
+            .store(crate::kernel::timer::current_time(), Ordering::Relaxed);
+
+        // Get current CPU's DPC queue; work raised on an isolated CPU is
+        // redirected so its worker thread never runs on a quiesced core
+        let cpu_num = crate::kernel::sched::isolation::general_cpu_for(
+            crate::kernel::percpu::current_cpu_num());
 
         // Add to queue
         unsafe {
-            dpc_queue_cpu(self, cpu_num as u32, reschedule)?;
+            dpc_queue_cpu(self, cpu_num, priority, reschedule)?;
         }
 
-        self.queued.store(true, Ordering::Release);
         Ok(())
     }
 
     /// Cancel the DPC if queued
     ///
+    /// The lanes are lock-free, so the node cannot be unlinked here;
+    /// clearing the queued flag makes the draining worker skip it.
+    ///
     /// # Returns
     ///
-    /// true if was queued and removed, false otherwise
+    /// true if was queued and will not run, false otherwise
     pub fn cancel(&self) -> bool {
-        if !self.queued.load(Ordering::Acquire) {
-            return false;
-        }
-
-        // Remove from queue
-        unsafe {
-            dpc_remove_from_queue(self);
-        }
-
-        self.queued.store(false, Ordering::Release);
-        true
+        self.queued
+            .compare_exchange(true, false, Ordering::AcqRel, Ordering::Acquire)
+            .is_ok()
     }
 
     /// Execute the DPC callback
@@ -162,77 +210,134 @@ impl Dpc {
 }
 
 /// ============================================================================
-/// Per-CPU DPC State
+/// DPC Lane
 /// ============================================================================
 
-/// Per-CPU DPC state
-pub struct DpcState {
-    /// DPC queue for this CPU
-    pub queue: Mutex<DpcQueue>,
+/// Per-lane latency statistics snapshot
+#[derive(Debug, Clone, Copy)]
+pub struct DpcLaneStats {
+    /// DPCs queued on this lane
+    pub queued: u64,
 
-    /// Event to signal when DPCs are queued
-    pub event: Event,
+    /// DPCs executed from this lane
+    pub executed: u64,
 
-    /// DPC thread ID for this CPU
-    pub thread_id: Mutex<Option<ThreadId>>,
+    /// Total queue-to-execution latency in nanoseconds
+    pub latency_ns_total: u64,
 
-    /// Whether DPC thread should stop
-    pub stop: AtomicBool,
-
-    /// Whether this DPC state is initialized
-    pub initialized: AtomicBool,
+    /// Worst observed queue-to-execution latency in nanoseconds
+    pub latency_ns_max: u64,
 }
 
-/// DPC queue (linked list)
-pub struct DpcQueue {
-    pub head: Option<&'static Dpc>,
-    pub tail: Option<&'static Dpc>,
-    pub count: usize,
+/// One lock-free DPC lane
+///
+/// Pushing is a compare-exchange loop on the head (safe from interrupt
+/// context, multiple producers); the single worker thread drains the whole
+/// lane with one atomic swap and reverses the chain to FIFO order.
+pub struct DpcLane {
+    /// Pending DPCs, newest first
+    head: AtomicPtr<Dpc>,
+
+    /// DPCs queued on this lane since boot
+    queued_count: AtomicU64,
+
+    /// DPCs executed from this lane since boot
+    executed_count: AtomicU64,
+
+    /// Total queue-to-execution latency, nanoseconds
+    latency_ns_total: AtomicU64,
+
+    /// Worst observed queue-to-execution latency, nanoseconds
+    latency_ns_max: AtomicU64,
 }
 
-impl DpcQueue {
+impl DpcLane {
     pub const fn new() -> Self {
         Self {
-            head: None,
-            tail: None,
-            count: 0,
+            head: AtomicPtr::new(ptr::null_mut()),
+            queued_count: AtomicU64::new(0),
+            executed_count: AtomicU64::new(0),
+            latency_ns_total: AtomicU64::new(0),
+            latency_ns_max: AtomicU64::new(0),
         }
     }
 
-    /// Add a DPC to the tail of the queue
-    pub fn push(&mut self, dpc: &'static Dpc) {
-        if let Some(tail) = self.tail {
-            *tail.next.lock() = Some(dpc);
-        } else {
-            self.head = Some(dpc);
+    /// Push a DPC onto the lane. Lock-free, callable from any context.
+    pub fn push(&self, dpc: &'static Dpc) {
+        let dpc_ptr = dpc as *const Dpc as *mut Dpc;
+
+        let mut head = self.head.load(Ordering::Acquire);
+        loop {
+            dpc.next.store(head, Ordering::Relaxed);
+            match self.head.compare_exchange_weak(
+                head,
+                dpc_ptr,
+                Ordering::Release,
+                Ordering::Acquire,
+            ) {
+                Ok(_) => break,
+                Err(observed) => head = observed,
+            }
         }
-        self.tail = Some(dpc);
-        self.count += 1;
+
+        self.queued_count.fetch_add(1, Ordering::Relaxed);
     }
 
-    /// Remove a DPC from the head of the queue
-    pub fn pop(&mut self) -> Option<&'static Dpc> {
-        self.head.map(|dpc| {
-            self.head = *dpc.next.lock();
-            if self.head.is_none() {
-                self.tail = None;
-            }
-            self.count -= 1;
-            dpc
-        })
+    /// Atomically take every pending DPC, returned as a FIFO chain
+    ///
+    /// Only the worker thread calls this, so a single swap detaches the
+    /// whole lane; the LIFO chain is then reversed into queue order.
+    pub fn take_all(&self) -> *mut Dpc {
+        let mut node = self.head.swap(ptr::null_mut(), Ordering::AcqRel);
+
+        let mut fifo: *mut Dpc = ptr::null_mut();
+        while !node.is_null() {
+            let next = unsafe { (*node).next.load(Ordering::Relaxed) };
+            unsafe { (*node).next.store(fifo, Ordering::Relaxed) };
+            fifo = node;
+            node = next;
+        }
+        fifo
     }
 
-    /// Check if queue is empty
+    /// Check if the lane has pending DPCs
     pub fn is_empty(&self) -> bool {
-        self.head.is_none()
+        self.head.load(Ordering::Acquire).is_null()
     }
 
-    /// Get queue length
-    pub fn len(&self) -> usize {
-        self.count
+    /// Snapshot the lane counters
+    pub fn stats(&self) -> DpcLaneStats {
+        DpcLaneStats {
+            queued: self.queued_count.load(Ordering::Relaxed),
+            executed: self.executed_count.load(Ordering::Relaxed),
+            latency_ns_total: self.latency_ns_total.load(Ordering::Relaxed),
+            latency_ns_max: self.latency_ns_max.load(Ordering::Relaxed),
+        }
     }
 }
 
+/// ============================================================================
+/// Per-CPU DPC State
+/// ============================================================================
+
+/// Per-CPU DPC state
+pub struct DpcState {
+    /// Priority lanes for this CPU, indexed by DpcPriority
+    pub lanes: [DpcLane; DPC_NUM_LANES],
+
+    /// Event to signal when DPCs are queued
+    pub event: Event,
+
+    /// DPC thread ID for this CPU
+    pub thread_id: Mutex<Option<ThreadId>>,
+
+    /// Whether DPC thread should stop
+    pub stop: AtomicBool,
+
+    /// Whether this DPC state is initialized
+    pub initialized: AtomicBool,
+}
+
 /// ============================================================================
 /// Global DPC State
 /// ============================================================================
@@ -240,13 +345,10 @@ impl DpcQueue {
 /// Per-CPU DPC state array
 static mut DPC_STATES: [DpcState; 256] = [const { DpcState::new() }; 256];
 
-/// DPC lock
-static DPC_LOCK: core::sync::atomic::AtomicBool = core::sync::atomic::AtomicBool::new(false);
-
 impl DpcState {
     const fn new() -> Self {
         Self {
-            queue: Mutex::new(DpcQueue::new()),
+            lanes: [const { DpcLane::new() }; DPC_NUM_LANES],
             event: Event::new(false, EventFlags::empty()),
             thread_id: Mutex::new(None),
             stop: AtomicBool::new(false),
@@ -291,28 +393,66 @@ impl DpcState {
         log_info!("DPC shutdown for CPU");
     }
 
-    /// Process DPCs from the queue
+    /// Execute one drained DPC, updating its lane's latency counters
+    fn execute_one(&self, dpc: &Dpc, lane: usize) {
+        // A canceled DPC stays linked until its lane drains; skip it here.
+        // The swap also marks the DPC free for re-queueing.
+        if !dpc.queued.swap(false, Ordering::AcqRel) {
+            return;
+        }
+
+        let now = crate::kernel::timer::current_time();
+        let latency = now.saturating_sub(dpc.enqueue_time.load(Ordering::Relaxed));
+
+        let stats = &self.lanes[lane];
+        stats.executed_count.fetch_add(1, Ordering::Relaxed);
+        stats.latency_ns_total.fetch_add(latency, Ordering::Relaxed);
+        stats.latency_ns_max.fetch_max(latency, Ordering::Relaxed);
+
+        dpc.execute();
+    }
+
+    /// Drain and execute the high lane. Returns true if anything ran.
+    fn drain_high(&self) -> bool {
+        let mut node = self.lanes[DpcPriority::High as usize].take_all();
+        let ran = !node.is_null();
+
+        while !node.is_null() {
+            let dpc = unsafe { &*node };
+            node = dpc.next.load(Ordering::Relaxed);
+            self.execute_one(dpc, DpcPriority::High as usize);
+        }
+        ran
+    }
+
+    /// Process DPCs from the queues
     ///
-    /// Called by the DPC worker thread.
+    /// Called by the DPC worker thread. The high lane runs first and is
+    /// re-polled between low-lane items, so latency-sensitive DPCs never
+    /// wait behind a slow bulk DPC already in progress.
     pub fn process(&self) -> bool {
-        // Pop and execute DPCs
         loop {
-            let dpc = {
-                let mut queue = self.queue.lock();
-                queue.pop()
-            };
-
-            match dpc {
-                Some(dpc) => {
-                    dpc.queued.store(false, Ordering::Release);
-                    dpc.execute();
-                }
-                None => {
-                    // Queue is empty, unsignal the event
-                    self.event.unsignal();
-                    break;
+            let mut ran = self.drain_high();
+
+            // One batch of bulk work, yielding to the high lane after
+            // every item.
+            let mut node = self.lanes[DpcPriority::Low as usize].take_all();
+            while !node.is_null() {
+                let dpc = unsafe { &*node };
+                node = dpc.next.load(Ordering::Relaxed);
+                self.execute_one(dpc, DpcPriority::Low as usize);
+                ran = true;
+
+                if !self.lanes[DpcPriority::High as usize].is_empty() {
+                    self.drain_high();
                 }
             }
+
+            if !ran {
+                // Queues are empty, unsignal the event
+                self.event.unsignal();
+                break;
+            }
         }
 
         // Check if we should stop
@@ -344,23 +484,22 @@ pub fn dpc_init() {
     dpc_init_for_cpu();
 }
 
-/// Queue a DPC on a specific CPU
+/// Queue a DPC on a specific CPU and lane
 ///
 /// # Safety
 ///
-/// Must be called with appropriate locking.
-pub unsafe fn dpc_queue_cpu(dpc: &Dpc, cpu_id: u32, reschedule: bool) -> Result {
+/// The DPC must outlive its execution; the caller must have claimed the
+/// DPC's queued flag.
+pub unsafe fn dpc_queue_cpu(dpc: &Dpc, cpu_id: u32, priority: DpcPriority,
+                            reschedule: bool) -> Result {
     if cpu_id >= 256 {
         return Err(RX_ERR_INVALID_ARGS);
     }
 
     let state = &DPC_STATES[cpu_id as usize];
 
-    // Add to queue
-    {
-        let mut queue = state.queue.lock();
-        queue.push(unsafe { &*(dpc as *const Dpc) });
-    }
+    // Lock-free push onto the requested lane
+    state.lanes[priority as usize].push(unsafe { &*(dpc as *const Dpc) });
 
     // Signal the event
     if reschedule {
@@ -372,15 +511,18 @@ pub unsafe fn dpc_queue_cpu(dpc: &Dpc, cpu_id: u32, reschedule: bool) -> Result
     Ok(())
 }
 
-/// Remove a DPC from its queue
-///
-/// # Safety
+/// Snapshot the per-lane statistics for a CPU
 ///
-/// Must be called with appropriate locking.
-pub unsafe fn dpc_remove_from_queue(dpc: &Dpc) {
-    // In a real implementation, this would search all CPU queues
-    // and remove the DPC. For now, this is a stub.
-    let _ = dpc;
+/// Lane 0 is the low (bulk) lane, lane 1 the high (completion) lane.
+pub fn dpc_lane_stats(cpu_id: u32) -> Option<[DpcLaneStats; DPC_NUM_LANES]> {
+    if cpu_id >= 256 {
+        return None;
+    }
+
+    unsafe {
+        let state = &DPC_STATES[cpu_id as usize];
+        Some([state.lanes[0].stats(), state.lanes[1].stats()])
+    }
 }
 
 /// Shutdown DPC for a specific CPU
@@ -406,14 +548,19 @@ pub fn dpc_transition_off_cpu(src_cpu: u32, dst_cpu: u32) {
         let src_state = &DPC_STATES[src_cpu as usize];
         let dst_state = &DPC_STATES[dst_cpu as usize];
 
-        // Move all DPCs from src to dst
-        let mut src_queue = src_state.queue.lock();
-        let mut dst_queue = dst_state.queue.lock();
-
-        while let Some(dpc) = src_queue.pop() {
-            dst_queue.push(dpc);
+        // Move all DPCs lane by lane; take_all yields FIFO order and push
+        // reverses it, which the destination drain reverses back.
+        for lane in 0..DPC_NUM_LANES {
+            let mut node = src_state.lanes[lane].take_all();
+            while !node.is_null() {
+                let dpc = &*node;
+                node = dpc.next.load(Ordering::Relaxed);
+                dst_state.lanes[lane].push(dpc);
+            }
         }
 
+        dst_state.event.signal();
+
         // Reset source state
         src_state.stop.store(false, Ordering::Release);
         src_state.initialized.store(false, Ordering::Release);
@@ -485,6 +632,7 @@ pub fn init() {
 #[cfg(test)]
 mod tests {
     use super::*;
+    use alloc::boxed::Box;
 
     #[test]
     fn test_dpc_new() {
@@ -509,18 +657,42 @@ mod tests {
     }
 
     #[test]
-    fn test_dpc_queue() {
-        let queue = DpcQueue::new();
-        assert!(queue.is_empty());
-        assert_eq!(queue.len(), 0);
-
-        // Note: We can't create static references to stack-allocated DPCs
-        // in modern Rust. This test would need a different approach,
-        // such as using Box::leak or changing the queue implementation.
-        // For now, we'll skip the static reference test.
-
-        // Test basic push/pop with non-static references
-        // Note: This would require modifying the DpcQueue to accept
-        // non-static references, which is a larger change.
+    fn test_dpc_lane_fifo() {
+        let lane = DpcLane::new();
+        assert!(lane.is_empty());
+
+        let first: &'static mut Dpc = Box::leak(Box::new(Dpc::new()));
+        first.arg = 1;
+        let second: &'static mut Dpc = Box::leak(Box::new(Dpc::new()));
+        second.arg = 2;
+
+        lane.push(first);
+        lane.push(second);
+        assert!(!lane.is_empty());
+        assert_eq!(lane.stats().queued, 2);
+
+        // take_all returns queue (FIFO) order despite the LIFO push.
+        let mut node = lane.take_all();
+        let mut args = alloc::vec::Vec::new();
+        while !node.is_null() {
+            let dpc = unsafe { &*node };
+            args.push(dpc.arg);
+            node = dpc.next.load(Ordering::Relaxed);
+        }
+        assert_eq!(args, [1, 2]);
+        assert!(lane.is_empty());
+    }
+
+    #[test]
+    fn test_dpc_cancel() {
+        let dpc = Dpc::new();
+
+        // Not queued, nothing to cancel.
+        assert!(!dpc.cancel());
+
+        // Simulate a queued DPC: cancel claims the flag exactly once.
+        dpc.queued.store(true, Ordering::Release);
+        assert!(dpc.cancel());
+        assert!(!dpc.cancel());
     }
 }
@@ -0,0 +1,268 @@
+// Copyright 2025 The Rustux Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+//! Idle Governor
+//!
+//! This module decides how deeply a CPU should sleep when it has nothing
+//! to run, and provides an IPI-avoidance path for waking idle CPUs.
+//!
+//! # Design
+//!
+//! - **Latency-aware depth**: The next timer deadline predicts how long the
+//!   CPU will sleep. Short sleeps pick a shallow state (fast exit), long
+//!   sleeps pick a deep state (more power saved, slower exit).
+//! - **mwait wakeups on x86**: An idle CPU parks in MONITOR/MWAIT on its
+//!   per-CPU wake word. A remote CPU wakes it with a single store instead
+//!   of an IPI, cutting cross-core wakeup latency out of the interrupt path.
+//! - **wfi elsewhere**: arm64 and riscv64 idle in `wfi` and are woken by the
+//!   usual reschedule IPI.
+//!
+//! # Usage
+//!
+//! ```rust
+//! // From the idle thread, once nothing is runnable:
+//! cpu_idle();
+//!
+//! // From mp_reschedule, before sending an IPI:
+//! if try_wake_cpu(cpu) {
+//!     // CPU was parked in mwait and is already waking - skip the IPI.
+//! }
+//! ```
+
+use crate::kernel::mp;
+use crate::kernel::percpu;
+use crate::kernel::thread;
+use crate::kernel::timer;
+use core::sync::atomic::{AtomicBool, AtomicU32, Ordering};
+
+/// ============================================================================
+/// Idle States
+/// ============================================================================
+
+/// Idle state depth, ordered from shallowest to deepest.
+///
+/// The discriminant doubles as the x86 MWAIT hint for the state
+/// (bits 7:4 encode the target C-state minus one).
+#[repr(u32)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord)]
+pub enum IdleState {
+    /// C1: halt the core, near-instant exit.
+    C1 = 0x00,
+
+    /// C2: stop the core clock, exit in a few microseconds.
+    C2 = 0x10,
+
+    /// C3: flush core caches and power down, exit in tens of microseconds.
+    C3 = 0x20,
+}
+
+impl IdleState {
+    /// MWAIT hint encoding this state.
+    pub const fn mwait_hint(self) -> u32 {
+        self as u32
+    }
+}
+
+/// Predicted sleeps shorter than this stay in C1.
+pub const IDLE_C2_THRESHOLD_NS: u64 = 20_000;
+
+/// Predicted sleeps shorter than this stay in C2 or shallower.
+pub const IDLE_C3_THRESHOLD_NS: u64 = 200_000;
+
+/// Select an idle state from the predicted sleep duration.
+///
+/// The thresholds are a multiple of each state's exit latency so that the
+/// cost of waking up stays a small fraction of the time spent asleep.
+pub fn idle_state_for_sleep(sleep_ns: u64) -> IdleState {
+    if sleep_ns < IDLE_C2_THRESHOLD_NS {
+        IdleState::C1
+    } else if sleep_ns < IDLE_C3_THRESHOLD_NS {
+        IdleState::C2
+    } else {
+        IdleState::C3
+    }
+}
+
+/// Predict how long the current CPU will sleep.
+///
+/// Returns the time until the next timer deadline, or u64::MAX if no
+/// timer is pending.
+pub fn predicted_sleep_ns() -> u64 {
+    let deadline = timer::next_deadline();
+    if deadline == u64::MAX {
+        return u64::MAX;
+    }
+
+    let now = timer::current_time();
+    deadline.saturating_sub(now)
+}
+
+/// ============================================================================
+/// Per-CPU Idle State
+/// ============================================================================
+
+/// Per-CPU wake word and mwait flag, one cache line per CPU so remote
+/// wakeups don't false-share with neighbours.
+#[repr(C, align(64))]
+struct CpuIdleState {
+    /// Written by remote CPUs to wake this CPU out of MONITOR/MWAIT.
+    wake: AtomicU32,
+
+    /// True while this CPU is parked in MONITOR/MWAIT on `wake`, meaning
+    /// a store to `wake` is sufficient to wake it (no IPI needed).
+    in_mwait: AtomicBool,
+}
+
+impl CpuIdleState {
+    const fn new() -> Self {
+        Self {
+            wake: AtomicU32::new(0),
+            in_mwait: AtomicBool::new(false),
+        }
+    }
+}
+
+/// Initializer for the per-CPU array (const so it can be repeated).
+const IDLE_STATE_INIT: CpuIdleState = CpuIdleState::new();
+
+/// Per-CPU idle states
+static IDLE_STATES: [CpuIdleState; percpu::SMP_MAX_CPUS] =
+    [IDLE_STATE_INIT; percpu::SMP_MAX_CPUS];
+
+/// ============================================================================
+/// Public API
+/// ============================================================================
+
+/// Idle the current CPU until something wakes it.
+///
+/// Selects an idle depth from the predicted sleep duration, then waits:
+/// via MONITOR/MWAIT on the per-CPU wake word on x86 (woken by either a
+/// remote store from try_wake_cpu() or an interrupt), via `wfi` elsewhere.
+pub fn cpu_idle() {
+    // An idle CPU is the cheapest place to retire exited threads: drain
+    // the reaper's pending work before sleeping so their stacks are back
+    // in the cache by the time anything wants to spawn.
+    if thread::reaper::reaper_pending() > 0 {
+        thread::reaper::reap_all();
+    }
+
+    let state = idle_state_for_sleep(predicted_sleep_ns());
+
+    mp::mp_prepare_current_cpu_idle_state(true);
+
+    #[cfg(target_arch = "x86_64")]
+    {
+        use crate::kernel::arch::amd64::ops;
+
+        let cpu = percpu::current_cpu_num() as usize;
+        let idle = &IDLE_STATES[cpu];
+
+        if ops::x86_has_mwait() {
+            // Advertise the mwait fast-wake path before arming the monitor
+            // so a remote CPU that sees in_mwait == true is guaranteed its
+            // store lands on a monitored line (or is caught by the recheck
+            // below).
+            idle.in_mwait.store(true, Ordering::Release);
+
+            unsafe {
+                ops::x86_monitor(idle.wake.as_ptr(), 0, 0);
+            }
+
+            // Recheck after arming the monitor: a wake that raced with the
+            // stores above must not be slept through.
+            if idle.wake.swap(0, Ordering::Acquire) == 0 {
+                unsafe {
+                    ops::x86_mwait(idle.wake.as_ptr(), 0, state.mwait_hint());
+                }
+            }
+
+            idle.in_mwait.store(false, Ordering::Release);
+            idle.wake.store(0, Ordering::Release);
+        } else {
+            // No MONITOR/MWAIT: halt until the next interrupt.
+            let _ = state;
+            ops::x86_idle();
+        }
+    }
+
+    #[cfg(target_arch = "aarch64")]
+    {
+        // wfi has a single depth; deeper states go through PSCI, which the
+        // platform layer doesn't drive yet.
+        let _ = state;
+        unsafe {
+            core::arch::asm!("wfi");
+        }
+    }
+
+    #[cfg(target_arch = "riscv64")]
+    {
+        let _ = state;
+        unsafe {
+            core::arch::asm!("wfi");
+        }
+    }
+
+    mp::mp_prepare_current_cpu_idle_state(false);
+}
+
+/// Try to wake an idle CPU without an IPI.
+///
+/// If the target CPU is parked in MONITOR/MWAIT, write its wake word -
+/// the store hits the monitored line and brings the CPU out of idle.
+///
+/// # Returns
+///
+/// true if the CPU was woken by the store and no IPI is needed,
+/// false if the caller must fall back to an IPI.
+pub fn try_wake_cpu(cpu: u32) -> bool {
+    if cpu as usize >= percpu::SMP_MAX_CPUS {
+        return false;
+    }
+
+    let idle = &IDLE_STATES[cpu as usize];
+
+    // Set the wake word first: if the target is between arming its monitor
+    // and mwaiting, its recheck observes this store.
+    idle.wake.store(1, Ordering::Release);
+
+    idle.in_mwait.load(Ordering::Acquire)
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_idle_state_for_sleep() {
+        assert_eq!(idle_state_for_sleep(0), IdleState::C1);
+        assert_eq!(idle_state_for_sleep(IDLE_C2_THRESHOLD_NS - 1), IdleState::C1);
+        assert_eq!(idle_state_for_sleep(IDLE_C2_THRESHOLD_NS), IdleState::C2);
+        assert_eq!(idle_state_for_sleep(IDLE_C3_THRESHOLD_NS - 1), IdleState::C2);
+        assert_eq!(idle_state_for_sleep(IDLE_C3_THRESHOLD_NS), IdleState::C3);
+        assert_eq!(idle_state_for_sleep(u64::MAX), IdleState::C3);
+    }
+
+    #[test]
+    fn test_mwait_hints() {
+        assert_eq!(IdleState::C1.mwait_hint(), 0x00);
+        assert_eq!(IdleState::C2.mwait_hint(), 0x10);
+        assert_eq!(IdleState::C3.mwait_hint(), 0x20);
+    }
+
+    #[test]
+    fn test_try_wake_cpu_not_idle() {
+        // A CPU that is not parked in mwait still needs an IPI.
+        assert!(!try_wake_cpu(5));
+
+        // Out-of-range CPUs are rejected.
+        assert!(!try_wake_cpu(percpu::SMP_MAX_CPUS as u32));
+    }
+}
@@ -19,6 +19,9 @@ use core::fmt;
 
 /// Console module
 pub mod console {
+    use alloc::collections::BTreeMap;
+    use spin::Mutex;
+
     /// Write a single character to the console
     pub fn putchar(c: u8) {
         // Placeholder - would write to serial console
@@ -31,6 +34,52 @@ pub mod console {
             putchar(byte);
         }
     }
+
+    /// Command function type
+    pub type CmdFunc = fn(argc: usize, argv: &[CmdArg], flags: u32) -> i32;
+
+    /// Command argument
+    #[repr(C)]
+    #[derive(Debug, Clone, Copy)]
+    pub struct CmdArg {
+        /// String argument
+        pub str: &'static str,
+        /// Unsigned integer argument
+        pub u: u64,
+        /// Signed integer argument
+        pub i: i64,
+        /// Float argument
+        pub f: f64,
+        /// Boolean argument
+        pub b: bool,
+    }
+
+    /// Command descriptor
+    #[repr(C)]
+    #[derive(Debug, Clone)]
+    pub struct Cmd {
+        /// Command name
+        pub name: &'static str,
+        /// Help string
+        pub help: &'static str,
+        /// Command function
+        pub func: Option<CmdFunc>,
+        /// Availability flags
+        pub flags: u32,
+    }
+
+    /// Registered commands
+    static COMMANDS: Mutex<BTreeMap<&'static str, Cmd>> = Mutex::new(BTreeMap::new());
+
+    /// Register a command
+    pub fn register_command(cmd: Cmd) {
+        COMMANDS.lock().insert(cmd.name, cmd);
+    }
+
+    /// Unregister a command
+    pub fn unregister_command(name: &str) {
+        COMMANDS.lock().remove(name);
+    }
 }
 
 /// String module
@@ -193,6 +242,9 @@ pub mod thread_lock {
 
 /// Heap allocation module
 pub mod heap {
+    /// Compact malloc implementation
+    pub mod cmpctmalloc;
+
     use alloc::alloc::{GlobalAlloc, Layout};
 
     /// Stub heap allocator
@@ -288,6 +340,38 @@ pub mod rx_internal {
     }
 }
 
+// File-backed library modules living under `lib/`
+
+/// Raw and run-length-encoded bitmaps
+pub mod bitmap;
+
+/// Graphics surface primitives
+pub mod gfx;
+
+/// Graphics console on top of `gfx`
+pub mod gfxconsole;
+
+/// Lock dependency tracking and validation
+pub mod lockdep;
+
+/// Cryptographically secure PRNG (global and per-CPU states)
+pub mod prng;
+
+/// Power-of-two aligned range allocator
+pub mod pow2_range_allocator;
+
+/// Region allocator for address-range bookkeeping
+pub mod region_alloc;
+
+/// System topology (NUMA/SMP) representation
+pub mod topology;
+
+/// First user-space process bootstrap
+pub mod userboot;
+
+/// Boot image (ZBI) item processing
+pub mod zbi;
+
 // Re-export commonly used functions and modules
 pub use console::*;
 pub use string::*;
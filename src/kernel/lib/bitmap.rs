@@ -0,0 +1,546 @@
+// Copyright 2025 The Rustux Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+//! Raw Bitmap
+//!
+//! This module provides the raw bitmap used by range allocators and
+//! gap-finding paths (pow2 range carving, contiguous-page searches over
+//! PMM arenas).
+//!
+//! Scans work on whole 64-bit words and skip uniform stretches four
+//! words (256 bits) at a time, so a multi-MB bitmap is never walked bit
+//! by bit. For the really large arenas an optional two-level summary
+//! tracks, per 4096-bit block, whether the block contains any set or
+//! any clear bit; find-run then jumps straight to the first block that
+//! can possibly hold a run start instead of scanning the uniform
+//! prefix.
+
+#![no_std]
+
+extern crate alloc;
+
+use alloc::vec::Vec;
+
+use crate::rustux::types::*;
+use crate::rustux::types::err::*;
+
+/// Bits per storage word
+const WORD_BITS: usize = 64;
+
+/// Words folded per skip step in the scan inner loop
+const SCAN_FOLD_WORDS: usize = 4;
+
+/// Data bits covered by one level-1 summary bit (64 words)
+const SUMMARY_BLOCK_BITS: usize = WORD_BITS * WORD_BITS;
+
+/// Two-level summary of a bitmap
+///
+/// Level 1 holds two bits of state per 4096-bit data block: whether the
+/// block contains at least one set bit and whether it contains at least
+/// one clear bit. Level 2 summarizes each word of level 1 the same way.
+/// A find over an N-bit bitmap therefore inspects O(N / 4096^2) level-2
+/// words, one level-1 word, and one data block before it touches data,
+/// instead of scanning linearly from the start offset.
+struct BitmapSummary {
+    /// Level 1: bit per data block that has at least one set bit
+    set_l1: Vec<u64>,
+    /// Level 1: bit per data block that has at least one clear bit
+    clear_l1: Vec<u64>,
+    /// Level 2: bit per level-1 word with any set_l1 bit
+    set_l2: Vec<u64>,
+    /// Level 2: bit per level-1 word with any clear_l1 bit
+    clear_l2: Vec<u64>,
+}
+
+impl BitmapSummary {
+    /// Create a summary covering `size` data bits, all clear
+    fn new(size: usize) -> Self {
+        let blocks = (size + SUMMARY_BLOCK_BITS - 1) / SUMMARY_BLOCK_BITS;
+        let l1_words = (blocks + WORD_BITS - 1) / WORD_BITS;
+        let l2_words = (l1_words + WORD_BITS - 1) / WORD_BITS;
+
+        let mut summary = Self {
+            set_l1: alloc::vec![0; l1_words],
+            clear_l1: alloc::vec![0; l1_words],
+            set_l2: alloc::vec![0; l2_words],
+            clear_l2: alloc::vec![0; l2_words],
+        };
+
+        // An all-clear bitmap has a clear bit in every block.
+        for block in 0..blocks {
+            summary.record(block, false, true);
+        }
+        summary
+    }
+
+    /// Record the (has_set, has_clear) state of one data block
+    fn record(&mut self, block: usize, has_set: bool, has_clear: bool) {
+        let l1_word = block / WORD_BITS;
+        let l1_bit = 1u64 << (block % WORD_BITS);
+        let l2_bit = 1u64 << (l1_word % WORD_BITS);
+
+        if has_set {
+            self.set_l1[l1_word] |= l1_bit;
+        } else {
+            self.set_l1[l1_word] &= !l1_bit;
+        }
+        if has_clear {
+            self.clear_l1[l1_word] |= l1_bit;
+        } else {
+            self.clear_l1[l1_word] &= !l1_bit;
+        }
+
+        if self.set_l1[l1_word] != 0 {
+            self.set_l2[l1_word / WORD_BITS] |= l2_bit;
+        } else {
+            self.set_l2[l1_word / WORD_BITS] &= !l2_bit;
+        }
+        if self.clear_l1[l1_word] != 0 {
+            self.clear_l2[l1_word / WORD_BITS] |= l2_bit;
+        } else {
+            self.clear_l2[l1_word / WORD_BITS] &= !l2_bit;
+        }
+    }
+
+    /// Find the first block >= `from_block` that can contain a bit in
+    /// the wanted state
+    fn next_candidate_block(&self, is_set: bool, from_block: usize) -> Option<usize> {
+        let (l1, l2) = if is_set {
+            (&self.set_l1, &self.set_l2)
+        } else {
+            (&self.clear_l1, &self.clear_l2)
+        };
+
+        let mut l1_word = from_block / WORD_BITS;
+        if l1_word >= l1.len() {
+            return None;
+        }
+
+        // Bits below from_block in the first level-1 word don't count.
+        let mut masked = l1[l1_word] & (!0u64 << (from_block % WORD_BITS));
+        loop {
+            if masked != 0 {
+                let block = l1_word * WORD_BITS + masked.trailing_zeros() as usize;
+                return Some(block);
+            }
+
+            // Jump via level 2 to the next interesting level-1 word.
+            let mut l2_word = (l1_word + 1) / WORD_BITS;
+            if l2_word >= l2.len() {
+                return None;
+            }
+            let mut l2_masked = l2[l2_word] & (!0u64 << ((l1_word + 1) % WORD_BITS));
+            while l2_masked == 0 {
+                l2_word += 1;
+                if l2_word >= l2.len() {
+                    return None;
+                }
+                l2_masked = l2[l2_word];
+            }
+            l1_word = l2_word * WORD_BITS + l2_masked.trailing_zeros() as usize;
+            masked = l1[l1_word];
+        }
+    }
+}
+
+/// Raw bitmap over heap-backed word storage
+pub struct RawBitmap {
+    /// Storage words; bits beyond `size` in the last word stay clear
+    words: Vec<u64>,
+    /// Size in bits
+    size: usize,
+    /// Optional two-level summary for O(log) find over large bitmaps
+    summary: Option<BitmapSummary>,
+}
+
+impl RawBitmap {
+    /// Create a new bitmap with all bits clear
+    ///
+    /// # Arguments
+    ///
+    /// * `size` - Size in bits
+    pub fn new(size: usize) -> Self {
+        Self {
+            words: alloc::vec![0; (size + WORD_BITS - 1) / WORD_BITS],
+            size,
+            summary: None,
+        }
+    }
+
+    /// Create a new bitmap with a two-level summary
+    ///
+    /// Worth the extra (size / 2048) bits of bookkeeping for multi-MB
+    /// bitmaps where find() would otherwise scan long uniform runs;
+    /// pointless for small ones.
+    pub fn new_with_summary(size: usize) -> Self {
+        let mut bitmap = Self::new(size);
+        bitmap.summary = Some(BitmapSummary::new(size));
+        bitmap
+    }
+
+    /// Get the size in bits
+    pub fn size(&self) -> usize {
+        self.size
+    }
+
+    /// Get one bit
+    pub fn get_one(&self, bit: usize) -> bool {
+        debug_assert!(bit < self.size);
+        self.words[bit / WORD_BITS] & (1u64 << (bit % WORD_BITS)) != 0
+    }
+
+    /// Set one bit
+    pub fn set_one(&mut self, bit: usize) {
+        self.set(bit, bit + 1);
+    }
+
+    /// Clear one bit
+    pub fn clear_one(&mut self, bit: usize) {
+        self.clear(bit, bit + 1);
+    }
+
+    /// Set all bits in [bitoff, bitmax)
+    pub fn set(&mut self, bitoff: usize, bitmax: usize) {
+        debug_assert!(bitoff <= bitmax && bitmax <= self.size);
+        self.fill(bitoff, bitmax, true);
+    }
+
+    /// Clear all bits in [bitoff, bitmax)
+    pub fn clear(&mut self, bitoff: usize, bitmax: usize) {
+        debug_assert!(bitoff <= bitmax && bitmax <= self.size);
+        self.fill(bitoff, bitmax, false);
+    }
+
+    /// Clear the whole bitmap
+    pub fn reset(&mut self) {
+        self.fill(0, self.size, false);
+    }
+
+    /// Check whether every bit in [bitoff, bitmax) matches `is_set`
+    ///
+    /// Returns the offset of the first mismatching bit, or None when
+    /// the whole range matches.
+    pub fn scan(&self, bitoff: usize, bitmax: usize, is_set: bool) -> Option<usize> {
+        debug_assert!(bitoff <= bitmax && bitmax <= self.size);
+        let mismatch = self.next_bit(!is_set, bitoff, bitmax);
+        mismatch.filter(|&bit| bit < bitmax)
+    }
+
+    /// Find the first run of `run_len` bits in state `is_set`
+    ///
+    /// # Arguments
+    ///
+    /// * `is_set` - Whether to look for set or clear bits
+    /// * `bitoff` - First bit to consider
+    /// * `bitmax` - One past the last bit to consider
+    /// * `run_len` - Required run length
+    ///
+    /// # Returns
+    ///
+    /// Ok(offset of the run's first bit) on success, or
+    /// RX_ERR_NO_RESOURCES when no such run exists in the range
+    pub fn find(
+        &self,
+        is_set: bool,
+        bitoff: usize,
+        bitmax: usize,
+        run_len: usize,
+    ) -> Result<usize> {
+        if run_len == 0 || bitoff > bitmax || bitmax > self.size {
+            return Err(RX_ERR_INVALID_ARGS);
+        }
+
+        let mut pos = bitoff;
+        while pos + run_len <= bitmax {
+            // Jump to the next candidate bit; the summary (when
+            // present) skips whole uniform blocks here.
+            let start = match self.next_bit(is_set, pos, bitmax) {
+                Some(start) if start + run_len <= bitmax => start,
+                _ => break,
+            };
+
+            // The run ends at the next bit in the opposite state.
+            match self.next_bit(!is_set, start + 1, start + run_len) {
+                None => return Ok(start),
+                Some(mismatch) => pos = mismatch + 1,
+            }
+        }
+
+        Err(RX_ERR_NO_RESOURCES)
+    }
+
+    /// Find the next bit in state `is_set` in [from, limit) (internal)
+    ///
+    /// The hot loop folds four words at a time: a uniform 256-bit
+    /// stretch costs one OR/AND reduction and no per-bit work, which
+    /// the compiler lowers to wide vector loads on targets that have
+    /// them.
+    fn next_bit(&self, is_set: bool, from: usize, limit: usize) -> Option<usize> {
+        if from >= limit {
+            return None;
+        }
+
+        let mut word_ix = from / WORD_BITS;
+        let last_word = (limit - 1) / WORD_BITS;
+
+        // With a summary, jump over blocks that can't contain the bit.
+        if let Some(summary) = &self.summary {
+            let block = summary.next_candidate_block(is_set, from / SUMMARY_BLOCK_BITS)?;
+            let block_word = block * (SUMMARY_BLOCK_BITS / WORD_BITS);
+            if block_word > word_ix {
+                word_ix = block_word;
+            }
+            if word_ix > last_word {
+                return None;
+            }
+        }
+
+        // xor_mask turns the search into "find the next set bit".
+        let xor_mask = if is_set { 0u64 } else { !0u64 };
+
+        // Head: mask off bits below `from` in the first word.
+        let mut masked = (self.words[word_ix] ^ xor_mask)
+            & if word_ix == from / WORD_BITS {
+                !0u64 << (from % WORD_BITS)
+            } else {
+                !0u64
+            };
+
+        while masked == 0 {
+            word_ix += 1;
+
+            // Skip uniform stretches four words at a time.
+            while word_ix + SCAN_FOLD_WORDS <= last_word + 1 {
+                let fold = (self.words[word_ix] ^ xor_mask)
+                    | (self.words[word_ix + 1] ^ xor_mask)
+                    | (self.words[word_ix + 2] ^ xor_mask)
+                    | (self.words[word_ix + 3] ^ xor_mask);
+                if fold != 0 {
+                    break;
+                }
+                word_ix += SCAN_FOLD_WORDS;
+            }
+
+            if word_ix > last_word {
+                return None;
+            }
+            masked = self.words[word_ix] ^ xor_mask;
+        }
+
+        let bit = word_ix * WORD_BITS + masked.trailing_zeros() as usize;
+        // Clear bits past `size` exist in the last word; a search for
+        // clear bits must not report them.
+        if bit >= limit || bit >= self.size {
+            None
+        } else {
+            Some(bit)
+        }
+    }
+
+    /// Set or clear all bits in [bitoff, bitmax) (internal)
+    fn fill(&mut self, bitoff: usize, bitmax: usize, value: bool) {
+        if bitoff >= bitmax {
+            return;
+        }
+
+        let first_word = bitoff / WORD_BITS;
+        let last_word = (bitmax - 1) / WORD_BITS;
+
+        let head_mask = !0u64 << (bitoff % WORD_BITS);
+        let tail_mask = !0u64 >> (WORD_BITS - 1 - (bitmax - 1) % WORD_BITS);
+
+        for word_ix in first_word..=last_word {
+            let mut mask = !0u64;
+            if word_ix == first_word {
+                mask &= head_mask;
+            }
+            if word_ix == last_word {
+                mask &= tail_mask;
+            }
+            if value {
+                self.words[word_ix] |= mask;
+            } else {
+                self.words[word_ix] &= !mask;
+            }
+        }
+
+        self.update_summary(bitoff, bitmax);
+    }
+
+    /// Recompute summary state for the blocks touching [bitoff, bitmax)
+    /// (internal)
+    fn update_summary(&mut self, bitoff: usize, bitmax: usize) {
+        if self.summary.is_none() {
+            return;
+        }
+
+        let first_block = bitoff / SUMMARY_BLOCK_BITS;
+        let last_block = (bitmax - 1) / SUMMARY_BLOCK_BITS;
+
+        for block in first_block..=last_block {
+            let word_lo = block * (SUMMARY_BLOCK_BITS / WORD_BITS);
+            let word_hi = (word_lo + SUMMARY_BLOCK_BITS / WORD_BITS).min(self.words.len());
+
+            let mut any_set = 0u64;
+            let mut all_set = !0u64;
+            for word in &self.words[word_lo..word_hi] {
+                any_set |= word;
+                all_set &= word;
+            }
+
+            // The last block may cover bits past `size`; those are
+            // always stored clear and must not count as clear bits.
+            let block_bits = (self.size - block * SUMMARY_BLOCK_BITS).min(SUMMARY_BLOCK_BITS);
+            let full_block = block_bits == SUMMARY_BLOCK_BITS
+                && word_hi - word_lo == SUMMARY_BLOCK_BITS / WORD_BITS;
+            let has_clear = if full_block {
+                all_set != !0u64
+            } else {
+                self.scan_partial_clear(block * SUMMARY_BLOCK_BITS, block_bits)
+            };
+
+            if let Some(summary) = &mut self.summary {
+                summary.record(block, any_set != 0, has_clear);
+            }
+        }
+    }
+
+    /// Check a partial trailing block for any clear in-range bit
+    /// (internal)
+    fn scan_partial_clear(&self, block_start: usize, block_bits: usize) -> bool {
+        let limit = block_start + block_bits;
+        for bit in (block_start..limit).step_by(WORD_BITS) {
+            let word = self.words[bit / WORD_BITS];
+            let valid = (limit - bit).min(WORD_BITS);
+            let mask = if valid == WORD_BITS {
+                !0u64
+            } else {
+                (1u64 << valid) - 1
+            };
+            if word & mask != mask {
+                return true;
+            }
+        }
+        false
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_set_get_clear() {
+        let mut bm = RawBitmap::new(200);
+
+        assert!(!bm.get_one(100));
+        bm.set_one(100);
+        assert!(bm.get_one(100));
+        bm.clear_one(100);
+        assert!(!bm.get_one(100));
+    }
+
+    #[test]
+    fn test_range_fill_crosses_words() {
+        let mut bm = RawBitmap::new(256);
+        bm.set(60, 70);
+
+        assert!(!bm.get_one(59));
+        for bit in 60..70 {
+            assert!(bm.get_one(bit));
+        }
+        assert!(!bm.get_one(70));
+
+        bm.clear(62, 68);
+        assert!(bm.get_one(61));
+        assert!(!bm.get_one(62));
+        assert!(bm.get_one(68));
+    }
+
+    #[test]
+    fn test_scan() {
+        let mut bm = RawBitmap::new(512);
+        bm.set(0, 512);
+
+        assert_eq!(bm.scan(0, 512, true), None);
+        bm.clear_one(300);
+        assert_eq!(bm.scan(0, 512, true), Some(300));
+        assert_eq!(bm.scan(0, 300, true), None);
+    }
+
+    #[test]
+    fn test_find_run() {
+        let mut bm = RawBitmap::new(1024);
+        bm.set(0, 1024);
+        bm.clear(100, 110);
+        bm.clear(500, 540);
+
+        // The first clear run is too short for 20 bits; the second fits.
+        assert_eq!(bm.find(false, 0, 1024, 10), Ok(100));
+        assert_eq!(bm.find(false, 0, 1024, 20), Ok(500));
+        assert_eq!(bm.find(false, 0, 1024, 41), Err(RX_ERR_NO_RESOURCES));
+        // A set-run search starting inside the first clear gap lands on
+        // the run between the gaps.
+        assert_eq!(bm.find(true, 100, 1024, 64), Ok(110));
+    }
+
+    #[test]
+    fn test_find_invalid_args() {
+        let bm = RawBitmap::new(64);
+        assert_eq!(bm.find(false, 0, 64, 0), Err(RX_ERR_INVALID_ARGS));
+        assert_eq!(bm.find(false, 0, 65, 1), Err(RX_ERR_INVALID_ARGS));
+        assert_eq!(bm.find(false, 32, 16, 1), Err(RX_ERR_INVALID_ARGS));
+    }
+
+    #[test]
+    fn test_summary_matches_plain() {
+        let mut plain = RawBitmap::new(3 * SUMMARY_BLOCK_BITS + 100);
+        let mut summarized = RawBitmap::new_with_summary(3 * SUMMARY_BLOCK_BITS + 100);
+
+        for bm in [&mut plain, &mut summarized] {
+            bm.set(0, bm.size());
+            bm.clear(SUMMARY_BLOCK_BITS + 17, SUMMARY_BLOCK_BITS + 50);
+            bm.clear(2 * SUMMARY_BLOCK_BITS, 2 * SUMMARY_BLOCK_BITS + 200);
+        }
+
+        for run in [1, 33, 34, 200, 201] {
+            assert_eq!(
+                plain.find(false, 0, plain.size(), run),
+                summarized.find(false, 0, summarized.size(), run),
+                "run={}",
+                run
+            );
+        }
+        assert_eq!(
+            plain.find(true, 0, plain.size(), SUMMARY_BLOCK_BITS),
+            summarized.find(true, 0, summarized.size(), SUMMARY_BLOCK_BITS),
+        );
+    }
+
+    #[test]
+    fn test_summary_skips_uniform_prefix() {
+        // All-set bitmap with one clear run near the end; the summary
+        // must route find() straight to the right block.
+        let size = 16 * SUMMARY_BLOCK_BITS;
+        let mut bm = RawBitmap::new_with_summary(size);
+        bm.set(0, size);
+        bm.clear(size - 100, size - 40);
+
+        assert_eq!(bm.find(false, 0, size, 60), Ok(size - 100));
+        assert_eq!(bm.find(false, 0, size, 61), Err(RX_ERR_NO_RESOURCES));
+    }
+
+    #[test]
+    fn test_trailing_partial_word() {
+        // Bits past `size` are stored clear but must never be reported.
+        let mut bm = RawBitmap::new_with_summary(70);
+        bm.set(0, 70);
+
+        assert_eq!(bm.find(false, 0, 70, 1), Err(RX_ERR_NO_RESOURCES));
+        bm.clear_one(69);
+        assert_eq!(bm.find(false, 0, 70, 1), Ok(69));
+    }
+}
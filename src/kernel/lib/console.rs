@@ -12,11 +12,11 @@
 
 extern crate alloc;
 
-use alloc::collections::BTreeMap;
+use alloc::collections::{BTreeMap, VecDeque};
 use alloc::format;
 use alloc::string::{String, ToString};
 use alloc::vec::Vec;
-use core::sync::atomic::{AtomicBool, Ordering};
+use core::sync::atomic::{AtomicBool, AtomicU64, Ordering};
 use spin::Mutex;
 
 use crate::rustux::types::*;
@@ -222,6 +222,112 @@ pub fn exec_command(line: &str) -> i32 {
     }
 }
 
+/// ============================================================================
+/// Deferred Command Execution
+/// ============================================================================
+
+/// Maximum number of queued commands
+///
+/// Console input is human-paced; a deep queue only means a wall of
+/// stale output later, so keep it shallow and drop with a warning.
+const DEFERRED_QUEUE_DEPTH: usize = 8;
+
+/// Commands waiting for the worker
+static PENDING_COMMANDS: Mutex<VecDeque<String>> = Mutex::new(VecDeque::new());
+
+/// Commands dropped because the queue was full
+static DROPPED_COMMANDS: AtomicU64 = AtomicU64::new(0);
+
+/// Whether the dedicated worker thread is running
+static WORKER_RUNNING: AtomicBool = AtomicBool::new(false);
+
+/// Queue a command line for deferred execution
+///
+/// Safe to call from the UART receive path: it only takes the short
+/// queue lock and never runs the command, so a heavy dump can't stall
+/// interrupt servicing. Returns false if the queue was full and the
+/// command was dropped.
+pub fn exec_command_async(line: &str) -> bool {
+    let mut pending = PENDING_COMMANDS.lock();
+    if pending.len() >= DEFERRED_QUEUE_DEPTH {
+        drop(pending);
+        DROPPED_COMMANDS.fetch_add(1, Ordering::Relaxed);
+        println!("console: command queue full, dropped '{}'", line);
+        return false;
+    }
+    pending.push_back(String::from(line));
+    true
+}
+
+/// Run every queued command
+///
+/// Called by the worker loop, or directly from any thread context when
+/// no worker is running. Returns the number of commands executed.
+pub fn console_worker_pump() -> usize {
+    let mut ran = 0;
+    loop {
+        // Pop outside exec_command so a command that queues more work
+        // (scripts) doesn't deadlock on the queue lock.
+        let line = PENDING_COMMANDS.lock().pop_front();
+        match line {
+            Some(line) => {
+                exec_command(&line);
+                ran += 1;
+            }
+            None => break,
+        }
+    }
+    ran
+}
+
+/// Dedicated worker thread entry point
+///
+/// Drains the command queue forever, yielding between polls so the
+/// worker costs nothing while the console is quiet.
+extern "C" fn console_worker_entry(_arg: usize) -> ! {
+    loop {
+        if console_worker_pump() == 0 {
+            crate::kernel::thread::Thread::yield_current();
+        }
+    }
+}
+
+/// Start the dedicated console worker thread
+///
+/// Until this runs (or if thread creation fails), exec_command_async
+/// callers should fall back to console_worker_pump from a safe
+/// context.
+pub fn console_start_worker() {
+    if WORKER_RUNNING.swap(true, Ordering::AcqRel) {
+        return;
+    }
+
+    match crate::kernel::thread::Thread::new_kernel(
+        console_worker_entry,
+        0,
+        crate::kernel::thread::PRIORITY_DEFAULT,
+    ) {
+        Ok(thread) => {
+            thread.set_name("console-worker");
+            if thread.start().is_err() {
+                WORKER_RUNNING.store(false, Ordering::Release);
+                println!("console: failed to start worker thread");
+                return;
+            }
+            crate::kernel::thread::register_thread(alloc::sync::Arc::new(thread));
+        }
+        Err(_) => {
+            WORKER_RUNNING.store(false, Ordering::Release);
+            println!("console: failed to create worker thread");
+        }
+    }
+}
+
+/// Check whether the dedicated worker is running
+pub fn console_worker_running() -> bool {
+    WORKER_RUNNING.load(Ordering::Acquire)
+}
+
 /// Initialize the console subsystem
 pub fn console_init() {
     #[cfg(CONSOLE_ENABLE_HISTORY)]
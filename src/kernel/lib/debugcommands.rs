@@ -381,6 +381,61 @@ fn cmd_cmdline(_argc: usize, _argv: &[CmdArg], _flags: u32) -> i32 {
     0
 }
 
+/// Default number of threads printed per page
+const THREADS_PAGE_SIZE: usize = 16;
+
+/// Paginated thread dump command implementation
+///
+/// `threads [after_tid] [count]` prints one page of the thread
+/// registry and the continuation token for the next page, so dumping
+/// thousands of threads never monopolizes the console worker or the
+/// registry lock.
+fn cmd_threads(argc: usize, argv: &[CmdArg], _flags: u32) -> i32 {
+    let after = if argc >= 2 { argv[1].u } else { 0 };
+    let count = if argc >= 3 && argv[2].u != 0 {
+        argv[2].u as usize
+    } else {
+        THREADS_PAGE_SIZE
+    };
+
+    let page = crate::kernel::thread::threads_page(after, count);
+    let total = crate::kernel::thread::thread_count();
+
+    println!("{} threads total:", total);
+    println!("  {:>8} {:>12} {:>4} name", "tid", "state", "pri");
+    for thread in &page {
+        println!(
+            "  {:>8} {:>12?} {:>4} {}",
+            thread.tid(),
+            thread.state(),
+            thread.priority(),
+            thread.name().unwrap_or("<unnamed>")
+        );
+    }
+
+    if page.len() == count {
+        if let Some(last) = page.last() {
+            println!("more: threads {}", last.tid());
+        }
+    }
+
+    0
+}
+
+/// PMM summary command implementation
+fn cmd_pmm(_argc: usize, _argv: &[CmdArg], _flags: u32) -> i32 {
+    let free = crate::kernel::pmm::pmm_count_free_pages();
+    let total = crate::kernel::pmm::pmm_count_total_pages();
+    let bytes = crate::kernel::pmm::pmm_count_total_bytes();
+
+    println!("PMM state:");
+    println!("  total: {} pages ({} bytes)", total, bytes);
+    println!("  free:  {} pages", free);
+    println!("  used:  {} pages", total.saturating_sub(free));
+
+    0
+}
+
 /// Register all debug commands
 pub fn debugcommands_register() {
     // Display memory commands
@@ -494,6 +549,20 @@ pub fn debugcommands_register() {
         func: Some(cmd_cmdline),
         flags: 0,
     });
+
+    // Paginated / summary dumps
+    register_command(Cmd {
+        name: "threads",
+        help: "dump threads, one page at a time: threads [after_tid] [count]",
+        func: Some(cmd_threads),
+        flags: 0,
+    });
+    register_command(Cmd {
+        name: "pmm",
+        help: "display physical memory summary",
+        func: Some(cmd_pmm),
+        flags: 0,
+    });
 }
 
 #[cfg(test)]
@@ -21,7 +21,7 @@ use core::sync::atomic::{AtomicBool, AtomicU32, AtomicU8, Ordering};
 use spin::Mutex;
 
 use crate::rustux::types::*;
-use crate::kernel::lib::gfx::{GfxFont, GfxSurface};
+use crate::kernel::lib::gfx::{gfx_blit_rows, gfx_putchar, GfxFont, GfxSurface};
 
 /// Default text color (white)
 pub const TEXT_COLOR: u32 = 0xFFFFFFFF;
@@ -42,6 +42,44 @@ pub enum ConsoleState {
     Escape,
 }
 
+/// Damaged pixel-row band awaiting a flush
+///
+/// Drawing only touches the software back buffer and widens this band;
+/// `flush()` blits just the damaged rows to the hardware surface in one
+/// batch. At 4K that turns a whole-surface copy per scrolled line into
+/// one copy of the rows that actually changed.
+#[derive(Debug)]
+struct Damage {
+    /// First damaged pixel row
+    y0: u32,
+    /// Last damaged pixel row
+    y1: u32,
+    /// Whether any row is damaged
+    dirty: bool,
+}
+
+impl Damage {
+    const fn new() -> Self {
+        Self { y0: 0, y1: 0, dirty: false }
+    }
+
+    /// Widen the band to include pixel rows `[y0, y1]`
+    fn add(&mut self, y0: u32, y1: u32) {
+        if self.dirty {
+            self.y0 = self.y0.min(y0);
+            self.y1 = self.y1.max(y1);
+        } else {
+            self.y0 = y0;
+            self.y1 = y1;
+            self.dirty = true;
+        }
+    }
+
+    fn reset(&mut self) {
+        self.dirty = false;
+    }
+}
+
 /// Graphics console state
 pub struct GfxConsole {
     /// Main surface to draw on
@@ -68,6 +106,8 @@ pub struct GfxConsole {
     pub state: Mutex<ConsoleState>,
     /// Escape sequence parameter
     pub escape_param: Mutex<u32>,
+    /// Pixel rows drawn since the last flush
+    damage: Mutex<Damage>,
 }
 
 unsafe impl Send for GfxConsole {}
@@ -93,6 +133,7 @@ impl GfxConsole {
             back_color: AtomicU32::new(BACK_COLOR),
             state: Mutex::new(ConsoleState::Normal),
             escape_param: Mutex::new(0),
+            damage: Mutex::new(Damage::new()),
         }
     }
 
@@ -148,9 +189,10 @@ impl GfxConsole {
         // Fill screen with background color
         if let Some(surface) = self.surface {
             unsafe {
-                if let Some(s) = surface.as_ref() {
-                    // TODO: Implement fillrect
-                    let _ = (s, crash_console);
+                if let Some(s) = surface.as_mut() {
+                    let back = self.back_color.load(Ordering::Acquire);
+                    s.fillrect(0, 0, s.width, s.height, back);
+                    self.damage.lock().add(0, s.height.saturating_sub(1));
                 }
             }
         }
@@ -201,7 +243,9 @@ impl GfxConsole {
                 _ => {
                     self.draw_char(c as u8);
                     let x = self.x.fetch_add(1, Ordering::AcqRel);
-                    if x + 1 >= self.columns {
+                    // A console with no surface bound has zero columns;
+                    // don't treat that as wrapping on every character.
+                    if self.columns != 0 && x + 1 >= self.columns {
                         self.x.store(0, Ordering::Release);
                         let y = self.y.fetch_add(1, Ordering::AcqRel);
                         if y + 1 >= self.rows {
@@ -225,7 +269,9 @@ impl GfxConsole {
                 } else {
                     self.draw_char(c as u8);
                     let x = self.x.fetch_add(1, Ordering::AcqRel);
-                    if x + 1 >= self.columns {
+                    // A console with no surface bound has zero columns;
+                    // don't treat that as wrapping on every character.
+                    if self.columns != 0 && x + 1 >= self.columns {
                         self.x.store(0, Ordering::Release);
                         let y = self.y.fetch_add(1, Ordering::AcqRel);
                         if y + 1 >= self.rows {
@@ -237,9 +283,9 @@ impl GfxConsole {
             }
         }
 
-        // Handle scrolling
+        // Handle scrolling (zero rows means no surface is bound yet)
         let y = self.y.load(Ordering::Acquire);
-        if y >= self.rows {
+        if self.rows != 0 && y >= self.rows {
             self.scroll_up();
         }
 
@@ -247,6 +293,9 @@ impl GfxConsole {
     }
 
     /// Draw a character at current cursor position
+    ///
+    /// Draws into the back buffer only; the glyph's pixel rows join the
+    /// damage band and reach the hardware surface on the next flush.
     fn draw_char(&self, c: u8) {
         if let (Some(surface), Some(font)) = (self.surface, self.font) {
             let x = self.x.load(Ordering::Acquire);
@@ -255,23 +304,38 @@ impl GfxConsole {
             let back = self.back_color.load(Ordering::Acquire);
 
             unsafe {
-                if let Some(s) = surface.as_ref() {
-                    // TODO: Implement putchar
-                    let _ = (s, font, c, x, y, front, back);
+                if let Some(s) = surface.as_mut() {
+                    gfx_putchar(s, font, c, x * font.width, y * font.height, front, back);
                 }
             }
+
+            let top = y * font.height;
+            self.damage.lock().add(top, top + font.height - 1);
         }
     }
 
     /// Scroll the console up by one line
+    ///
+    /// Moves the back buffer up one text row with a single rectangle
+    /// copy and damages the whole screen; the hardware surface is not
+    /// touched until the caller flushes, so a burst of scrolled lines
+    /// costs one hardware blit instead of one per line.
     fn scroll_up(&self) {
         let y = self.y.fetch_sub(1, Ordering::AcqRel);
 
-        // TODO: Implement scroll using copyrect
-        let _ = y;
+        if let (Some(surface), Some(font)) = (self.surface, self.font) {
+            unsafe {
+                if let Some(s) = surface.as_mut() {
+                    s.copyrect(0, font.height, s.width, (self.rows - 1) * font.height, 0, 0);
+                    self.damage.lock().add(0, self.rows * font.height - 1);
+                }
+            }
+        }
 
         // Clear bottom line
-        self.clear_line(y);
+        if y > 0 {
+            self.clear_line(y - 1);
+        }
     }
 
     /// Clear a line
@@ -280,20 +344,45 @@ impl GfxConsole {
     ///
     /// * `y` - Line number to clear
     fn clear_line(&self, y: u32) {
-        if let Some(surface) = self.surface {
+        if let (Some(surface), Some(font)) = (self.surface, self.font) {
+            let back = self.back_color.load(Ordering::Acquire);
+
             unsafe {
-                if let Some(s) = surface.as_ref() {
-                    // TODO: Implement line clearing
-                    let _ = (s, y);
+                if let Some(s) = surface.as_mut() {
+                    s.fillrect(0, y * font.height, s.width, font.height, back);
                 }
             }
+
+            let top = y * font.height;
+            self.damage.lock().add(top, top + font.height - 1);
         }
     }
 
     /// Flush the console to hardware
+    ///
+    /// Blits the damaged pixel-row band from the back buffer to the
+    /// hardware surface and flushes just those rows, then clears the
+    /// damage. A no-op when nothing changed since the last flush.
     pub fn flush(&self) {
-        // TODO: Implement blit to hardware surface if needed
-        // and flush hardware surface
+        let mut damage = self.damage.lock();
+        if !damage.dirty {
+            return;
+        }
+
+        if let (Some(surface), Some(hw_surface)) = (self.surface, self.hw_surface) {
+            unsafe {
+                if surface != hw_surface {
+                    if let (Some(s), Some(hw)) = (surface.as_ref(), hw_surface.as_mut()) {
+                        gfx_blit_rows(s, hw, damage.y0, damage.y1);
+                    }
+                }
+                if let Some(hw) = hw_surface.as_ref() {
+                    hw.flush_rows(damage.y0, damage.y1);
+                }
+            }
+        }
+
+        damage.reset();
     }
 
     /// Put a pixel directly (bypasses console)
@@ -334,21 +423,19 @@ pub fn gfxconsole_print_callback(str: &str, len: usize) {
     let console = GFX_CONSOLE.lock();
 
     if let Some(ref c) = *console {
-        let mut needs_refresh = false;
-
         for (i, &byte) in str.as_bytes().iter().enumerate() {
             if i < len {
                 // Handle LF -> CRLF
                 if byte == b'\n' {
-                    needs_refresh |= c.putc('\r');
+                    c.putc('\r');
                 }
-                needs_refresh |= c.putc(byte as char);
+                c.putc(byte as char);
             }
         }
 
-        if needs_refresh {
-            c.flush();
-        }
+        // One batched flush for the whole string: drawing and scrolling
+        // above only touched the back buffer and the damage band.
+        c.flush();
     }
 }
 
@@ -404,6 +491,21 @@ mod tests {
         assert_eq!(CRASH_BACK_COLOR, 0xFFE000E0);
     }
 
+    #[test]
+    fn test_damage_band_widens_and_resets() {
+        let mut damage = Damage::new();
+        assert!(!damage.dirty);
+
+        damage.add(16, 31);
+        damage.add(64, 79);
+        assert!(damage.dirty);
+        assert_eq!(damage.y0, 16);
+        assert_eq!(damage.y1, 79);
+
+        damage.reset();
+        assert!(!damage.dirty);
+    }
+
     #[test]
     fn test_putc_basic() {
         let console = GfxConsole::new();
@@ -44,6 +44,11 @@ use spin::Mutex;
 
 use crate::rustux::types::*;
 
+extern "C" {
+    /// Returns page-aligned runs to the VM; implemented by the heap wrapper.
+    fn heap_page_free(ptr: *mut u8, pages: usize);
+}
+
 /// Size to grow heap by default
 const HEAP_GROW_SIZE: usize = 1024 * 1024;
 
@@ -166,7 +171,7 @@ pub fn cmpct_alloc(size: usize) -> *mut u8 {
         return core::ptr::null_mut();
     }
 
-    let rounded_up;
+    let mut rounded_up = 0usize;
     let start_bucket = size_to_index_allocating(size, &mut rounded_up);
     let rounded_up = rounded_up + core::mem::size_of::<Header>();
 
@@ -387,12 +392,74 @@ pub fn cmpct_free(payload: *mut u8) {
 }
 
 /// Trim the heap by returning free pages to the OS
+///
+/// Releases the cached OS allocation, then walks the larger free buckets
+/// looking for free areas that run up against the right sentinel of their
+/// OS allocation. Such an area can give back its page-aligned tail: the
+/// area is shrunk, a fresh right sentinel is placed below the returned
+/// range, and the pages go back through heap_page_free().
 pub fn cmpct_trim() {
-    println!("CmpctMalloc: Trimming heap");
+    // The cached OS allocation is a whole page run held back for quick
+    // reuse; trimming means we would rather have the memory returned.
+    {
+        let mut cached = THE_HEAP.cached_os_alloc.lock();
+        if let Some(os_alloc) = cached.take() {
+            unsafe {
+                let os_size = (*os_alloc).size;
+                THE_HEAP.size.fetch_sub(os_size, Ordering::AcqRel);
+                heap_page_free(os_alloc as *mut u8, os_size >> PAGE_SIZE_SHIFT);
+            }
+        }
+    }
 
-    // TODO: Implement trimming logic
-    // Look at free list entries >= PAGE_SIZE + sizeof(Header)
-    // Trim pages from start or end of OS allocations
+    // Only areas of at least a page can contain a whole page to return.
+    let min_bucket = size_to_index_freeing(PAGE_SIZE);
+
+    let mut free_lists = THE_HEAP.free_lists.lock();
+    for bucket in (min_bucket..NUMBER_OF_BUCKETS).rev() {
+        let mut current = free_lists[bucket];
+        while !current.is_null() {
+            unsafe {
+                let next = (*current).next;
+                let right = right_header(&(*current).header);
+                if is_end_of_os_allocation(right) {
+                    // The OS allocation ends just past its right sentinel.
+                    // Everything above the first page boundary that leaves
+                    // room for a shrunken free area and a new sentinel can
+                    // be returned.
+                    let old_end =
+                        round_up(right as usize + core::mem::size_of::<Header>(), PAGE_SIZE);
+                    let new_end = round_up(
+                        current as usize
+                            + core::mem::size_of::<FreeBlock>()
+                            + core::mem::size_of::<Header>(),
+                        PAGE_SIZE,
+                    );
+                    if new_end < old_end {
+                        let freed_up = old_end - new_end;
+                        unlink_free(current, bucket, &mut free_lists);
+                        let new_size = (*current).header.size - freed_up;
+                        // New right sentinel below the returned pages.
+                        create_allocation_header(
+                            current as *mut u8,
+                            new_size,
+                            0,
+                            current as *mut Header,
+                        );
+                        create_free_area(
+                            current,
+                            untag((*current).header.left),
+                            new_size,
+                            &mut free_lists,
+                        );
+                        THE_HEAP.size.fetch_sub(freed_up, Ordering::AcqRel);
+                        heap_page_free(new_end as *mut u8, freed_up >> PAGE_SIZE_SHIFT);
+                    }
+                }
+                current = next;
+            }
+        }
+    }
 }
 
 /// Dump heap information
@@ -446,6 +513,35 @@ pub fn cmpct_get_info(size_bytes: &mut usize, free_bytes: &mut usize) {
     *free_bytes = THE_HEAP.remaining.load(Ordering::Acquire);
 }
 
+/// Get fragmentation information
+///
+/// # Arguments
+///
+/// * `free_blocks` - Output: number of free areas across all buckets
+/// * `largest_free_bytes` - Output: usable size of the largest free area
+pub fn cmpct_get_frag_info(free_blocks: &mut usize, largest_free_bytes: &mut usize) {
+    let mut blocks = 0;
+    let mut largest = 0;
+
+    let free_lists = THE_HEAP.free_lists.lock();
+    for &head in free_lists.iter() {
+        let mut current = head;
+        while !current.is_null() {
+            unsafe {
+                blocks += 1;
+                let usable = (*current).header.size - core::mem::size_of::<Header>();
+                if usable > largest {
+                    largest = usable;
+                }
+                current = (*current).next;
+            }
+        }
+    }
+
+    *free_blocks = blocks;
+    *largest_free_bytes = largest;
+}
+
 /// Run heap tests
 pub fn cmpct_test() {
     println!("CmpctMalloc: Running tests");
@@ -462,7 +558,7 @@ pub fn cmpct_test() {
 }
 
 /// Grow the heap by allocating from the OS
-fn heap_grow(size: usize) -> Result<(), i32> {
+fn heap_grow(size: usize) -> core::result::Result<(), i32> {
     let size_with_sentinels = size + 2 * core::mem::size_of::<Header>();
     let page_aligned = round_up(size_with_sentinels, PAGE_SIZE);
 
@@ -532,8 +628,20 @@ unsafe fn free_memory(
         && is_start_of_os_allocation(left)
         && is_end_of_os_allocation((address as *mut u8).add(size) as *mut Header)
     {
-        // TODO: Return to OS
-        println!("CmpctMalloc: Would return OS allocation");
+        // The whole OS allocation (sentinels included) is free. Hold one
+        // back for quick reuse; any further ones go straight back to the
+        // OS. cmpct_trim() releases the cached one too.
+        let os_size = size + 2 * core::mem::size_of::<Header>();
+        let mut cached = THE_HEAP.cached_os_alloc.lock();
+        if cached.is_none() {
+            (*left).size = os_size;
+            (*left).left = core::ptr::null_mut();
+            *cached = Some(left);
+        } else {
+            drop(cached);
+            THE_HEAP.size.fetch_sub(os_size, Ordering::AcqRel);
+            heap_page_free(left as *mut u8, os_size >> PAGE_SIZE_SHIFT);
+        }
     } else {
         create_free_area(address as *mut FreeBlock, left, size, free_lists);
     }
@@ -603,7 +711,7 @@ fn size_to_index_helper(size: usize, rounded_up_out: &mut usize, adjust: i32, in
     let row_column = (row << 3) | column;
     let row_column = row_column + increment;
     let size = (8 + (row_column & 7)) << (row_column >> 3);
-    *rounded_up_out = size;
+    *rounded_up_out = size as usize;
 
     // 15 small buckets + row-based buckets
     let answer = row_column + 15 - 32;
@@ -714,7 +822,10 @@ mod tests {
         let mut rounded = 0;
         let idx = size_to_index_allocating(8, &mut rounded);
         assert_eq!(idx, 0); // First bucket
-        assert_eq!(rounded, 8);
+        // Small requests are bumped to the minimum free-block payload so a
+        // freed block can hold its list pointers.
+        let min_size = core::mem::size_of::<FreeBlock>() - core::mem::size_of::<Header>();
+        assert_eq!(rounded, min_size);
 
         let idx = size_to_index_allocating(16, &mut rounded);
         assert_eq!(idx, 1);
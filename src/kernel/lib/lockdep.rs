@@ -15,11 +15,12 @@ extern crate alloc;
 
 use alloc::collections::BTreeMap;
 use alloc::format;
-use alloc::string::String;
+use alloc::string::{String, ToString};
 use alloc::vec::Vec;
 use core::sync::atomic::{AtomicBool, AtomicU64, AtomicUsize, Ordering};
 use spin::Mutex;
 
+use crate::kernel::lib::console::{register_command, Cmd, CmdArg};
 use crate::rustux::types::*;
 
 /// Maximum number of lock classes
@@ -188,6 +189,13 @@ static LOOP_DETECTION_ENABLED: AtomicBool = AtomicBool::new(false);
 
 /// Initialize lock dependency tracking
 pub fn init() {
+    register_command(Cmd {
+        name: "lockdep",
+        help: "lock dependency and contention state (dump | profile [on|off|reset] | top [n])",
+        func: Some(cmd_lockdep),
+        flags: 0,
+    });
+
     println!("LockDep: Lock dependency tracking initialized");
 }
 
@@ -342,6 +350,378 @@ pub fn dump_lock_class_state() {
     // TODO: Implement connected set dumping
 }
 
+/// Number of log2 cycle-histogram buckets per lock class
+const PROFILE_HISTOGRAM_BUCKETS: usize = 16;
+
+/// First histogram bucket covers everything below 2^PROFILE_HISTOGRAM_FIRST_BOUND cycles
+const PROFILE_HISTOGRAM_FIRST_BOUND: u32 = 4;
+
+/// Sample 1 in 2^PROFILE_SAMPLE_SHIFT acquisitions for cycle timing
+///
+/// Acquisition and contention counts are always exact when profiling is
+/// enabled; reading the cycle counter twice per acquisition is what
+/// costs, so only sampled acquisitions feed the hold/wait histograms.
+const PROFILE_SAMPLE_SHIFT: u32 = 6;
+
+/// Log2-bucketed cycle histogram
+///
+/// Bucket N counts events with a cycle cost in
+/// [2^(N+FIRST_BOUND), 2^(N+FIRST_BOUND+1)); underflow folds into bucket
+/// 0 and overflow into the last bucket.
+pub struct CycleHistogram {
+    buckets: [AtomicU64; PROFILE_HISTOGRAM_BUCKETS],
+}
+
+impl CycleHistogram {
+    /// Create an empty histogram
+    pub const fn new() -> Self {
+        const INIT: AtomicU64 = AtomicU64::new(0);
+        Self {
+            buckets: [INIT; PROFILE_HISTOGRAM_BUCKETS],
+        }
+    }
+
+    /// Record one event's cycle count
+    pub fn record(&self, cycles: u64) {
+        let log2 = 64 - (cycles | 1).leading_zeros() - 1;
+        // Bucket 0 covers everything below 2^FIRST_BOUND; 2^FIRST_BOUND
+        // itself is the start of bucket 1.
+        let bucket = (log2 + 1).saturating_sub(PROFILE_HISTOGRAM_FIRST_BOUND) as usize;
+        let bucket = if bucket >= PROFILE_HISTOGRAM_BUCKETS {
+            PROFILE_HISTOGRAM_BUCKETS - 1
+        } else {
+            bucket
+        };
+        self.buckets[bucket].fetch_add(1, Ordering::Relaxed);
+    }
+
+    /// Get the count in a bucket
+    pub fn bucket(&self, ix: usize) -> u64 {
+        if ix < PROFILE_HISTOGRAM_BUCKETS {
+            self.buckets[ix].load(Ordering::Relaxed)
+        } else {
+            0
+        }
+    }
+
+    /// Total events recorded
+    pub fn total(&self) -> u64 {
+        self.buckets
+            .iter()
+            .map(|b| b.load(Ordering::Relaxed))
+            .sum()
+    }
+
+    /// Clear all buckets
+    fn reset(&self) {
+        for b in self.buckets.iter() {
+            b.store(0, Ordering::Relaxed);
+        }
+    }
+}
+
+/// Per-lock-class contention profile
+pub struct LockClassProfile {
+    /// Total acquisitions
+    acquisitions: AtomicU64,
+    /// Acquisitions that found the lock held on arrival
+    contended: AtomicU64,
+    /// Cycles spent waiting, summed over sampled acquisitions
+    wait_cycles: AtomicU64,
+    /// Cycles the lock was held, summed over sampled acquisitions
+    hold_cycles: AtomicU64,
+    /// Wait-time histogram (sampled acquisitions)
+    wait_histogram: CycleHistogram,
+    /// Hold-time histogram (sampled acquisitions)
+    hold_histogram: CycleHistogram,
+}
+
+impl LockClassProfile {
+    /// Create an empty profile
+    pub const fn new() -> Self {
+        Self {
+            acquisitions: AtomicU64::new(0),
+            contended: AtomicU64::new(0),
+            wait_cycles: AtomicU64::new(0),
+            hold_cycles: AtomicU64::new(0),
+            wait_histogram: CycleHistogram::new(),
+            hold_histogram: CycleHistogram::new(),
+        }
+    }
+
+    /// Total acquisitions recorded
+    pub fn acquisitions(&self) -> u64 {
+        self.acquisitions.load(Ordering::Relaxed)
+    }
+
+    /// Contended acquisitions recorded
+    pub fn contended(&self) -> u64 {
+        self.contended.load(Ordering::Relaxed)
+    }
+
+    /// Wait-time histogram
+    pub fn wait_histogram(&self) -> &CycleHistogram {
+        &self.wait_histogram
+    }
+
+    /// Hold-time histogram
+    pub fn hold_histogram(&self) -> &CycleHistogram {
+        &self.hold_histogram
+    }
+
+    /// Clear all counters and histograms
+    fn reset(&self) {
+        self.acquisitions.store(0, Ordering::Relaxed);
+        self.contended.store(0, Ordering::Relaxed);
+        self.wait_cycles.store(0, Ordering::Relaxed);
+        self.hold_cycles.store(0, Ordering::Relaxed);
+        self.wait_histogram.reset();
+        self.hold_histogram.reset();
+    }
+}
+
+/// Per-class contention profiles, indexed by lock class ID
+static LOCK_PROFILES: [LockClassProfile; MAX_LOCK_CLASSES] = {
+    const INIT: LockClassProfile = LockClassProfile::new();
+    [INIT; MAX_LOCK_CLASSES]
+};
+
+/// Contention profiling enabled flag
+static PROFILING_ENABLED: AtomicBool = AtomicBool::new(false);
+
+/// Rolling counter driving the 1-in-2^PROFILE_SAMPLE_SHIFT sampling decision
+static PROFILE_SAMPLE_COUNTER: AtomicU64 = AtomicU64::new(0);
+
+/// Total acquisitions observed while profiling
+///
+/// Together with [`PROFILE_TOTAL_CONTENDED`] this is the lib-layer analog
+/// of a kcounter pair; the ratio is the system-wide contention rate.
+static PROFILE_TOTAL_ACQUISITIONS: AtomicU64 = AtomicU64::new(0);
+
+/// Total contended acquisitions observed while profiling
+static PROFILE_TOTAL_CONTENDED: AtomicU64 = AtomicU64::new(0);
+
+/// Enable contention profiling
+pub fn enable_profiling() {
+    PROFILING_ENABLED.store(true, Ordering::Release);
+    println!("LockDep: Contention profiling enabled");
+}
+
+/// Disable contention profiling
+pub fn disable_profiling() {
+    PROFILING_ENABLED.store(false, Ordering::Release);
+    println!("LockDep: Contention profiling disabled");
+}
+
+/// Check whether contention profiling is enabled
+pub fn profiling_enabled() -> bool {
+    PROFILING_ENABLED.load(Ordering::Acquire)
+}
+
+/// Clear all contention profiles
+pub fn reset_profiling() {
+    for profile in LOCK_PROFILES.iter() {
+        profile.reset();
+    }
+    PROFILE_TOTAL_ACQUISITIONS.store(0, Ordering::Relaxed);
+    PROFILE_TOTAL_CONTENDED.store(0, Ordering::Relaxed);
+}
+
+/// Get the aggregate (acquisitions, contended) totals
+pub fn profile_totals() -> (u64, u64) {
+    (
+        PROFILE_TOTAL_ACQUISITIONS.load(Ordering::Relaxed),
+        PROFILE_TOTAL_CONTENDED.load(Ordering::Relaxed),
+    )
+}
+
+/// Begin profiling one lock acquisition
+///
+/// Called before attempting to take the lock. Returns a cycle stamp to
+/// pass to [`profile_acquire_end`], or 0 when this acquisition is not
+/// sampled (or profiling is off) and no timing should be recorded.
+#[inline]
+pub fn profile_acquire_begin() -> u64 {
+    if !PROFILING_ENABLED.load(Ordering::Relaxed) {
+        return 0;
+    }
+
+    let n = PROFILE_SAMPLE_COUNTER.fetch_add(1, Ordering::Relaxed);
+    if n & ((1 << PROFILE_SAMPLE_SHIFT) - 1) != 0 {
+        return 0;
+    }
+
+    crate::kernel::arch::ops::arch_cycle_count()
+}
+
+/// Record one lock acquisition
+///
+/// Called once the lock is held. `begin` is the stamp returned by
+/// [`profile_acquire_begin`]; `contended` is whether the lock was held
+/// when the caller arrived. Returns a hold-start stamp to pass to
+/// [`profile_release`], or 0 when this acquisition is unsampled.
+#[inline]
+pub fn profile_acquire_end(id: LockClassId, begin: u64, contended: bool) -> u64 {
+    if !PROFILING_ENABLED.load(Ordering::Relaxed) {
+        return 0;
+    }
+
+    let profile = match LOCK_PROFILES.get(id as usize) {
+        Some(p) => p,
+        None => return 0,
+    };
+
+    profile.acquisitions.fetch_add(1, Ordering::Relaxed);
+    PROFILE_TOTAL_ACQUISITIONS.fetch_add(1, Ordering::Relaxed);
+    if contended {
+        profile.contended.fetch_add(1, Ordering::Relaxed);
+        PROFILE_TOTAL_CONTENDED.fetch_add(1, Ordering::Relaxed);
+    }
+
+    if begin == 0 {
+        return 0;
+    }
+
+    let now = crate::kernel::arch::ops::arch_cycle_count();
+    let wait = now.wrapping_sub(begin);
+    profile.wait_cycles.fetch_add(wait, Ordering::Relaxed);
+    profile.wait_histogram.record(wait);
+    now
+}
+
+/// Record one lock release
+///
+/// `hold_begin` is the stamp returned by [`profile_acquire_end`]; a zero
+/// stamp means the acquisition was unsampled and nothing is recorded.
+#[inline]
+pub fn profile_release(id: LockClassId, hold_begin: u64) {
+    if hold_begin == 0 || !PROFILING_ENABLED.load(Ordering::Relaxed) {
+        return;
+    }
+
+    let profile = match LOCK_PROFILES.get(id as usize) {
+        Some(p) => p,
+        None => return,
+    };
+
+    let hold = crate::kernel::arch::ops::arch_cycle_count().wrapping_sub(hold_begin);
+    profile.hold_cycles.fetch_add(hold, Ordering::Relaxed);
+    profile.hold_histogram.record(hold);
+}
+
+/// Get the profile for a lock class
+pub fn lock_class_profile(id: LockClassId) -> Option<&'static LockClassProfile> {
+    LOCK_PROFILES.get(id as usize)
+}
+
+/// Get the top-N most contended lock classes
+///
+/// Returns (id, contended count) pairs sorted by descending contended
+/// count; classes with no contention are omitted. This is the export
+/// point for the top-N contended kcounters.
+pub fn top_contended(n: usize) -> Vec<(LockClassId, u64)> {
+    let registered = NEXT_LOCK_CLASS_ID.load(Ordering::Acquire).min(MAX_LOCK_CLASSES);
+
+    let mut ranked: Vec<(LockClassId, u64)> = (0..registered)
+        .map(|id| (id as LockClassId, LOCK_PROFILES[id].contended()))
+        .filter(|&(_, contended)| contended > 0)
+        .collect();
+
+    ranked.sort_unstable_by(|a, b| b.1.cmp(&a.1));
+    ranked.truncate(n);
+    ranked
+}
+
+/// Dump contention profiles for debugging
+pub fn dump_lock_profile() {
+    let (total_acquisitions, total_contended) = profile_totals();
+    println!(
+        "Lock contention profile ({}): {} acquisitions, {} contended",
+        if profiling_enabled() { "on" } else { "off" },
+        total_acquisitions,
+        total_contended
+    );
+
+    let classes = LOCK_CLASSES.lock();
+    for (id, class) in classes.iter() {
+        let profile = &LOCK_PROFILES[*id as usize];
+        let acquisitions = profile.acquisitions();
+        if acquisitions == 0 {
+            continue;
+        }
+
+        let sampled_waits = profile.wait_histogram.total();
+        let sampled_holds = profile.hold_histogram.total();
+        println!(
+            "  {}: acquisitions={} contended={} avg_wait={} avg_hold={} (sampled cycles)",
+            class.name(),
+            acquisitions,
+            profile.contended(),
+            profile.wait_cycles.load(Ordering::Relaxed) / sampled_waits.max(1),
+            profile.hold_cycles.load(Ordering::Relaxed) / sampled_holds.max(1),
+        );
+    }
+}
+
+/// Dump the top-N most contended lock classes
+pub fn dump_top_contended(n: usize) {
+    let ranked = top_contended(n);
+
+    if ranked.is_empty() {
+        println!("LockDep: No contended lock classes");
+        return;
+    }
+
+    println!("Top {} contended lock classes:", ranked.len());
+    let classes = LOCK_CLASSES.lock();
+    for (id, contended) in ranked {
+        let name = classes.get(&id).map(|c| c.name()).unwrap_or("<unknown>");
+        println!("  {}: contended={}", name, contended);
+    }
+}
+
+/// Lockdep command implementation
+fn cmd_lockdep(argc: usize, argv: &[CmdArg], _flags: u32) -> i32 {
+    if argc < 2 {
+        dump_lock_class_state();
+        return 0;
+    }
+
+    match argv[1].str {
+        "dump" => dump_lock_class_state(),
+        "profile" => {
+            if argc >= 3 {
+                match argv[2].str {
+                    "on" => enable_profiling(),
+                    "off" => disable_profiling(),
+                    "reset" => reset_profiling(),
+                    arg => {
+                        println!("Invalid profile subcommand: {}", arg);
+                        return -1;
+                    }
+                }
+            } else {
+                dump_lock_profile();
+            }
+        }
+        "top" => {
+            let mut n = 10;
+            if argc >= 3 {
+                if let Ok(val) = argv[2].str.parse::<usize>() {
+                    n = val;
+                }
+            }
+            dump_top_contended(n);
+        }
+        arg => {
+            println!("Invalid lockdep subcommand: {}", arg);
+            return -1;
+        }
+    }
+
+    0
+}
+
 /// System callback: circular lock dependency detected
 fn system_circular_lock_dependency_detected(_root_id: LockClassId) {
     println!("\nRUSTUX KERNEL OOPS");
@@ -442,4 +822,52 @@ mod tests {
     fn test_constants() {
         assert_eq!(MAX_LOCK_CLASSES, 256);
     }
+
+    #[test]
+    fn test_cycle_histogram_buckets() {
+        let hist = CycleHistogram::new();
+
+        hist.record(0); // Underflow folds into bucket 0
+        hist.record(1 << PROFILE_HISTOGRAM_FIRST_BOUND);
+        hist.record(u64::MAX); // Overflow folds into the last bucket
+
+        assert_eq!(hist.bucket(0), 1);
+        assert_eq!(hist.bucket(1), 1);
+        assert_eq!(hist.bucket(PROFILE_HISTOGRAM_BUCKETS - 1), 1);
+        assert_eq!(hist.total(), 3);
+
+        hist.reset();
+        assert_eq!(hist.total(), 0);
+    }
+
+    #[test]
+    fn test_profile_counts_acquisitions() {
+        // Use a class ID well above anything other tests register so the
+        // per-class counters are ours alone.
+        let id: LockClassId = 200;
+
+        enable_profiling();
+
+        // Unsampled acquisitions (begin == 0) still count exactly.
+        assert_eq!(profile_acquire_end(id, 0, false), 0);
+        assert_eq!(profile_acquire_end(id, 0, true), 0);
+        profile_release(id, 0);
+
+        let profile = lock_class_profile(id).unwrap();
+        assert_eq!(profile.acquisitions(), 2);
+        assert_eq!(profile.contended(), 1);
+        // Unsampled acquisitions never touch the histograms.
+        assert_eq!(profile.wait_histogram().total(), 0);
+        assert_eq!(profile.hold_histogram().total(), 0);
+
+        disable_profiling();
+        assert_eq!(profile_acquire_end(id, 0, true), 0);
+        assert_eq!(profile.acquisitions(), 2);
+    }
+
+    #[test]
+    fn test_profiling_disabled_begin_returns_no_stamp() {
+        disable_profiling();
+        assert_eq!(profile_acquire_begin(), 0);
+    }
 }
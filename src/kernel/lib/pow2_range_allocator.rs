@@ -18,13 +18,13 @@ use alloc::collections::BTreeMap;
 use alloc::format;
 use alloc::string::String;
 use alloc::vec::Vec;
-use core::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
+use core::sync::atomic::{AtomicBool, AtomicU64, AtomicUsize, Ordering};
 use spin::Mutex;
 
 use crate::rustux::types::*;
 
 /// Block bookkeeping structure
-#[derive(Debug, Clone)]
+#[derive(Debug, Clone, Copy)]
 struct P2raBlock {
     /// Bucket index (log2 of size)
     bucket: u32,
@@ -67,7 +67,7 @@ impl P2raState {
     /// # Returns
     ///
     /// Ok(state) on success, Err(status) on failure
-    pub fn new(max_alloc_size: u32) -> Result<Self, i32> {
+    pub fn new(max_alloc_size: u32) -> core::result::Result<Self, i32> {
         if max_alloc_size == 0 || !max_alloc_size.is_power_of_two() {
             println!("max_alloc_size ({}) is not an integer power of two!", max_alloc_size);
             return Err(-1); // ZX_ERR_INVALID_ARGS
@@ -102,7 +102,7 @@ impl P2raState {
     /// # Returns
     ///
     /// Ok(()) on success, Err(status) on failure
-    pub fn add_range(&mut self, range_start: u32, range_len: u32) -> Result<(), i32> {
+    pub fn add_range(&mut self, range_start: u32, range_len: u32) -> core::result::Result<(), i32> {
         if range_len == 0 {
             return Err(-1); // ZX_ERR_INVALID_ARGS
         }
@@ -187,7 +187,7 @@ impl P2raState {
     /// # Returns
     ///
     /// Ok(start) on success, Err(status) on failure
-    pub fn allocate(&mut self, size: u32) -> Result<u32, i32> {
+    pub fn allocate(&mut self, size: u32) -> core::result::Result<u32, i32> {
         if size == 0 || !size.is_power_of_two() {
             println!("Size ({}) is not an integer power of 2.", size);
             return Err(-1); // ZX_ERR_INVALID_ARGS
@@ -299,6 +299,8 @@ impl P2raState {
 
                         self.unused_blocks.push(second);
 
+                        // The merged block starts at the lower half.
+                        block.start = first.start;
                         block.bucket += 1;
                         self.return_free_block_internal(block, merge_allowed);
                     }
@@ -351,6 +353,302 @@ impl P2raState {
     }
 }
 
+/// Number of lock-free cache slots per order
+const ORDER_CACHE_SLOTS: usize = 8;
+
+/// Empty order-cache slot marker
+const ORDER_CACHE_EMPTY: u64 = 0;
+
+/// Lock-free per-order free cache
+///
+/// A small fixed array of recently freed singleton blocks for one
+/// order. Slots hold `start + 1` so zero can mean empty; push and pop
+/// are single compare-exchanges, so same-order allocate/free traffic
+/// (MSI block churn during driver start) never touches the global
+/// allocator lock.
+struct OrderCache {
+    /// Cached block starts, encoded as start + 1 (0 = empty)
+    slots: [AtomicU64; ORDER_CACHE_SLOTS],
+}
+
+impl OrderCache {
+    /// Create an empty cache
+    const fn new() -> Self {
+        const INIT: AtomicU64 = AtomicU64::new(ORDER_CACHE_EMPTY);
+        Self {
+            slots: [INIT; ORDER_CACHE_SLOTS],
+        }
+    }
+
+    /// Pop any cached block, if one is present
+    fn pop(&self) -> Option<u32> {
+        for slot in self.slots.iter() {
+            let encoded = slot.load(Ordering::Relaxed);
+            if encoded == ORDER_CACHE_EMPTY {
+                continue;
+            }
+            if slot
+                .compare_exchange(encoded, ORDER_CACHE_EMPTY, Ordering::Acquire, Ordering::Relaxed)
+                .is_ok()
+            {
+                return Some((encoded - 1) as u32);
+            }
+        }
+        None
+    }
+
+    /// Push a block, failing if every slot is occupied
+    fn push(&self, start: u32) -> core::result::Result<(), ()> {
+        let encoded = start as u64 + 1;
+        for slot in self.slots.iter() {
+            if slot.load(Ordering::Relaxed) != ORDER_CACHE_EMPTY {
+                continue;
+            }
+            if slot
+                .compare_exchange(ORDER_CACHE_EMPTY, encoded, Ordering::Release, Ordering::Relaxed)
+                .is_ok()
+            {
+                return Ok(());
+            }
+        }
+        Err(())
+    }
+
+    /// Drain every cached block into `f`
+    fn drain<F: FnMut(u32)>(&self, mut f: F) {
+        for slot in self.slots.iter() {
+            let encoded = slot.swap(ORDER_CACHE_EMPTY, Ordering::Acquire);
+            if encoded != ORDER_CACHE_EMPTY {
+                f((encoded - 1) as u32);
+            }
+        }
+    }
+}
+
+/// Per-order occupancy statistics
+pub struct OrderStats {
+    /// Total allocations of this order
+    allocations: AtomicU64,
+    /// Total frees of this order
+    frees: AtomicU64,
+    /// Allocations satisfied from the lock-free cache
+    cache_hits: AtomicU64,
+    /// Currently outstanding blocks of this order
+    outstanding: AtomicU64,
+    /// High-water mark of outstanding blocks
+    peak: AtomicU64,
+}
+
+impl OrderStats {
+    /// Create zeroed stats
+    const fn new() -> Self {
+        Self {
+            allocations: AtomicU64::new(0),
+            frees: AtomicU64::new(0),
+            cache_hits: AtomicU64::new(0),
+            outstanding: AtomicU64::new(0),
+            peak: AtomicU64::new(0),
+        }
+    }
+
+    /// Total allocations of this order
+    pub fn allocations(&self) -> u64 {
+        self.allocations.load(Ordering::Relaxed)
+    }
+
+    /// Allocations satisfied without the global lock
+    pub fn cache_hits(&self) -> u64 {
+        self.cache_hits.load(Ordering::Relaxed)
+    }
+
+    /// Currently outstanding blocks of this order
+    pub fn outstanding(&self) -> u64 {
+        self.outstanding.load(Ordering::Relaxed)
+    }
+
+    /// High-water mark of outstanding blocks
+    ///
+    /// This is the number to size IRQ vector pools from.
+    pub fn peak(&self) -> u64 {
+        self.peak.load(Ordering::Relaxed)
+    }
+
+    /// Record one allocation
+    fn record_alloc(&self, from_cache: bool) {
+        self.allocations.fetch_add(1, Ordering::Relaxed);
+        if from_cache {
+            self.cache_hits.fetch_add(1, Ordering::Relaxed);
+        }
+        let now = self.outstanding.fetch_add(1, Ordering::Relaxed) + 1;
+        self.peak.fetch_max(now, Ordering::Relaxed);
+    }
+
+    /// Record one free
+    fn record_free(&self) {
+        self.frees.fetch_add(1, Ordering::Relaxed);
+        self.outstanding.fetch_sub(1, Ordering::Relaxed);
+    }
+}
+
+/// Concurrent power-of-2 range allocator
+///
+/// Wraps [`P2raState`] for shared use. Each order gets its own
+/// lock-free free cache, so the common MSI pattern - drivers
+/// allocating and freeing same-sized vector blocks in parallel - pops
+/// and pushes singletons without serializing on the allocator mutex.
+/// Only cache misses (splits) and cache overflow (merges) take the
+/// global lock. Blocks parked in a cache are deliberately not merged;
+/// [`flush_caches`](Self::flush_caches) returns them for coalescing.
+pub struct P2raAllocator {
+    /// Shared allocator state (split/merge slow path)
+    state: Mutex<P2raState>,
+    /// Per-order lock-free free caches, indexed by bucket
+    caches: Vec<OrderCache>,
+    /// Per-order occupancy statistics, indexed by bucket
+    stats: Vec<OrderStats>,
+}
+
+impl P2raAllocator {
+    /// Create a new concurrent allocator
+    ///
+    /// # Arguments
+    ///
+    /// * `max_alloc_size` - Maximum allocation size (must be power of 2)
+    ///
+    /// # Returns
+    ///
+    /// Ok(allocator) on success, Err(status) on failure
+    pub fn new(max_alloc_size: u32) -> core::result::Result<Self, i32> {
+        let state = P2raState::new(max_alloc_size)?;
+        let bucket_count = state.bucket_count as usize;
+
+        let mut caches = Vec::with_capacity(bucket_count);
+        let mut stats = Vec::with_capacity(bucket_count);
+        for _ in 0..bucket_count {
+            caches.push(OrderCache::new());
+            stats.push(OrderStats::new());
+        }
+
+        Ok(Self {
+            state: Mutex::new(state),
+            caches,
+            stats,
+        })
+    }
+
+    /// Add a range to the allocator
+    ///
+    /// # Arguments
+    ///
+    /// * `range_start` - Start of the range
+    /// * `range_len` - Length of the range
+    ///
+    /// # Returns
+    ///
+    /// Ok(()) on success, Err(status) on failure
+    pub fn add_range(&self, range_start: u32, range_len: u32) -> core::result::Result<(), i32> {
+        self.state.lock().add_range(range_start, range_len)
+    }
+
+    /// Allocate a range
+    ///
+    /// Fast path: pop a cached block of the right order without taking
+    /// the lock. Slow path: allocate (possibly splitting) under the
+    /// global lock.
+    ///
+    /// # Arguments
+    ///
+    /// * `size` - Size to allocate (must be power of 2)
+    ///
+    /// # Returns
+    ///
+    /// Ok(start) on success, Err(status) on failure
+    pub fn allocate(&self, size: u32) -> core::result::Result<u32, i32> {
+        if size == 0 || !size.is_power_of_two() {
+            return Err(-1); // ZX_ERR_INVALID_ARGS
+        }
+
+        let bucket = size.trailing_zeros() as usize;
+        if bucket >= self.caches.len() {
+            return Err(-1); // ZX_ERR_INVALID_ARGS
+        }
+
+        if let Some(start) = self.caches[bucket].pop() {
+            self.stats[bucket].record_alloc(true);
+            return Ok(start);
+        }
+
+        let start = self.state.lock().allocate(size)?;
+        self.stats[bucket].record_alloc(false);
+        Ok(start)
+    }
+
+    /// Free a range
+    ///
+    /// Fast path: park the block in its order's cache without taking
+    /// the lock. Slow path (cache full): free under the global lock so
+    /// the block can merge with its buddy.
+    ///
+    /// # Arguments
+    ///
+    /// * `range_start` - Start of range to free
+    /// * `size` - Size of range (must be power of 2)
+    pub fn free(&self, range_start: u32, size: u32) {
+        if size == 0 || !size.is_power_of_two() {
+            return;
+        }
+
+        let bucket = size.trailing_zeros() as usize;
+        if bucket >= self.caches.len() {
+            return;
+        }
+
+        self.stats[bucket].record_free();
+
+        if self.caches[bucket].push(range_start).is_ok() {
+            return;
+        }
+
+        self.state.lock().free(range_start, size);
+    }
+
+    /// Flush every order cache back into the allocator
+    ///
+    /// Returns parked blocks to the global free lists so they can
+    /// merge with their buddies. Call on teardown or when larger
+    /// orders start failing.
+    pub fn flush_caches(&self) {
+        let mut state = self.state.lock();
+        for (bucket, cache) in self.caches.iter().enumerate() {
+            cache.drain(|start| state.free(start, 1u32 << bucket));
+        }
+    }
+
+    /// Get the occupancy statistics for one order
+    pub fn order_stats(&self, bucket: usize) -> Option<&OrderStats> {
+        self.stats.get(bucket)
+    }
+
+    /// Dump per-order occupancy for debugging
+    pub fn dump_stats(&self) {
+        println!("P2RA occupancy:");
+        for (bucket, stats) in self.stats.iter().enumerate() {
+            if stats.allocations() == 0 {
+                continue;
+            }
+            println!(
+                "  order {} (size {}): allocs={} cache_hits={} outstanding={} peak={}",
+                bucket,
+                1u32 << bucket,
+                stats.allocations(),
+                stats.cache_hits(),
+                stats.outstanding(),
+                stats.peak()
+            );
+        }
+    }
+}
+
 /// Check if a number is a power of 2
 pub fn ispow2(n: u32) -> bool {
     n != 0 && (n & (n - 1)) == 0
@@ -423,6 +721,64 @@ mod tests {
         assert!(!ispow2(100));
     }
 
+    #[test]
+    fn test_p2ra_allocator_cache_hit() {
+        let alloc = P2raAllocator::new(256).unwrap();
+        alloc.add_range(0, 256).unwrap();
+
+        let a = alloc.allocate(16).unwrap();
+        alloc.free(a, 16);
+
+        // The freed block comes back from the order cache, not a split.
+        let b = alloc.allocate(16).unwrap();
+        assert_eq!(b, a);
+
+        let stats = alloc.order_stats(4).unwrap();
+        assert_eq!(stats.allocations(), 2);
+        assert_eq!(stats.cache_hits(), 1);
+        assert_eq!(stats.outstanding(), 1);
+        assert_eq!(stats.peak(), 1);
+    }
+
+    #[test]
+    fn test_p2ra_allocator_flush_restores_merging() {
+        let alloc = P2raAllocator::new(256).unwrap();
+        alloc.add_range(0, 256).unwrap();
+
+        // Carve the whole pool into 16-byte blocks, then free them all.
+        let mut blocks = Vec::new();
+        for _ in 0..16 {
+            blocks.push(alloc.allocate(16).unwrap());
+        }
+        assert!(alloc.allocate(16).is_err());
+        for block in blocks {
+            alloc.free(block, 16);
+        }
+
+        // Cached singletons can't merge; flushing coalesces them back
+        // into a single max-order block.
+        alloc.flush_caches();
+        assert!(alloc.allocate(256).is_ok());
+    }
+
+    #[test]
+    fn test_order_cache_push_pop() {
+        let cache = OrderCache::new();
+
+        for i in 0..ORDER_CACHE_SLOTS as u32 {
+            assert!(cache.push(i * 16).is_ok());
+        }
+        // A full cache rejects the push (caller falls back to the lock).
+        assert!(cache.push(999).is_err());
+
+        let mut popped = 0;
+        while cache.pop().is_some() {
+            popped += 1;
+        }
+        assert_eq!(popped, ORDER_CACHE_SLOTS);
+        assert!(cache.pop().is_none());
+    }
+
     #[test]
     fn test_log2_uint_floor() {
         assert_eq!(log2_uint_floor(1), 0);
@@ -0,0 +1,630 @@
+// Copyright 2025 The Rustux Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+//! Region Allocator
+//!
+//! This module provides the region allocator that backs device
+//! address-space carving (PCIe BAR windows, MMIO apertures, bus
+//! resource ranges). Regions are arbitrary [base, base + size) ranges,
+//! not restricted to powers of two like the pow2 range allocator.
+//!
+//! Available regions are indexed twice: by base for O(log n) coalescing
+//! on free, and by (size, base) for O(log n) best-fit lookup so BAR
+//! allocation storms after hotplug re-enumeration don't degrade into
+//! linear scans. Region bookkeeping nodes come from an internal slab
+//! with a free list, so steady-state allocate/free traffic performs no
+//! heap round trips, and `release_all` returns everything in a single
+//! coalescing pass for cheap teardown.
+
+#![no_std]
+
+extern crate alloc;
+
+use alloc::collections::BTreeMap;
+use alloc::vec::Vec;
+
+use crate::rustux::types::*;
+use crate::rustux::types::err::*;
+
+/// Number of slab nodes added per grow
+const SLAB_GROW_COUNT: usize = 32;
+
+/// A contiguous [base, base + size) range
+#[repr(C)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct Region {
+    /// Base address of the region
+    pub base: u64,
+    /// Size of the region in bytes
+    pub size: u64,
+}
+
+impl Region {
+    /// Create a new region
+    pub const fn new(base: u64, size: u64) -> Self {
+        Self { base, size }
+    }
+
+    /// Get the exclusive end of the region
+    pub fn end(&self) -> u64 {
+        self.base + self.size
+    }
+
+    /// Check whether this region overlaps another
+    pub fn overlaps(&self, other: &Region) -> bool {
+        self.base < other.end() && other.base < self.end()
+    }
+}
+
+/// Slab node holding one region's bookkeeping
+#[derive(Debug, Clone, Copy)]
+struct RegionNode {
+    /// The region this node tracks
+    region: Region,
+    /// Next node in the slab free list (when recycled)
+    next_free: Option<usize>,
+}
+
+/// Slab of region bookkeeping nodes
+///
+/// Nodes are recycled through an internal free list instead of being
+/// returned to the heap, so allocate/free churn during device
+/// re-enumeration only touches the backing Vec when the slab grows.
+struct RegionSlab {
+    /// Backing node storage
+    nodes: Vec<RegionNode>,
+    /// Head of the free list
+    free_head: Option<usize>,
+}
+
+impl RegionSlab {
+    /// Create an empty slab
+    const fn new() -> Self {
+        Self {
+            nodes: Vec::new(),
+            free_head: None,
+        }
+    }
+
+    /// Allocate a node for a region, growing the slab if needed
+    fn alloc(&mut self, region: Region) -> usize {
+        if self.free_head.is_none() {
+            self.grow();
+        }
+
+        let slot = self.free_head.expect("slab grow produced no free nodes");
+        self.free_head = self.nodes[slot].next_free;
+        self.nodes[slot] = RegionNode {
+            region,
+            next_free: None,
+        };
+        slot
+    }
+
+    /// Return a node to the free list
+    fn free(&mut self, slot: usize) {
+        self.nodes[slot].next_free = self.free_head;
+        self.free_head = Some(slot);
+    }
+
+    /// Get the region stored in a slot
+    fn region(&self, slot: usize) -> Region {
+        self.nodes[slot].region
+    }
+
+    /// Add SLAB_GROW_COUNT fresh nodes to the free list
+    fn grow(&mut self) {
+        self.nodes.reserve(SLAB_GROW_COUNT);
+        for _ in 0..SLAB_GROW_COUNT {
+            let slot = self.nodes.len();
+            self.nodes.push(RegionNode {
+                region: Region::new(0, 0),
+                next_free: self.free_head,
+            });
+            self.free_head = Some(slot);
+        }
+    }
+}
+
+/// Region allocator state
+pub struct RegionAllocator {
+    /// Bookkeeping node slab
+    slab: RegionSlab,
+    /// Available regions indexed by base (for coalescing on free)
+    avail_by_base: BTreeMap<u64, usize>,
+    /// Available regions indexed by (size, base) (for best-fit lookup)
+    avail_by_size: BTreeMap<(u64, u64), usize>,
+    /// Allocated regions indexed by base
+    allocated_by_base: BTreeMap<u64, usize>,
+    /// Best-fit cache: (requested size, alignment, by-size key of the
+    /// region that satisfied it last time)
+    ///
+    /// BAR storms allocate runs of identically sized regions; the cache
+    /// lets a repeat request skip the range walk and go straight to the
+    /// remainder left behind by the previous split.
+    fit_cache: Option<(u64, u64, (u64, u64))>,
+    /// Total bytes available
+    avail_size: u64,
+    /// Total bytes allocated
+    allocated_size: u64,
+}
+
+impl RegionAllocator {
+    /// Create a new empty region allocator
+    pub const fn new() -> Self {
+        Self {
+            slab: RegionSlab::new(),
+            avail_by_base: BTreeMap::new(),
+            avail_by_size: BTreeMap::new(),
+            allocated_by_base: BTreeMap::new(),
+            fit_cache: None,
+            avail_size: 0,
+            allocated_size: 0,
+        }
+    }
+
+    /// Add a region to the allocator's available pool
+    ///
+    /// # Arguments
+    ///
+    /// * `base` - Base address of the region
+    /// * `size` - Size of the region in bytes
+    ///
+    /// # Returns
+    ///
+    /// Ok(()) on success, or an error if the region is empty, wraps, or
+    /// overlaps a region already tracked by the allocator
+    pub fn add_region(&mut self, base: u64, size: u64) -> Result<()> {
+        if size == 0 || base.checked_add(size).is_none() {
+            return Err(RX_ERR_INVALID_ARGS);
+        }
+
+        let region = Region::new(base, size);
+        if self.overlaps_tracked(&region) {
+            return Err(RX_ERR_ALREADY_EXISTS);
+        }
+
+        self.insert_avail(region);
+        Ok(())
+    }
+
+    /// Allocate a region by size with best-fit placement
+    ///
+    /// Walks the size index from the smallest region that can hold the
+    /// request, so the first candidate whose aligned base fits is the
+    /// best fit. Leftover space before and after the carved range is
+    /// returned to the available pool.
+    ///
+    /// # Arguments
+    ///
+    /// * `size` - Size to allocate in bytes
+    /// * `alignment` - Required base alignment (must be a power of 2)
+    ///
+    /// # Returns
+    ///
+    /// Ok(region) on success, or an error if the arguments are invalid
+    /// or no available region can satisfy the request
+    pub fn get_region_by_size(&mut self, size: u64, alignment: u64) -> Result<Region> {
+        if size == 0 || alignment == 0 || !alignment.is_power_of_two() {
+            return Err(RX_ERR_INVALID_ARGS);
+        }
+
+        // Check the best-fit cache before walking the size index.
+        if let Some((cached_size, cached_align, key)) = self.fit_cache {
+            if cached_size == size && cached_align == alignment {
+                if let Some(&slot) = self.avail_by_size.get(&key) {
+                    let candidate = self.slab.region(slot);
+                    if let Some(aligned) = aligned_base(&candidate, size, alignment) {
+                        return Ok(self.carve(slot, aligned, size, alignment));
+                    }
+                }
+            }
+        }
+
+        // Best-fit: candidates come back in ascending (size, base)
+        // order, so the first one whose aligned base fits wins.
+        let found = self
+            .avail_by_size
+            .range((size, 0)..)
+            .find_map(|(_, &slot)| {
+                let candidate = self.slab.region(slot);
+                aligned_base(&candidate, size, alignment).map(|aligned| (slot, aligned))
+            });
+
+        let (slot, aligned) = found.ok_or(RX_ERR_NO_RESOURCES)?;
+        Ok(self.carve(slot, aligned, size, alignment))
+    }
+
+    /// Allocate a specific region
+    ///
+    /// # Arguments
+    ///
+    /// * `base` - Base address to allocate
+    /// * `size` - Size to allocate in bytes
+    ///
+    /// # Returns
+    ///
+    /// Ok(region) on success, or an error if the range is not wholly
+    /// contained in a single available region
+    pub fn get_region(&mut self, base: u64, size: u64) -> Result<Region> {
+        if size == 0 || base.checked_add(size).is_none() {
+            return Err(RX_ERR_INVALID_ARGS);
+        }
+
+        // The containing available region is the one with the largest
+        // base <= the requested base.
+        let slot = self
+            .avail_by_base
+            .range(..=base)
+            .next_back()
+            .map(|(_, &slot)| slot)
+            .ok_or(RX_ERR_NOT_FOUND)?;
+
+        let container = self.slab.region(slot);
+        if base + size > container.end() {
+            return Err(RX_ERR_NOT_FOUND);
+        }
+
+        Ok(self.carve(slot, base, size, 1))
+    }
+
+    /// Release an allocated region back to the available pool
+    ///
+    /// The freed range is coalesced with adjacent available regions.
+    ///
+    /// # Arguments
+    ///
+    /// * `base` - Base address of the region to release
+    ///
+    /// # Returns
+    ///
+    /// Ok(()) on success, or an error if no allocated region starts at
+    /// the given base
+    pub fn release_region(&mut self, base: u64) -> Result<()> {
+        let slot = self
+            .allocated_by_base
+            .remove(&base)
+            .ok_or(RX_ERR_NOT_FOUND)?;
+
+        let region = self.slab.region(slot);
+        self.slab.free(slot);
+        self.allocated_size -= region.size;
+        self.insert_avail(region);
+        Ok(())
+    }
+
+    /// Release every allocated region in one pass
+    ///
+    /// Teardown path for device removal and re-enumeration: instead of
+    /// coalescing tree updates per region, every tracked range is
+    /// collected once, merged in base order, and the indexes are
+    /// rebuilt. O(n log n) total rather than per free.
+    pub fn release_all(&mut self) {
+        if self.allocated_by_base.is_empty() {
+            return;
+        }
+
+        // Both maps iterate in ascending base order; merge the two
+        // sorted streams into one base-ordered list of regions.
+        let mut regions: Vec<Region> = Vec::with_capacity(
+            self.avail_by_base.len() + self.allocated_by_base.len(),
+        );
+        let mut avail = self.avail_by_base.iter().peekable();
+        let mut allocated = self.allocated_by_base.iter().peekable();
+        loop {
+            let take_avail = match (avail.peek(), allocated.peek()) {
+                (Some((&a, _)), Some((&b, _))) => a < b,
+                (Some(_), None) => true,
+                (None, Some(_)) => false,
+                (None, None) => break,
+            };
+            let (_, &slot) = if take_avail {
+                avail.next().unwrap()
+            } else {
+                allocated.next().unwrap()
+            };
+            regions.push(self.slab.region(slot));
+        }
+
+        // Rebuild the allocator state from the coalesced list. The old
+        // slab nodes all become garbage at once; resetting the slab's
+        // free list wholesale is cheaper than freeing them one by one.
+        self.avail_by_base.clear();
+        self.avail_by_size.clear();
+        self.allocated_by_base.clear();
+        self.fit_cache = None;
+        self.avail_size = 0;
+        self.allocated_size = 0;
+        self.slab = RegionSlab::new();
+
+        let mut merged: Option<Region> = None;
+        for region in regions {
+            match merged {
+                Some(ref mut current) if current.end() == region.base => {
+                    current.size += region.size;
+                }
+                Some(current) => {
+                    self.insert_avail_no_merge(current);
+                    merged = Some(region);
+                }
+                None => merged = Some(region),
+            }
+        }
+        if let Some(current) = merged {
+            self.insert_avail_no_merge(current);
+        }
+    }
+
+    /// Get the total bytes available
+    pub fn available_size(&self) -> u64 {
+        self.avail_size
+    }
+
+    /// Get the total bytes allocated
+    pub fn allocated_size(&self) -> u64 {
+        self.allocated_size
+    }
+
+    /// Get the number of available regions
+    pub fn available_count(&self) -> usize {
+        self.avail_by_base.len()
+    }
+
+    /// Get the number of allocated regions
+    pub fn allocated_count(&self) -> usize {
+        self.allocated_by_base.len()
+    }
+
+    /// Dump allocator state for debugging
+    pub fn dump(&self) {
+        println!("RegionAllocator state:");
+        println!(
+            "  Available: {} regions, {} bytes",
+            self.available_count(),
+            self.avail_size
+        );
+        println!(
+            "  Allocated: {} regions, {} bytes",
+            self.allocated_count(),
+            self.allocated_size
+        );
+
+        for (_, &slot) in self.avail_by_base.iter() {
+            let region = self.slab.region(slot);
+            println!("  free  [{:#x}, {:#x})", region.base, region.end());
+        }
+        for (_, &slot) in self.allocated_by_base.iter() {
+            let region = self.slab.region(slot);
+            println!("  used  [{:#x}, {:#x})", region.base, region.end());
+        }
+    }
+
+    /// Check whether a region overlaps anything tracked (internal)
+    fn overlaps_tracked(&self, region: &Region) -> bool {
+        // Only the nearest neighbors by base can overlap.
+        let before = |map: &BTreeMap<u64, usize>| {
+            map.range(..region.end())
+                .next_back()
+                .map(|(_, &slot)| self.slab.region(slot))
+        };
+        for map in [&self.avail_by_base, &self.allocated_by_base] {
+            if let Some(neighbor) = before(map) {
+                if neighbor.overlaps(region) {
+                    return true;
+                }
+            }
+        }
+        false
+    }
+
+    /// Carve an allocation out of an available region (internal)
+    ///
+    /// Removes the region in `slot` from the available indexes, records
+    /// the [aligned, aligned + size) range as allocated, and returns
+    /// any leftover head/tail space to the available pool. The tail
+    /// remainder is remembered in the best-fit cache.
+    fn carve(&mut self, slot: usize, aligned: u64, size: u64, alignment: u64) -> Region {
+        let container = self.slab.region(slot);
+        self.remove_avail(slot);
+        self.slab.free(slot);
+
+        let allocated = Region::new(aligned, size);
+        let allocated_slot = self.slab.alloc(allocated);
+        self.allocated_by_base.insert(allocated.base, allocated_slot);
+        self.allocated_size += size;
+
+        if aligned > container.base {
+            self.insert_avail_no_merge(Region::new(container.base, aligned - container.base));
+        }
+
+        self.fit_cache = None;
+        if allocated.end() < container.end() {
+            let tail = Region::new(allocated.end(), container.end() - allocated.end());
+            self.insert_avail_no_merge(tail);
+            if tail.size >= size {
+                self.fit_cache = Some((size, alignment, (tail.size, tail.base)));
+            }
+        }
+
+        allocated
+    }
+
+    /// Insert an available region, coalescing with neighbors (internal)
+    fn insert_avail(&mut self, mut region: Region) {
+        // Merge with the predecessor if it ends where we start.
+        if let Some((_, &slot)) = self.avail_by_base.range(..region.base).next_back() {
+            let prev = self.slab.region(slot);
+            if prev.end() == region.base {
+                self.remove_avail(slot);
+                self.slab.free(slot);
+                region = Region::new(prev.base, prev.size + region.size);
+            }
+        }
+
+        // Merge with the successor if we end where it starts.
+        if let Some(&slot) = self.avail_by_base.get(&region.end()) {
+            let next = self.slab.region(slot);
+            self.remove_avail(slot);
+            self.slab.free(slot);
+            region.size += next.size;
+        }
+
+        self.insert_avail_no_merge(region);
+    }
+
+    /// Insert an available region without coalescing (internal)
+    fn insert_avail_no_merge(&mut self, region: Region) {
+        let slot = self.slab.alloc(region);
+        self.avail_by_base.insert(region.base, slot);
+        self.avail_by_size.insert((region.size, region.base), slot);
+        self.avail_size += region.size;
+    }
+
+    /// Remove an available region from both indexes (internal)
+    ///
+    /// The caller owns the slab slot afterwards.
+    fn remove_avail(&mut self, slot: usize) {
+        let region = self.slab.region(slot);
+        self.avail_by_base.remove(&region.base);
+        self.avail_by_size.remove(&(region.size, region.base));
+        self.avail_size -= region.size;
+        if let Some((_, _, key)) = self.fit_cache {
+            if key == (region.size, region.base) {
+                self.fit_cache = None;
+            }
+        }
+    }
+}
+
+/// Compute the aligned allocation base within a region (internal)
+///
+/// Returns the smallest `alignment`-aligned base inside `region` from
+/// which `size` bytes still fit, or None if the request does not fit.
+fn aligned_base(region: &Region, size: u64, alignment: u64) -> Option<u64> {
+    let aligned = region.base.checked_add(alignment - 1)? & !(alignment - 1);
+    if aligned >= region.base && aligned + size <= region.end() {
+        Some(aligned)
+    } else {
+        None
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_add_and_allocate() {
+        let mut ra = RegionAllocator::new();
+        ra.add_region(0x1000, 0x1000).unwrap();
+
+        let region = ra.get_region_by_size(0x100, 1).unwrap();
+        assert_eq!(region.base, 0x1000);
+        assert_eq!(region.size, 0x100);
+        assert_eq!(ra.allocated_size(), 0x100);
+        assert_eq!(ra.available_size(), 0xf00);
+    }
+
+    #[test]
+    fn test_add_region_rejects_overlap() {
+        let mut ra = RegionAllocator::new();
+        ra.add_region(0x1000, 0x1000).unwrap();
+
+        assert_eq!(ra.add_region(0x1800, 0x1000), Err(RX_ERR_ALREADY_EXISTS));
+        assert_eq!(ra.add_region(0, 0), Err(RX_ERR_INVALID_ARGS));
+    }
+
+    #[test]
+    fn test_best_fit_picks_smallest_region() {
+        let mut ra = RegionAllocator::new();
+        ra.add_region(0x10000, 0x4000).unwrap();
+        ra.add_region(0x20000, 0x1000).unwrap();
+
+        // The 0x1000 region is the best fit for a 0x1000 request even
+        // though the larger region sorts first by base.
+        let region = ra.get_region_by_size(0x1000, 1).unwrap();
+        assert_eq!(region.base, 0x20000);
+    }
+
+    #[test]
+    fn test_alignment() {
+        let mut ra = RegionAllocator::new();
+        ra.add_region(0x1010, 0x2000).unwrap();
+
+        let region = ra.get_region_by_size(0x100, 0x1000).unwrap();
+        assert_eq!(region.base, 0x2000);
+
+        // The head gap before the aligned base stays available.
+        assert_eq!(ra.get_region(0x1010, 0xff0).unwrap().base, 0x1010);
+    }
+
+    #[test]
+    fn test_get_specific_region() {
+        let mut ra = RegionAllocator::new();
+        ra.add_region(0x1000, 0x1000).unwrap();
+
+        let region = ra.get_region(0x1400, 0x200).unwrap();
+        assert_eq!(region.base, 0x1400);
+
+        // The same range can't be carved twice.
+        assert_eq!(ra.get_region(0x1400, 0x200), Err(RX_ERR_NOT_FOUND));
+        // Ranges straddling the end of the pool are rejected.
+        assert_eq!(ra.get_region(0x1f00, 0x200), Err(RX_ERR_NOT_FOUND));
+    }
+
+    #[test]
+    fn test_release_coalesces() {
+        let mut ra = RegionAllocator::new();
+        ra.add_region(0x1000, 0x1000).unwrap();
+
+        let a = ra.get_region_by_size(0x800, 1).unwrap();
+        let b = ra.get_region_by_size(0x800, 1).unwrap();
+        assert_eq!(ra.available_count(), 0);
+
+        ra.release_region(a.base).unwrap();
+        ra.release_region(b.base).unwrap();
+
+        // Freed neighbors merge back into the original single region.
+        assert_eq!(ra.available_count(), 1);
+        assert_eq!(ra.available_size(), 0x1000);
+        assert_eq!(ra.get_region_by_size(0x1000, 1).unwrap().base, 0x1000);
+    }
+
+    #[test]
+    fn test_release_all() {
+        let mut ra = RegionAllocator::new();
+        ra.add_region(0x1000, 0x1000).unwrap();
+        ra.add_region(0x4000, 0x1000).unwrap();
+
+        for _ in 0..8 {
+            ra.get_region_by_size(0x100, 1).unwrap();
+        }
+        assert_eq!(ra.allocated_count(), 8);
+
+        ra.release_all();
+
+        assert_eq!(ra.allocated_count(), 0);
+        assert_eq!(ra.allocated_size(), 0);
+        // The two disjoint pools coalesce back to exactly two regions.
+        assert_eq!(ra.available_count(), 2);
+        assert_eq!(ra.available_size(), 0x2000);
+    }
+
+    #[test]
+    fn test_fit_cache_reuse() {
+        let mut ra = RegionAllocator::new();
+        ra.add_region(0x1000, 0x10000).unwrap();
+
+        // A run of same-size allocations comes back contiguous: each
+        // request is satisfied from the cached tail remainder.
+        let mut expected = 0x1000;
+        for _ in 0..16 {
+            let region = ra.get_region_by_size(0x400, 1).unwrap();
+            assert_eq!(region.base, expected);
+            expected += 0x400;
+        }
+    }
+}
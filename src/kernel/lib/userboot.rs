@@ -94,7 +94,7 @@ unsafe impl Sync for UserbootState {}
 
 impl UserbootState {
     /// Create a new userboot state
-    pub fn new() -> Self {
+    pub const fn new() -> Self {
         Self {
             initialized: AtomicBool::new(false),
             vdso_base: AtomicU64::new(0),
@@ -109,7 +109,7 @@ impl UserbootState {
     /// # Returns
     ///
     /// Ok(()) on success, Err(status) on failure
-    pub fn attempt_userboot(&self) -> Result<(), i32> {
+    pub fn attempt_userboot(&self) -> core::result::Result<(), i32> {
         println!("Userboot: Attempting to bootstrap user process");
 
         // Get ramdisk if available
@@ -120,6 +120,11 @@ impl UserbootState {
             );
         }
 
+        // Map bootfs chunks as ZBI staging publishes them
+        if let Some(stream) = crate::kernel::lib::zbi::active_bootfs_stream() {
+            self.map_bootfs_streaming(stream)?;
+        }
+
         // Create stack VMO
         let stack_vmo = self.create_stack_vmo()?;
         println!("Userboot: Created stack VMO (size: {})", ZIRCON_DEFAULT_STACK_SIZE);
@@ -133,7 +138,7 @@ impl UserbootState {
         println!("Userboot: Created process and thread");
 
         // Map userboot image
-        let (vdso_base, entry) = self.map_userboot_image()?;
+        let (vdso_base, entry, image_len) = self.map_userboot_image()?;
         self.vdso_base.store(vdso_base, Ordering::Release);
         self.entry_point.store(entry, Ordering::Release);
 
@@ -141,6 +146,12 @@ impl UserbootState {
         let stack_base = self.map_stack()?;
         self.stack_base.store(stack_base, Ordering::Release);
 
+        // Prefault the fresh mappings so the first instructions of the
+        // process don't pay a serial demand fault per page of their own
+        // image and stack.
+        self.prefault_range(vdso_base, image_len);
+        self.prefault_range(stack_base, ZIRCON_DEFAULT_STACK_SIZE);
+
         // Compute stack pointer
         let sp = self.compute_initial_stack_pointer(stack_base);
         self.stack_pointer.store(sp, Ordering::Release);
@@ -156,14 +167,48 @@ impl UserbootState {
         Ok(())
     }
 
+    /// Map bootfs chunks as the ZBI stager publishes them
+    ///
+    /// Takes chunks in payload order, so mapping of early bootfs pages
+    /// overlaps with staging of later ones instead of waiting for the
+    /// whole payload.
+    fn map_bootfs_streaming(&self, stream: &crate::kernel::lib::zbi::BootfsStream) -> core::result::Result<(), i32> {
+        let mut mapped = 0usize;
+        while !stream.is_complete() {
+            match stream.next_ready() {
+                Some(chunk) => {
+                    // TODO: Map [chunk.offset, chunk.offset + chunk.len)
+                    // of the bootfs VMO into the child's address space.
+                    mapped += chunk.len;
+                }
+                None => core::hint::spin_loop(),
+            }
+        }
+        println!("Userboot: Mapped {:#x} bytes of bootfs", mapped);
+
+        // The payload is fully staged now; build the hashed name index
+        // so early userspace lookups don't linear-scan the directory.
+        match crate::kernel::lib::zbi::BootfsIndex::build(stream.staged_payload()) {
+            Ok(index) => {
+                println!("Userboot: Indexed {} bootfs entries", index.len());
+                crate::kernel::lib::zbi::publish_bootfs_index(index);
+            }
+            Err(e) => {
+                println!("Userboot: Bootfs index unavailable: {}", e);
+            }
+        }
+
+        Ok(())
+    }
+
     /// Create stack VMO
-    fn create_stack_vmo(&self) -> Result<(), i32> {
+    fn create_stack_vmo(&self) -> core::result::Result<(), i32> {
         // TODO: Implement VMO creation for stack
         Ok(())
     }
 
     /// Prepare bootstrap message
-    fn prepare_bootstrap_message(&self) -> Result<BootstrapMessage, i32> {
+    fn prepare_bootstrap_message(&self) -> core::result::Result<BootstrapMessage, i32> {
         let mut msg = BootstrapMessage {
             header: ProcArgs {
                 protocol: 0,
@@ -197,25 +242,51 @@ impl UserbootState {
     }
 
     /// Create process and thread
-    fn create_process_thread(&self) -> Result<(u32, u32), i32> {
+    fn create_process_thread(&self) -> core::result::Result<(u32, u32), i32> {
         // TODO: Implement process/thread creation
         // For now, return placeholder handles
         Ok((0, 0))
     }
 
     /// Map userboot image
-    fn map_userboot_image(&self) -> Result<(u64, u64), i32> {
+    fn map_userboot_image(&self) -> core::result::Result<(u64, u64, usize), i32> {
         // TODO: Implement userboot image mapping
-        // Return placeholder addresses
-        Ok((0x10000000, 0x10001000))
+        // Return placeholder addresses and image size
+        Ok((0x10000000, 0x10001000, 0x8000))
     }
 
     /// Map stack
-    fn map_stack(&self) -> Result<u64, i32> {
+    fn map_stack(&self) -> core::result::Result<u64, i32> {
         // TODO: Implement stack mapping
         Ok(0x20000000)
     }
 
+    /// Drive the page fault path over [base, base + len) ahead of time
+    ///
+    /// Each page is pushed through the standard handler as the user-mode
+    /// read of a not-present page that the first instruction touching it
+    /// would generate. Failures are ignored; those pages simply fault on
+    /// demand as before.
+    fn prefault_range(&self, base: u64, len: usize) {
+        const PAGE_SIZE: u64 = 4096;
+
+        let mut va = base & !(PAGE_SIZE - 1);
+        let end = base + len as u64;
+        let mut pages = 0usize;
+        while va < end {
+            let _ = crate::kernel::vm::fault::vm_page_fault_handler(
+                va as usize,
+                crate::kernel::vm::fault::PF_FLAG_NOT_PRESENT
+                    | crate::kernel::vm::fault::PF_FLAG_USER,
+                0,
+                true,
+            );
+            pages += 1;
+            va += PAGE_SIZE;
+        }
+        println!("Userboot: Prefaulted {} pages @ {:#x}", pages, base);
+    }
+
     /// Compute initial stack pointer
     fn compute_initial_stack_pointer(&self, stack_base: u64) -> u64 {
         stack_base + ZIRCON_DEFAULT_STACK_SIZE as u64
@@ -15,7 +15,7 @@ extern crate alloc;
 use alloc::format;
 use alloc::string::String;
 use alloc::sync::Arc;
-use core::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+use core::sync::atomic::{AtomicBool, AtomicU32, AtomicU64, Ordering};
 use spin::Mutex;
 
 use crate::rustux::types::*;
@@ -132,12 +132,8 @@ static HW_WATCHDOG: Mutex<HwWatchdogState> = Mutex::new(HwWatchdogState {
 });
 
 /// Get current time in nanoseconds
-///
-/// TODO: Implement proper time source
 fn get_current_time_ns() -> u64 {
-    // For now, return 0
-    // In real implementation, this would read from a time source
-    0
+    crate::kernel::timer::current_time()
 }
 
 /// Watchdog handler callback
@@ -224,10 +220,174 @@ pub fn hw_watchdog_timer_callback() {
     // Schedule next callback
     // TODO: timer_set_oneshot(get_current_time_ns() + pet_timeout, hw_watchdog_timer_callback, nullptr);
 
+    // The periodic pet path is a CPU that's demonstrably alive; have it
+    // look at everyone else before feeding the hardware dog.
+    sw_watchdog_check();
+
     // Pet the hardware watchdog
     watchdog_hw_pet();
 }
 
+/// ============================================================================
+/// Per-CPU Software Watchdog
+/// ============================================================================
+
+/// Default early-warning threshold in milliseconds
+///
+/// Well below the hardware reset timeout, so a stalled CPU gets its
+/// forensic snapshot out before the machine reboots.
+pub const SW_WATCHDOG_DEFAULT_WARN_MS: u64 = 1000;
+
+/// Software watchdog enabled flag
+static SW_WATCHDOG_ENABLED: AtomicBool = AtomicBool::new(false);
+
+/// Early-warning stall threshold in nanoseconds
+static SW_WARN_THRESHOLD_NS: AtomicU64 =
+    AtomicU64::new(SW_WATCHDOG_DEFAULT_WARN_MS * 1_000_000);
+
+/// ktrace probe tag for stall warnings (0 until registered)
+static SW_STALL_PROBE: AtomicU32 = AtomicU32::new(0);
+
+/// Per-CPU worst observed scheduler latency in nanoseconds
+///
+/// Recorded on every check pass, not just on warnings, so the
+/// telemetry shows how close each CPU gets to the threshold even on
+/// healthy boots.
+static SW_MAX_STALL_NS: [AtomicU64; crate::kernel::percpu::SMP_MAX_CPUS] = {
+    const INIT: AtomicU64 = AtomicU64::new(0);
+    [INIT; crate::kernel::percpu::SMP_MAX_CPUS]
+};
+
+/// Per-CPU warned latch; cleared when the CPU makes progress again
+static SW_WARNED: [AtomicBool; crate::kernel::percpu::SMP_MAX_CPUS] = {
+    const INIT: AtomicBool = AtomicBool::new(false);
+    [INIT; crate::kernel::percpu::SMP_MAX_CPUS]
+};
+
+/// Initialize the per-CPU software watchdog
+///
+/// # Arguments
+///
+/// * `warn_threshold_ms` - Stall duration that triggers the early
+///   warning (0 keeps the default)
+pub fn sw_watchdog_init(warn_threshold_ms: u64) {
+    let ms = if warn_threshold_ms == 0 {
+        SW_WATCHDOG_DEFAULT_WARN_MS
+    } else {
+        warn_threshold_ms
+    };
+    SW_WARN_THRESHOLD_NS.store(ms * 1_000_000, Ordering::Relaxed);
+    SW_STALL_PROBE.store(
+        crate::kernel::lib::ktrace::ktrace_add_probe("watchdog_cpu_stall"),
+        Ordering::Relaxed,
+    );
+    SW_WATCHDOG_ENABLED.store(true, Ordering::Release);
+
+    println!("Watchdog: per-CPU stall warning armed at {} ms", ms);
+}
+
+/// Enable or disable the software watchdog
+pub fn sw_watchdog_set_enabled(enabled: bool) {
+    SW_WATCHDOG_ENABLED.store(enabled, Ordering::Release);
+}
+
+/// Check every online CPU for scheduler stalls
+///
+/// Runs on whichever CPU services the periodic pet timer. Each CPU's
+/// last scheduler-progress timestamp (percpu heartbeat) is compared
+/// against now; crossing the threshold emits one early-warning
+/// snapshot per stall episode.
+pub fn sw_watchdog_check() {
+    if !SW_WATCHDOG_ENABLED.load(Ordering::Acquire) {
+        return;
+    }
+
+    let now = get_current_time_ns();
+    let self_cpu = crate::kernel::percpu::current_cpu_num() as usize;
+    let online = crate::kernel::mp::mp_get_online_mask();
+
+    for cpu in 0..crate::kernel::percpu::SMP_MAX_CPUS {
+        if cpu == self_cpu || online & crate::kernel::mp::cpu_num_to_mask(cpu as u32) == 0 {
+            continue;
+        }
+
+        let last = unsafe { crate::kernel::percpu::get_percpu(cpu).last_progress_ns() };
+        if last == 0 {
+            // CPU hasn't published a heartbeat yet (still booting).
+            continue;
+        }
+
+        let stall_ns = now.saturating_sub(last);
+        if sw_watchdog_observe(cpu, stall_ns) {
+            sw_watchdog_warn(cpu, stall_ns);
+        }
+    }
+}
+
+/// Record one stall observation for a CPU (internal)
+///
+/// Updates the latency telemetry and returns whether an early warning
+/// should fire: true exactly once per episode, when the stall first
+/// crosses the threshold. Progress resets the latch.
+fn sw_watchdog_observe(cpu: usize, stall_ns: u64) -> bool {
+    SW_MAX_STALL_NS[cpu].fetch_max(stall_ns, Ordering::Relaxed);
+
+    if stall_ns < SW_WARN_THRESHOLD_NS.load(Ordering::Relaxed) {
+        SW_WARNED[cpu].store(false, Ordering::Relaxed);
+        return false;
+    }
+
+    !SW_WARNED[cpu].swap(true, Ordering::Relaxed)
+}
+
+/// Emit the early-warning snapshot for a stalled CPU (internal)
+///
+/// This is the forensic record a hardware reset would destroy: who was
+/// running, for how long, plus the crashlog state, captured while the
+/// rest of the machine is still alive.
+fn sw_watchdog_warn(cpu: usize, stall_ns: u64) {
+    let percpu = unsafe { crate::kernel::percpu::get_percpu(cpu) };
+
+    println!(
+        "\nWATCHDOG: cpu {} has made no scheduler progress for {} ms (threshold {} ms)",
+        cpu,
+        stall_ns / 1_000_000,
+        SW_WARN_THRESHOLD_NS.load(Ordering::Relaxed) / 1_000_000
+    );
+    println!(
+        "WATCHDOG: cpu {} state={:?} current_thread={}",
+        cpu,
+        percpu.state(),
+        percpu.current_thread()
+    );
+
+    let probe = SW_STALL_PROBE.load(Ordering::Relaxed);
+    if probe != 0 {
+        crate::kernel::lib::ktrace::ktrace_write(probe, [cpu as u64, stall_ns, 0, 0]);
+    }
+
+    crate::kernel::lib::crashlog::crashlog_print();
+}
+
+/// Get the worst observed scheduler latency for a CPU
+pub fn sw_watchdog_max_stall_ns(cpu: usize) -> u64 {
+    SW_MAX_STALL_NS
+        .get(cpu)
+        .map(|v| v.load(Ordering::Relaxed))
+        .unwrap_or(0)
+}
+
+/// Dump the per-CPU latency telemetry
+pub fn sw_watchdog_dump() {
+    println!("Software watchdog latency telemetry:");
+    for cpu in 0..crate::kernel::percpu::SMP_MAX_CPUS {
+        let worst = SW_MAX_STALL_NS[cpu].load(Ordering::Relaxed);
+        if worst != 0 {
+            println!("  cpu {}: worst stall {} us", cpu, worst / 1_000);
+        }
+    }
+}
+
 /// Watchdog manager for managing multiple watchdogs
 pub struct WatchdogManager {
     /// List of registered watchdogs
@@ -328,6 +488,23 @@ mod tests {
         assert!(!wd.check_expired());
     }
 
+    #[test]
+    fn test_sw_watchdog_observe_latches_per_episode() {
+        SW_WARN_THRESHOLD_NS.store(1_000_000, Ordering::Relaxed);
+
+        // Below threshold: telemetry only, no warning.
+        assert!(!sw_watchdog_observe(7, 500_000));
+        // Crossing the threshold warns exactly once per episode.
+        assert!(sw_watchdog_observe(7, 2_000_000));
+        assert!(!sw_watchdog_observe(7, 3_000_000));
+        // Progress resets the latch; the next stall warns again.
+        assert!(!sw_watchdog_observe(7, 100_000));
+        assert!(sw_watchdog_observe(7, 4_000_000));
+
+        // The worst latency sticks across episodes.
+        assert_eq!(sw_watchdog_max_stall_ns(7), 4_000_000);
+    }
+
     #[test]
     fn test_watchdog_manager() {
         let mut manager = WatchdogManager::new();
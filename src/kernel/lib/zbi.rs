@@ -0,0 +1,761 @@
+// Copyright 2025 The Rustux Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+//! ZBI (Zircon Boot Image) Processing
+//!
+//! This module walks boot image items and stages large STORAGE payloads
+//! (bootfs) for userboot. Instead of decompressing the whole payload on
+//! one core before userboot runs, the payload is split into fixed-size
+//! chunks that are published as they complete, so `lib/userboot` can
+//! begin mapping early chunks while later ones are still being
+//! produced. When secondary CPUs are already online, chunk production
+//! is fanned out across them.
+
+#![no_std]
+
+extern crate alloc;
+
+use alloc::vec::Vec;
+use core::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
+
+use crate::rustux::types::*;
+use crate::rustux::types::err::*;
+
+/// ============================================================================
+/// ZBI Format Constants
+/// ============================================================================
+
+/// Container magic ("BOOT")
+pub const ZBI_CONTAINER_MAGIC: u32 = 0x8670_4279;
+
+/// Per-item magic
+pub const ZBI_ITEM_MAGIC: u32 = 0xb578_1729;
+
+/// Item payloads are aligned to this boundary
+pub const ZBI_ALIGNMENT: usize = 8;
+
+/// Container item type
+pub const ZBI_TYPE_CONTAINER: u32 = 0x544f_4f42; // BOOT
+
+/// Bootfs storage item type
+pub const ZBI_TYPE_STORAGE_BOOTFS: u32 = 0x4253_5442; // BTFS
+
+/// Ramdisk storage item type
+pub const ZBI_TYPE_STORAGE_RAMDISK: u32 = 0x4b53_4452; // RDSK
+
+/// Kernel command line item type
+pub const ZBI_TYPE_CMDLINE: u32 = 0x4c44_4d43; // CMDL
+
+/// Entropy handed over by the boot loader, used to seed the kernel PRNG
+pub const ZBI_TYPE_SECURE_ENTROPY: u32 = 0x444e_4152; // RAND
+
+/// Storage payload is compressed
+pub const ZBI_FLAG_STORAGE_COMPRESSED: u32 = 0x0000_0001;
+
+/// ============================================================================
+/// ZBI Header
+/// ============================================================================
+
+/// Header preceding every ZBI item
+#[repr(C)]
+#[derive(Debug, Clone, Copy)]
+pub struct ZbiHeader {
+    /// Item type (ZBI_TYPE_*)
+    pub item_type: u32,
+    /// Payload length, not including this header or alignment padding
+    pub length: u32,
+    /// Type-specific extra data; for STORAGE items, the uncompressed size
+    pub extra: u32,
+    /// Item flags (ZBI_FLAG_*)
+    pub flags: u32,
+    /// Reserved, must be zero
+    pub reserved0: u32,
+    /// Reserved, must be zero
+    pub reserved1: u32,
+    /// Must be ZBI_ITEM_MAGIC
+    pub magic: u32,
+    /// Item CRC32, or ZBI_ITEM_NO_CRC32
+    pub crc32: u32,
+}
+
+impl ZbiHeader {
+    /// Check the per-item magic
+    pub fn is_valid(&self) -> bool {
+        self.magic == ZBI_ITEM_MAGIC
+    }
+
+    /// Uncompressed payload size for STORAGE items
+    pub fn uncompressed_length(&self) -> usize {
+        if (self.flags & ZBI_FLAG_STORAGE_COMPRESSED) != 0 {
+            self.extra as usize
+        } else {
+            self.length as usize
+        }
+    }
+}
+
+/// Align an offset up to the next item boundary
+pub fn zbi_align(len: usize) -> usize {
+    (len + ZBI_ALIGNMENT - 1) & !(ZBI_ALIGNMENT - 1)
+}
+
+/// ============================================================================
+/// ZBI Item Iteration
+/// ============================================================================
+
+/// One item in a boot image
+#[derive(Debug, Clone, Copy)]
+pub struct ZbiItem {
+    /// The item's header
+    pub header: ZbiHeader,
+    /// Offset of the payload from the start of the image
+    pub payload_offset: usize,
+}
+
+/// Iterator over the items of a boot image
+pub struct ZbiIterator<'a> {
+    image: &'a [u8],
+    offset: usize,
+}
+
+impl<'a> ZbiIterator<'a> {
+    /// Create an iterator over the image, skipping the container header
+    ///
+    /// # Returns
+    ///
+    /// Err(RX_ERR_INVALID_ARGS) if the container header is malformed
+    pub fn new(image: &'a [u8]) -> core::result::Result<Self, rx_status_t> {
+        let container = match read_header(image, 0) {
+            Some(hdr) => hdr,
+            None => return Err(RX_ERR_INVALID_ARGS),
+        };
+        if container.item_type != ZBI_TYPE_CONTAINER
+            || container.extra != ZBI_CONTAINER_MAGIC
+            || !container.is_valid()
+        {
+            return Err(RX_ERR_INVALID_ARGS);
+        }
+        Ok(Self {
+            image,
+            offset: core::mem::size_of::<ZbiHeader>(),
+        })
+    }
+}
+
+impl<'a> Iterator for ZbiIterator<'a> {
+    type Item = ZbiItem;
+
+    fn next(&mut self) -> Option<ZbiItem> {
+        let header = read_header(self.image, self.offset)?;
+        if !header.is_valid() {
+            return None;
+        }
+        let payload_offset = self.offset + core::mem::size_of::<ZbiHeader>();
+        if payload_offset + header.length as usize > self.image.len() {
+            return None;
+        }
+        self.offset = payload_offset + zbi_align(header.length as usize);
+        Some(ZbiItem {
+            header,
+            payload_offset,
+        })
+    }
+}
+
+/// Read an item header at the given offset, if there is room for one
+fn read_header(image: &[u8], offset: usize) -> Option<ZbiHeader> {
+    if offset + core::mem::size_of::<ZbiHeader>() > image.len() {
+        return None;
+    }
+    // Safety: bounds checked above; ZbiHeader is repr(C) plain data and
+    // read_unaligned tolerates any payload alignment.
+    Some(unsafe {
+        core::ptr::read_unaligned(image.as_ptr().add(offset) as *const ZbiHeader)
+    })
+}
+
+/// ============================================================================
+/// Streaming Bootfs Staging
+/// ============================================================================
+
+/// Size of one staging chunk
+///
+/// Large enough that per-chunk hand-off overhead is negligible against
+/// the copy/decompress cost, small enough that userboot can start
+/// mapping well before a multi-hundred-MB bootfs is fully staged.
+pub const BOOTFS_CHUNK_SIZE: usize = 512 * 1024;
+
+/// One chunk of staged bootfs output
+pub struct BootfsChunk {
+    /// Offset of this chunk in the uncompressed payload
+    pub offset: usize,
+    /// Number of valid bytes at that offset
+    pub len: usize,
+    /// Set with Release once the chunk's bytes are in place
+    ready: AtomicBool,
+}
+
+/// A STORAGE payload being staged chunk-by-chunk
+///
+/// The producer side (`stage_chunk`, possibly running on several CPUs)
+/// fills chunks in any order and publishes each with a Release store;
+/// the consumer side (`next_ready`, userboot) takes chunks in payload
+/// order with an Acquire load, so the bytes of a chunk are visible
+/// before the consumer maps them.
+pub struct BootfsStream {
+    /// Source item payload within the boot image
+    src_base: *const u8,
+    src_len: usize,
+    /// Destination staging buffer (uncompressed payload)
+    dst_base: *mut u8,
+    dst_len: usize,
+    /// Whether the source is compressed
+    compressed: bool,
+    /// Per-chunk completion flags, in payload order
+    chunks: Vec<BootfsChunk>,
+    /// Next chunk index a producer should claim
+    next_to_stage: AtomicUsize,
+    /// Next chunk index the consumer will take
+    next_to_consume: AtomicUsize,
+}
+
+// The raw pointers refer to physmap addresses fixed for the life of the
+// stream; all cross-CPU hand-off goes through the atomics above.
+unsafe impl Send for BootfsStream {}
+unsafe impl Sync for BootfsStream {}
+
+impl BootfsStream {
+    /// Create a stream staging `item`'s payload from `image` into `dst`
+    ///
+    /// # Returns
+    ///
+    /// Err(RX_ERR_BUFFER_TOO_SMALL) if `dst` cannot hold the
+    /// uncompressed payload
+    pub fn new(image: &[u8], item: &ZbiItem, dst: *mut u8, dst_len: usize) -> core::result::Result<Self, rx_status_t> {
+        let out_len = item.header.uncompressed_length();
+        if out_len > dst_len {
+            return Err(RX_ERR_BUFFER_TOO_SMALL);
+        }
+
+        let num_chunks = (out_len + BOOTFS_CHUNK_SIZE - 1) / BOOTFS_CHUNK_SIZE;
+        let mut chunks = Vec::with_capacity(num_chunks);
+        for i in 0..num_chunks {
+            let offset = i * BOOTFS_CHUNK_SIZE;
+            chunks.push(BootfsChunk {
+                offset,
+                len: BOOTFS_CHUNK_SIZE.min(out_len - offset),
+                ready: AtomicBool::new(false),
+            });
+        }
+
+        Ok(Self {
+            src_base: unsafe { image.as_ptr().add(item.payload_offset) },
+            src_len: item.header.length as usize,
+            dst_base: dst,
+            dst_len: out_len,
+            compressed: (item.header.flags & ZBI_FLAG_STORAGE_COMPRESSED) != 0,
+            chunks,
+            next_to_stage: AtomicUsize::new(0),
+            next_to_consume: AtomicUsize::new(0),
+        })
+    }
+
+    /// Total number of chunks in the stream
+    pub fn num_chunks(&self) -> usize {
+        self.chunks.len()
+    }
+
+    /// Claim and stage the next unstaged chunk
+    ///
+    /// Safe to call concurrently from several CPUs; each call stages at
+    /// most one chunk. Returns false once every chunk has been claimed.
+    pub fn stage_chunk(&self) -> bool {
+        let ix = self.next_to_stage.fetch_add(1, Ordering::Relaxed);
+        if ix >= self.chunks.len() {
+            return false;
+        }
+        let chunk = &self.chunks[ix];
+
+        if self.compressed {
+            // TODO: Route through the boot image decompressor once one
+            // is ported. Compressed chunks can only be produced in
+            // order, so a compressed stream is staged by one producer.
+            // For now the payload is treated as stored uncompressed.
+        }
+        // Safety: each chunk index is claimed by exactly one producer,
+        // and the chunk ranges were sized against src/dst in new().
+        unsafe {
+            core::ptr::copy_nonoverlapping(
+                self.src_base.add(chunk.offset),
+                self.dst_base.add(chunk.offset),
+                chunk.len.min(self.src_len.saturating_sub(chunk.offset)),
+            );
+        }
+
+        chunk.ready.store(true, Ordering::Release);
+        true
+    }
+
+    /// Take the next in-order chunk if its bytes are in place
+    ///
+    /// Returns None either because the next chunk is not staged yet or
+    /// because the stream is exhausted; use `is_complete` to tell the
+    /// two apart.
+    pub fn next_ready(&self) -> Option<&BootfsChunk> {
+        let ix = self.next_to_consume.load(Ordering::Relaxed);
+        if ix >= self.chunks.len() {
+            return None;
+        }
+        if !self.chunks[ix].ready.load(Ordering::Acquire) {
+            return None;
+        }
+        self.next_to_consume.store(ix + 1, Ordering::Relaxed);
+        Some(&self.chunks[ix])
+    }
+
+    /// Whether the consumer has taken every chunk
+    pub fn is_complete(&self) -> bool {
+        self.next_to_consume.load(Ordering::Relaxed) >= self.chunks.len()
+    }
+
+    /// The fully staged payload
+    ///
+    /// Only valid once every chunk has been consumed (`is_complete`);
+    /// before that, parts of the buffer may still be being written.
+    pub fn staged_payload(&self) -> &[u8] {
+        debug_assert!(self.is_complete());
+        // Safety: the destination buffer was sized in new() and outlives
+        // the stream; completeness means every producer store has been
+        // observed through the per-chunk Acquire loads.
+        unsafe { core::slice::from_raw_parts(self.dst_base, self.dst_len) }
+    }
+}
+
+/// ============================================================================
+/// Active Stream Hand-off
+/// ============================================================================
+
+/// The bootfs stream currently being staged, if any (as a raw pointer)
+static ACTIVE_BOOTFS_STREAM: AtomicUsize = AtomicUsize::new(0);
+
+/// Publish `stream` for userboot to consume
+///
+/// Called by the platform ZBI walker before staging begins, so that
+/// userboot can overlap mapping with staging. The stream must stay
+/// alive until userboot has drained it.
+pub fn publish_bootfs_stream(stream: &'static BootfsStream) {
+    ACTIVE_BOOTFS_STREAM.store(stream as *const BootfsStream as usize, Ordering::Release);
+}
+
+/// Get the bootfs stream being staged, if any
+pub fn active_bootfs_stream() -> Option<&'static BootfsStream> {
+    let ptr = ACTIVE_BOOTFS_STREAM.load(Ordering::Acquire) as *const BootfsStream;
+    // Safety: publishers guarantee the stream outlives the consumer.
+    unsafe { ptr.as_ref() }
+}
+
+/// ============================================================================
+/// Parallel Staging
+/// ============================================================================
+
+/// Stage every chunk of `stream`, fanning work out to online CPUs
+///
+/// The calling CPU always participates, so this works before any
+/// secondary CPU is up. Producers claim chunks from the shared
+/// `next_to_stage` counter, so the split adapts to however many CPUs
+/// answer the IPI.
+pub fn stage_bootfs_parallel(stream: &BootfsStream) {
+    use crate::kernel::mp;
+
+    let online = mp::mp_get_online_mask();
+    let others = online & !mp::cpu_num_to_mask(mp::arch_curr_cpu_num());
+
+    // Compressed streams must be produced in order; see stage_chunk().
+    if others != 0 && !stream_is_compressed(stream) {
+        mp::mp_sync_exec(
+            mp::MpIpiTarget::Mask,
+            others,
+            stage_chunks_task,
+            stream as *const BootfsStream as u64,
+        );
+    }
+
+    while stream.stage_chunk() {}
+}
+
+fn stream_is_compressed(stream: &BootfsStream) -> bool {
+    stream.compressed
+}
+
+/// mp_sync_exec task: drain the chunk counter on a helper CPU
+unsafe fn stage_chunks_task(context: u64) {
+    let stream = &*(context as *const BootfsStream);
+    while stream.stage_chunk() {}
+}
+
+/// ============================================================================
+/// Bootfs Name Index
+/// ============================================================================
+
+/// Bootfs payload magic
+pub const BOOTFS_MAGIC: u32 = 0xa56d_3ff9;
+
+/// Header at the start of a bootfs payload
+#[repr(C)]
+#[derive(Debug, Clone, Copy)]
+pub struct BootfsHeader {
+    /// Must be BOOTFS_MAGIC
+    pub magic: u32,
+    /// Total size of the directory entries that follow
+    pub dirent_size: u32,
+    /// Reserved, must be zero
+    pub reserved0: u32,
+    /// Reserved, must be zero
+    pub reserved1: u32,
+}
+
+/// Number of hash buckets; bootfs images carry a few hundred entries at
+/// most, so short chains are enough
+const BOOTFS_INDEX_BUCKETS: usize = 64;
+
+/// Chain terminator in bucket heads and entry links
+const BOOTFS_NO_ENTRY: u32 = u32::MAX;
+
+/// One indexed bootfs entry
+struct BootfsEntry {
+    /// Entry name, without the trailing NUL
+    name: Vec<u8>,
+    /// Offset of the entry's data in the payload
+    data_off: u32,
+    /// Size of the entry's data
+    data_len: u32,
+    /// Next entry in the same hash bucket
+    next: u32,
+}
+
+/// Hashed name index over a bootfs directory
+///
+/// The directory format is a packed run of dirents, each
+/// `{name_len, data_len, data_off}` followed by a NUL-terminated name
+/// and padding to 4 bytes. Walking that run is O(entries) per lookup;
+/// the index is built once while the payload is being processed so
+/// early userspace lookups are a hash and a short chain instead.
+pub struct BootfsIndex {
+    entries: Vec<BootfsEntry>,
+    buckets: [u32; BOOTFS_INDEX_BUCKETS],
+}
+
+/// FNV-1a over the entry name
+fn bootfs_name_hash(name: &[u8]) -> usize {
+    let mut hash: u32 = 0x811c_9dc5;
+    for &b in name {
+        hash ^= b as u32;
+        hash = hash.wrapping_mul(0x0100_0193);
+    }
+    hash as usize % BOOTFS_INDEX_BUCKETS
+}
+
+impl BootfsIndex {
+    /// Parse a fully staged bootfs payload into an index
+    ///
+    /// # Returns
+    ///
+    /// Err(RX_ERR_INVALID_ARGS) if the header or a dirent is malformed
+    pub fn build(payload: &[u8]) -> core::result::Result<Self, rx_status_t> {
+        const HEADER_SIZE: usize = core::mem::size_of::<BootfsHeader>();
+        const DIRENT_FIXED: usize = 3 * core::mem::size_of::<u32>();
+
+        if payload.len() < HEADER_SIZE {
+            return Err(RX_ERR_INVALID_ARGS);
+        }
+        let read_u32 = |off: usize| -> u32 {
+            u32::from_le_bytes([
+                payload[off],
+                payload[off + 1],
+                payload[off + 2],
+                payload[off + 3],
+            ])
+        };
+        if read_u32(0) != BOOTFS_MAGIC {
+            return Err(RX_ERR_INVALID_ARGS);
+        }
+        let dirent_size = read_u32(4) as usize;
+        if HEADER_SIZE + dirent_size > payload.len() {
+            return Err(RX_ERR_INVALID_ARGS);
+        }
+
+        let mut index = Self {
+            entries: Vec::new(),
+            buckets: [BOOTFS_NO_ENTRY; BOOTFS_INDEX_BUCKETS],
+        };
+
+        let mut off = HEADER_SIZE;
+        let dir_end = HEADER_SIZE + dirent_size;
+        while off + DIRENT_FIXED <= dir_end {
+            let name_len = read_u32(off) as usize;
+            let data_len = read_u32(off + 4);
+            let data_off = read_u32(off + 8);
+
+            // names are NUL-terminated in the image
+            if name_len == 0 || off + DIRENT_FIXED + name_len > dir_end {
+                return Err(RX_ERR_INVALID_ARGS);
+            }
+            if data_off as usize + data_len as usize > payload.len() {
+                return Err(RX_ERR_INVALID_ARGS);
+            }
+            let name = &payload[off + DIRENT_FIXED..off + DIRENT_FIXED + name_len - 1];
+
+            let bucket = bootfs_name_hash(name);
+            let entry_ix = index.entries.len() as u32;
+            index.entries.push(BootfsEntry {
+                name: name.to_vec(),
+                data_off,
+                data_len,
+                next: index.buckets[bucket],
+            });
+            index.buckets[bucket] = entry_ix;
+
+            // dirents are padded to 4 bytes, unlike item payloads
+            off += (DIRENT_FIXED + name_len + 3) & !3;
+        }
+
+        Ok(index)
+    }
+
+    /// Look up an entry by name
+    ///
+    /// # Returns
+    ///
+    /// Some((data_off, data_len)) if the name is present
+    pub fn lookup(&self, name: &str) -> Option<(u32, u32)> {
+        let mut ix = self.buckets[bootfs_name_hash(name.as_bytes())];
+        while ix != BOOTFS_NO_ENTRY {
+            let entry = &self.entries[ix as usize];
+            if entry.name == name.as_bytes() {
+                return Some((entry.data_off, entry.data_len));
+            }
+            ix = entry.next;
+        }
+        None
+    }
+
+    /// Number of indexed entries
+    pub fn len(&self) -> usize {
+        self.entries.len()
+    }
+
+    /// Whether the index holds no entries
+    pub fn is_empty(&self) -> bool {
+        self.entries.is_empty()
+    }
+}
+
+/// The published index over the active bootfs, if any
+static BOOTFS_INDEX: spin::Mutex<Option<BootfsIndex>> = spin::Mutex::new(None);
+
+/// Publish `index` for early userspace lookups
+pub fn publish_bootfs_index(index: BootfsIndex) {
+    *BOOTFS_INDEX.lock() = Some(index);
+}
+
+/// Look up a bootfs entry by name in the published index
+///
+/// # Returns
+///
+/// Some((data_off, data_len)) if an index is published and has the name
+pub fn bootfs_index_lookup(name: &str) -> Option<(u32, u32)> {
+    BOOTFS_INDEX.lock().as_ref().and_then(|index| index.lookup(name))
+}
+
+/// ============================================================================
+/// Tests
+/// ============================================================================
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use alloc::vec;
+
+    fn make_image(items: &[(u32, &[u8])]) -> Vec<u8> {
+        let mut image = vec![0u8; core::mem::size_of::<ZbiHeader>()];
+        for (item_type, payload) in items {
+            let hdr = ZbiHeader {
+                item_type: *item_type,
+                length: payload.len() as u32,
+                extra: 0,
+                flags: 0,
+                reserved0: 0,
+                reserved1: 0,
+                magic: ZBI_ITEM_MAGIC,
+                crc32: 0,
+            };
+            let hdr_bytes = unsafe {
+                core::slice::from_raw_parts(
+                    &hdr as *const ZbiHeader as *const u8,
+                    core::mem::size_of::<ZbiHeader>(),
+                )
+            };
+            image.extend_from_slice(hdr_bytes);
+            image.extend_from_slice(payload);
+            image.resize(zbi_align(image.len()), 0);
+        }
+        let container = ZbiHeader {
+            item_type: ZBI_TYPE_CONTAINER,
+            length: (image.len() - core::mem::size_of::<ZbiHeader>()) as u32,
+            extra: ZBI_CONTAINER_MAGIC,
+            flags: 0,
+            reserved0: 0,
+            reserved1: 0,
+            magic: ZBI_ITEM_MAGIC,
+            crc32: 0,
+        };
+        let hdr_bytes = unsafe {
+            core::slice::from_raw_parts(
+                &container as *const ZbiHeader as *const u8,
+                core::mem::size_of::<ZbiHeader>(),
+            )
+        };
+        image[..core::mem::size_of::<ZbiHeader>()].copy_from_slice(hdr_bytes);
+        image
+    }
+
+    #[test]
+    fn test_align() {
+        assert_eq!(zbi_align(0), 0);
+        assert_eq!(zbi_align(1), 8);
+        assert_eq!(zbi_align(8), 8);
+        assert_eq!(zbi_align(9), 16);
+    }
+
+    #[test]
+    fn test_iterate_items() {
+        let image = make_image(&[
+            (ZBI_TYPE_CMDLINE, b"hello"),
+            (ZBI_TYPE_STORAGE_BOOTFS, b"payload bytes"),
+        ]);
+        let items: Vec<ZbiItem> = ZbiIterator::new(&image).unwrap().collect();
+        assert_eq!(items.len(), 2);
+        assert_eq!(items[0].header.item_type, ZBI_TYPE_CMDLINE);
+        assert_eq!(items[0].header.length, 5);
+        assert_eq!(items[1].header.item_type, ZBI_TYPE_STORAGE_BOOTFS);
+        assert_eq!(
+            &image[items[1].payload_offset..items[1].payload_offset + 13],
+            b"payload bytes"
+        );
+    }
+
+    #[test]
+    fn test_bad_container() {
+        let image = vec![0u8; 64];
+        assert!(ZbiIterator::new(&image).is_err());
+    }
+
+    #[test]
+    fn test_streaming_hand_off() {
+        let payload = vec![0xabu8; BOOTFS_CHUNK_SIZE + 100];
+        let image = make_image(&[(ZBI_TYPE_STORAGE_BOOTFS, &payload)]);
+        let item = ZbiIterator::new(&image).unwrap().next().unwrap();
+
+        let mut dst = vec![0u8; payload.len()];
+        let stream =
+            BootfsStream::new(&image, &item, dst.as_mut_ptr(), dst.len()).unwrap();
+        assert_eq!(stream.num_chunks(), 2);
+
+        // Nothing staged yet: consumer must wait
+        assert!(stream.next_ready().is_none());
+
+        // Stage the first chunk; exactly one becomes consumable
+        assert!(stream.stage_chunk());
+        let chunk = stream.next_ready().unwrap();
+        assert_eq!(chunk.offset, 0);
+        assert_eq!(chunk.len, BOOTFS_CHUNK_SIZE);
+        assert!(stream.next_ready().is_none());
+        assert!(!stream.is_complete());
+
+        // Stage the rest and drain
+        assert!(stream.stage_chunk());
+        assert!(!stream.stage_chunk());
+        let chunk = stream.next_ready().unwrap();
+        assert_eq!(chunk.offset, BOOTFS_CHUNK_SIZE);
+        assert_eq!(chunk.len, 100);
+        assert!(stream.is_complete());
+        assert_eq!(dst, payload);
+    }
+
+    fn make_bootfs(entries: &[(&str, &[u8])]) -> Vec<u8> {
+        const HEADER_SIZE: usize = core::mem::size_of::<BootfsHeader>();
+        const DIRENT_FIXED: usize = 3 * core::mem::size_of::<u32>();
+
+        // lay out the directory first to learn where data can start
+        let mut dirent_size = 0;
+        for (name, _) in entries {
+            dirent_size += (DIRENT_FIXED + name.len() + 1 + 3) & !3;
+        }
+
+        let mut payload = vec![0u8; HEADER_SIZE];
+        payload[0..4].copy_from_slice(&BOOTFS_MAGIC.to_le_bytes());
+        payload[4..8].copy_from_slice(&(dirent_size as u32).to_le_bytes());
+
+        let mut data_off = HEADER_SIZE + dirent_size;
+        for (name, data) in entries {
+            payload.extend_from_slice(&((name.len() + 1) as u32).to_le_bytes());
+            payload.extend_from_slice(&(data.len() as u32).to_le_bytes());
+            payload.extend_from_slice(&(data_off as u32).to_le_bytes());
+            payload.extend_from_slice(name.as_bytes());
+            payload.push(0);
+            payload.resize((payload.len() + 3) & !3, 0);
+            data_off += data.len();
+        }
+        for (_, data) in entries {
+            payload.extend_from_slice(data);
+        }
+        payload
+    }
+
+    #[test]
+    fn test_bootfs_index_lookup() {
+        let payload = make_bootfs(&[
+            ("bin/userboot", b"aaaa"),
+            ("lib/libc.so", b"bbbbbb"),
+            ("data/empty", b""),
+        ]);
+        let index = BootfsIndex::build(&payload).unwrap();
+        assert_eq!(index.len(), 3);
+
+        let (off, len) = index.lookup("lib/libc.so").unwrap();
+        assert_eq!(len, 6);
+        assert_eq!(&payload[off as usize..(off + len) as usize], b"bbbbbb");
+
+        assert!(index.lookup("bin/userboot").is_some());
+        assert_eq!(index.lookup("data/empty").unwrap().1, 0);
+        assert!(index.lookup("bin/missing").is_none());
+        assert!(index.lookup("").is_none());
+    }
+
+    #[test]
+    fn test_bootfs_index_bad_payload() {
+        assert!(BootfsIndex::build(&[0u8; 4]).is_err());
+
+        // right size, wrong magic
+        let mut payload = make_bootfs(&[("a", b"x")]);
+        payload[0] ^= 0xff;
+        assert!(BootfsIndex::build(&payload).is_err());
+
+        // dirent data range points past the payload
+        let mut payload = make_bootfs(&[("a", b"x")]);
+        let fixed = core::mem::size_of::<BootfsHeader>();
+        payload[fixed + 4..fixed + 8].copy_from_slice(&u32::MAX.to_le_bytes());
+        assert!(BootfsIndex::build(&payload).is_err());
+    }
+
+    #[test]
+    fn test_dst_too_small() {
+        let image = make_image(&[(ZBI_TYPE_STORAGE_BOOTFS, b"payload")]);
+        let item = ZbiIterator::new(&image).unwrap().next().unwrap();
+        let mut dst = [0u8; 4];
+        assert!(BootfsStream::new(&image, &item, dst.as_mut_ptr(), dst.len()).is_err());
+    }
+}
@@ -49,6 +49,7 @@ pub mod cmdline;
 pub mod debug;
 pub mod dpc;
 pub mod hypervisor;
+pub mod idle;
 pub mod init;
 pub mod mp;
 pub mod object;
@@ -38,7 +38,7 @@ use crate::kernel::sync::Mutex;
 use crate::kernel::percpu;
 use crate::rustux::types::*;
 use crate::rustux::types::err::*;
-use core::sync::atomic::{AtomicBool, AtomicU64, AtomicU32, Ordering};
+use core::sync::atomic::{AtomicBool, AtomicU64, AtomicU32, AtomicUsize, Ordering};
 use core::mem::MaybeUninit;
 
 // Import logging macros
@@ -333,6 +333,23 @@ pub fn mp_reschedule(mask: CpuMask, flags: u32) {
         return;
     }
 
+    // Wake CPUs parked in monitor/mwait with a store to their wake word
+    // instead of an IPI; deep-idle IPI delivery dominates cross-core wakeup
+    // latency.
+    let mut remaining = target_mask;
+    while remaining != 0 {
+        let cpu = highest_cpu_set(remaining);
+        remaining &= !cpu_num_to_mask(cpu);
+
+        if crate::kernel::idle::try_wake_cpu(cpu) {
+            target_mask &= !cpu_num_to_mask(cpu);
+        }
+    }
+
+    if target_mask == 0 {
+        return;
+    }
+
     // Call architecture-specific reschedule
     #[cfg(target_arch = "aarch64")]
     {
@@ -386,6 +403,111 @@ pub fn mp_send_ipi(target: MpIpiTarget, mask: CpuMask, ipi_type: MpIpiType) {
     }
 }
 
+/// ============================================================================
+/// Hierarchical Sync Exec
+/// ============================================================================
+
+/// Fan-out arity of the sync-exec tree. Four children per node keeps the
+/// tree shallow while each parent still polls only a handful of ack
+/// lines; a flat broadcast instead funnels every acknowledgment through
+/// one cache line that bounces across all N participants.
+const SYNC_TREE_FANOUT: usize = 4;
+
+/// One CPU's fan-in flag, alone on its cache line so a parent polling a
+/// child's acknowledgment never contends with other subtrees' traffic.
+#[repr(align(64))]
+struct SyncAckLine {
+    /// Generation of the last operation whose whole subtree finished here
+    done_gen: AtomicU64,
+}
+
+const SYNC_ACK_INIT: SyncAckLine = SyncAckLine { done_gen: AtomicU64::new(0) };
+const SYNC_U32_INIT: AtomicU32 = AtomicU32::new(0);
+const SYNC_U64_INIT: AtomicU64 = AtomicU64::new(0);
+
+/// Generation counter of sync operations; bumped under ipi_task_lock
+static SYNC_GEN: AtomicU64 = AtomicU64::new(0);
+
+/// Task and context of the current operation
+static SYNC_TASK: AtomicUsize = AtomicUsize::new(0);
+static SYNC_CONTEXT: AtomicU64 = AtomicU64::new(0);
+
+/// Remote participants of the current operation, laid out level by level:
+/// the initiator kicks indexes 0..FANOUT, and index i forwards to
+/// (i+1)*FANOUT..(i+1)*FANOUT+FANOUT
+static SYNC_PARTICIPANTS: [AtomicU32; 64] = [SYNC_U32_INIT; 64];
+static SYNC_NUM_PARTICIPANTS: AtomicU32 = AtomicU32::new(0);
+
+/// Per-subtree fan-in flags
+static SYNC_ACKS: [SyncAckLine; SMP_MAX_CPUS as usize] =
+    [SYNC_ACK_INIT; SMP_MAX_CPUS as usize];
+
+/// Last generation each CPU has processed; only touched by its own CPU
+static SYNC_SEEN: [AtomicU64; SMP_MAX_CPUS as usize] =
+    [SYNC_U64_INIT; SMP_MAX_CPUS as usize];
+
+/// Child participant indexes of participant index `idx`
+fn sync_tree_children(idx: usize, count: usize) -> core::ops::Range<usize> {
+    let first = (idx + 1) * SYNC_TREE_FANOUT;
+    first.min(count)..(first + SYNC_TREE_FANOUT).min(count)
+}
+
+/// Run the current sync operation on this CPU
+///
+/// Called from the generic IPI handler. Forwards the IPI to this node's
+/// children first so the subtrees run in parallel with our own task,
+/// then waits for the children's subtree flags and raises our own -
+/// the whole fan-in is log-depth with each flag shared by one parent
+/// and at most SYNC_TREE_FANOUT children.
+fn sync_exec_participate(cpu: u32) {
+    let gen = SYNC_GEN.load(Ordering::Acquire);
+    if gen == 0 || SYNC_SEEN[cpu as usize].swap(gen, Ordering::Relaxed) == gen {
+        return;
+    }
+
+    let count = SYNC_NUM_PARTICIPANTS.load(Ordering::Relaxed) as usize;
+    let mut my_idx = None;
+    for i in 0..count {
+        if SYNC_PARTICIPANTS[i].load(Ordering::Relaxed) == cpu {
+            my_idx = Some(i);
+            break;
+        }
+    }
+    let idx = match my_idx {
+        Some(i) => i,
+        // Stale IPI from an operation that didn't target this CPU
+        None => return,
+    };
+
+    // Fan out before doing our own work.
+    let children = sync_tree_children(idx, count);
+    let mut child_mask: CpuMask = 0;
+    for child in children.clone() {
+        child_mask |= cpu_num_to_mask(SYNC_PARTICIPANTS[child].load(Ordering::Relaxed));
+    }
+    if child_mask != 0 {
+        mp_send_ipi(MpIpiTarget::Mask, child_mask, MpIpiType::Generic);
+    }
+
+    let task_ptr = SYNC_TASK.load(Ordering::Relaxed);
+    let context = SYNC_CONTEXT.load(Ordering::Relaxed);
+    if task_ptr != 0 {
+        let task: MpIpiTaskCallback = unsafe { core::mem::transmute(task_ptr) };
+        unsafe {
+            task(context);
+        }
+    }
+
+    // Fan in: a child's flag already covers its whole subtree.
+    for child in children {
+        let child_cpu = SYNC_PARTICIPANTS[child].load(Ordering::Relaxed) as usize;
+        while SYNC_ACKS[child_cpu].done_gen.load(Ordering::Acquire) != gen {
+            core::hint::spin_loop();
+        }
+    }
+    SYNC_ACKS[cpu as usize].done_gen.store(gen, Ordering::Release);
+}
+
 /// Execute a task synchronously on multiple CPUs
 ///
 /// # Arguments
@@ -395,7 +517,12 @@ pub fn mp_send_ipi(target: MpIpiTarget, mask: CpuMask, ipi_type: MpIpiType) {
 /// * `task` - Task to execute
 /// * `context` - Context argument for task
 ///
-/// Blocks until all CPUs have completed the task.
+/// Blocks until all CPUs have completed the task. The IPIs fan out
+/// through a tree: the initiator kicks SYNC_TREE_FANOUT roots, each
+/// participant forwards to its children before running the task, and
+/// acknowledgments fan back in along the same edges. Latency therefore
+/// grows with the depth of the tree rather than with N serialized
+/// acknowledgments on one shared line.
 pub fn mp_sync_exec(
     target: MpIpiTarget,
     mask: CpuMask,
@@ -412,55 +539,58 @@ pub fn mp_sync_exec(
     };
 
     let local_cpu = percpu::current_cpu_num() as u32;
+    let remote_mask = target_mask & !cpu_num_to_mask(local_cpu);
 
-    // Remove local CPU from target
-    let mut remote_mask = target_mask & !cpu_num_to_mask(local_cpu);
+    if remote_mask == 0 {
+        if (target_mask & cpu_num_to_mask(local_cpu)) != 0 {
+            unsafe {
+                task(context);
+            }
+        }
+        return;
+    }
 
-    // Count outstanding CPUs
-    let mut outstanding = remote_mask;
-    let mut num_remote = 0;
+    // One operation at a time; the lock also orders the participant
+    // table and task slots against the generation bump that publishes
+    // them.
+    let _lock = get_state().ipi_task_lock.lock();
 
-    // Create sync tasks for each CPU
-    // Note: We can't use const array initialization with function pointers,
-    // so we initialize the array using unsafe code
-    let mut sync_tasks: [MpIpiTask; SMP_MAX_CPUS as usize] = unsafe { core::mem::zeroed() };
-    for i in 0..SMP_MAX_CPUS as usize {
-        sync_tasks[i] = MpIpiTask {
-            func: task,
-            context: 0,
-            next: None,
-        };
+    let mut count = 0usize;
+    let mut rem = remote_mask;
+    while rem != 0 && count < SYNC_PARTICIPANTS.len() {
+        let cpu = rem.trailing_zeros();
+        rem &= !cpu_num_to_mask(cpu);
+        SYNC_PARTICIPANTS[count].store(cpu, Ordering::Relaxed);
+        count += 1;
     }
+    SYNC_NUM_PARTICIPANTS.store(count as u32, Ordering::Relaxed);
+    SYNC_TASK.store(task as usize, Ordering::Relaxed);
+    SYNC_CONTEXT.store(context, Ordering::Relaxed);
+    let gen = SYNC_GEN.fetch_add(1, Ordering::AcqRel) + 1;
 
-    unsafe {
-        // Enqueue tasks
-        let _lock = get_state().ipi_task_lock.lock();
-
-        let mut cpu_id = 0;
-        while remote_mask != 0 && cpu_id < SMP_MAX_CPUS {
-            if (remote_mask & 1) != 0 {
-                // Enqueue task for this CPU
-                // In a real implementation, this would add to the queue
-                num_remote += 1;
-            }
-            remote_mask >>= 1;
-            cpu_id += 1;
-        }
-
-        // Send IPIs to begin execution
-        mp_send_ipi(MpIpiTarget::Mask, target_mask & !cpu_num_to_mask(local_cpu), MpIpiType::Generic);
+    // Kick only the tree roots; they forward down their subtrees while
+    // the initiator runs its own share of the work.
+    let mut root_mask: CpuMask = 0;
+    for i in 0..count.min(SYNC_TREE_FANOUT) {
+        root_mask |= cpu_num_to_mask(SYNC_PARTICIPANTS[i].load(Ordering::Relaxed));
     }
+    mp_send_ipi(MpIpiTarget::Mask, root_mask, MpIpiType::Generic);
 
-    // Execute on local CPU if needed
     if (target_mask & cpu_num_to_mask(local_cpu)) != 0 {
         unsafe {
             task(context);
         }
     }
 
-    // Wait for all remote CPUs to complete
-    // In a real implementation, this would poll the outstanding mask
-    let _ = (num_remote, sync_tasks);
+    // Fan in: each root's flag covers its whole subtree, so the
+    // initiator polls at most SYNC_TREE_FANOUT lines no matter how many
+    // CPUs took part.
+    for i in 0..count.min(SYNC_TREE_FANOUT) {
+        let root_cpu = SYNC_PARTICIPANTS[i].load(Ordering::Relaxed) as usize;
+        while SYNC_ACKS[root_cpu].done_gen.load(Ordering::Acquire) != gen {
+            core::hint::spin_loop();
+        }
+    }
 }
 
 /// Handle generic IPI
@@ -473,6 +603,10 @@ pub fn mp_mbx_generic_irq() {
         return;
     }
 
+    // Take part in a pending sync-exec operation (tree fan-out) first;
+    // its initiator is spin-waiting on our subtree's ack line.
+    sync_exec_participate(local_cpu as u32);
+
     // Process all tasks in queue
     loop {
         let task = unsafe {
@@ -496,6 +630,11 @@ pub fn mp_mbx_reschedule_irq() {
     let local_cpu = percpu::current_cpu_num() as u32;
 
     if mp_is_cpu_active(local_cpu) {
+        // A tickless CPU gets its tick back before the scheduler looks at
+        // the queue, so whatever this IPI delivered cannot be stranded
+        // behind a masked timer.
+        crate::kernel::sched::dyntick::kicked(local_cpu as usize);
+
         // Trigger preemption
         crate::kernel::sched::timer_tick();
     }
@@ -721,7 +860,7 @@ mod tests {
         };
 
         unsafe {
-            let static_task = &task as *const MpIpiTask as &'static MpIpiTask;
+            let static_task = &*(&task as *const MpIpiTask);
             queue.push(static_task);
         }
 
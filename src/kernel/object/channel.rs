@@ -32,6 +32,7 @@ use crate::kernel::sync::Mutex;
 use crate::rustux::types::*;
 use crate::rustux::types::err::*;
 use alloc::collections::VecDeque;
+use alloc::sync::Arc;
 use alloc::vec::Vec;
 use core::sync::atomic::{AtomicBool, AtomicU64, AtomicUsize, Ordering};
 
@@ -129,6 +130,35 @@ impl ChannelState {
 /// Channel
 /// ============================================================================
 
+/// One direction of a channel: the queue feeding a single endpoint.
+///
+/// Both endpoints hold an `Arc` to each side — one as their own receive
+/// queue, the other as the peer's receive queue that their writes land in.
+struct Side {
+    /// Pending messages
+    queue: Mutex<VecDeque<Message>>,
+
+    /// Bytes queued (data plus handle payload)
+    queue_size: AtomicUsize,
+
+    /// Signaled while messages are pending
+    read_event: Event,
+
+    /// Signaled while the queue has room for more writes
+    write_event: Event,
+}
+
+impl Side {
+    fn new() -> Self {
+        Self {
+            queue: Mutex::new(VecDeque::new()),
+            queue_size: AtomicUsize::new(0),
+            read_event: Event::new(false, EventFlags::empty()),
+            write_event: Event::new(true, EventFlags::empty()), // Initially writable
+        }
+    }
+}
+
 /// Channel endpoint
 ///
 /// Represents one endpoint of a bidirectional channel.
@@ -139,21 +169,15 @@ pub struct Channel {
     /// Peer channel ID
     pub peer: Mutex<Option<ChannelId>>,
 
-    /// Message queue
-    pub queue: Mutex<VecDeque<Message>>,
+    /// Messages queued for this endpoint to read
+    rx: Arc<Side>,
+
+    /// The peer's receive queue; writes from this endpoint land here
+    tx: Arc<Side>,
 
     /// Maximum queue depth (in bytes)
     pub max_queue_bytes: usize,
 
-    /// Current queue size (in bytes)
-    pub queue_size: AtomicUsize,
-
-    /// Read event (signaled when messages available)
-    pub read_event: Event,
-
-    /// Write event (signaled when space available)
-    pub write_event: Event,
-
     /// Channel state
     pub state: Mutex<ChannelState>,
 
@@ -174,14 +198,16 @@ impl Channel {
         let id_a = alloc_channel_id();
         let id_b = alloc_channel_id();
 
+        // Each endpoint reads from its own side and writes into the peer's.
+        let side_a = Arc::new(Side::new());
+        let side_b = Arc::new(Side::new());
+
         let channel_a = Self {
             id: id_a,
             peer: Mutex::new(Some(id_b)),
-            queue: Mutex::new(VecDeque::new()),
+            rx: side_a.clone(),
+            tx: side_b.clone(),
             max_queue_bytes: 256 * 1024, // 256KB default
-            queue_size: AtomicUsize::new(0),
-            read_event: Event::new(false, EventFlags::empty()),
-            write_event: Event::new(true, EventFlags::empty()), // Initially writable
             state: Mutex::new(ChannelState::Active),
             waiter_count: AtomicUsize::new(0),
             ref_count: AtomicUsize::new(1),
@@ -190,11 +216,9 @@ impl Channel {
         let channel_b = Self {
             id: id_b,
             peer: Mutex::new(Some(id_a)),
-            queue: Mutex::new(VecDeque::new()),
+            rx: side_b,
+            tx: side_a,
             max_queue_bytes: 256 * 1024,
-            queue_size: AtomicUsize::new(0),
-            read_event: Event::new(false, EventFlags::empty()),
-            write_event: Event::new(true, EventFlags::empty()),
             state: Mutex::new(ChannelState::Active),
             waiter_count: AtomicUsize::new(0),
             ref_count: AtomicUsize::new(1),
@@ -235,12 +259,12 @@ impl Channel {
             h.require(Rights::TRANSFER)?;
         }
 
-        // Check queue capacity
+        // Check capacity of the peer's receive queue
         let data_size = data.len();
         let handles_size = handles.len() * core::mem::size_of::<Handle>();
         let total_size = data_size + handles_size;
 
-        if self.queue_size.load(Ordering::Acquire) + total_size > self.max_queue_bytes {
+        if self.tx.queue_size.load(Ordering::Acquire) + total_size > self.max_queue_bytes {
             return Err(RX_ERR_SHOULD_WAIT);
         }
 
@@ -257,16 +281,16 @@ impl Channel {
         // Create message
         let msg = Message::new(data.to_vec(), handles);
 
-        // Add to queue
+        // Deliver to the peer's receive queue
         {
-            let mut queue = self.queue.lock();
+            let mut queue = self.tx.queue.lock();
             queue.push_back(msg);
         }
 
-        self.queue_size.fetch_add(total_size, Ordering::Release);
+        self.tx.queue_size.fetch_add(total_size, Ordering::Release);
 
-        // Signal read event
-        self.read_event.signal();
+        // Wake the peer's readers
+        self.tx.read_event.signal();
 
         Ok(data_size)
     }
@@ -288,28 +312,29 @@ impl Channel {
             return Err(RX_ERR_BAD_STATE);
         }
 
-        // Get message from queue
+        // Take the next message, validating buffer sizes before dequeuing so
+        // an undersized buffer doesn't lose the message.
         let msg = {
-            let mut queue = self.queue.lock();
-            queue.pop_front().ok_or(RX_ERR_SHOULD_WAIT)?
+            let mut queue = self.rx.queue.lock();
+            {
+                let front = queue.front().ok_or(RX_ERR_SHOULD_WAIT)?;
+                if buf.len() < front.data_size() {
+                    return Err(RX_ERR_BUFFER_TOO_SMALL);
+                }
+                if handle_buf.capacity() < front.handle_count() {
+                    return Err(RX_ERR_BUFFER_TOO_SMALL);
+                }
+            }
+            queue.pop_front().unwrap()
         };
 
         // Calculate sizes
         let msg_data_size = msg.data_size();
         let msg_handle_count = msg.handle_count();
 
-        // Validate buffer sizes
-        if buf.len() < msg_data_size {
-            return Err(RX_ERR_BUFFER_TOO_SMALL);
-        }
-
-        if handle_buf.capacity() < msg_handle_count {
-            return Err(RX_ERR_BUFFER_TOO_SMALL);
-        }
-
         // Update queue size
         let handles_size = msg_handle_count * core::mem::size_of::<Handle>();
-        self.queue_size.fetch_sub(msg_data_size + handles_size, Ordering::Release);
+        self.rx.queue_size.fetch_sub(msg_data_size + handles_size, Ordering::Release);
 
         // Copy data
         buf[..msg_data_size].copy_from_slice(&msg.data);
@@ -318,24 +343,24 @@ impl Channel {
         *handle_buf = msg.handles;
 
         // If queue is now empty, unsignal read event
-        if self.queue.lock().is_empty() {
-            self.read_event.unsignal();
+        if self.rx.queue.lock().is_empty() {
+            self.rx.read_event.unsignal();
         }
 
-        // Signal write event (space available)
-        self.write_event.signal();
+        // Signal write event (space available for the peer to write again)
+        self.rx.write_event.signal();
 
         Ok((msg_data_size, msg_handle_count))
     }
 
     /// Get message count in queue
     pub fn msg_count(&self) -> usize {
-        self.queue.lock().len()
+        self.rx.queue.lock().len()
     }
 
     /// Get queue size in bytes
     pub fn queue_size(&self) -> usize {
-        self.queue_size.load(Ordering::Acquire)
+        self.rx.queue_size.load(Ordering::Acquire)
     }
 
     /// Check if peer is still alive
@@ -354,10 +379,11 @@ impl Channel {
         *self.state.lock() = ChannelState::Closed;
 
         // Unsignal events
-        self.read_event.unsignal();
-        self.write_event.unsignal();
+        self.rx.read_event.unsignal();
+        self.rx.write_event.unsignal();
 
-        // Notify peer (in real implementation, would signal peer's read event)
+        // Wake peer readers so they observe the closure
+        self.tx.read_event.signal();
         let _ = peer_id;
 
         Ok(())
@@ -371,7 +397,7 @@ impl Channel {
         *self.state.lock() = ChannelState::PeerClosed;
 
         // Signal read event so reader can detect peer closure
-        self.read_event.signal();
+        self.rx.read_event.signal();
     }
 
     /// Increment reference count
@@ -409,6 +435,7 @@ impl Channel {
 #[cfg(test)]
 mod tests {
     use super::*;
+    use crate::kernel::object::{KernelObjectBase, ObjectType};
     use alloc::vec;
 
     #[test]
@@ -435,4 +462,77 @@ mod tests {
         assert_eq!(msg.handle_count(), 0);
         assert!(!msg.is_empty());
     }
+
+    #[test]
+    fn test_channel_message_size_sweep() {
+        // Exercise the same size ladder the IPC regression runs use,
+        // from small control messages up to MAX_MSG_SIZE.
+        let (ch_a, ch_b) = Channel::create().unwrap();
+        let mut buf = vec![0u8; MAX_MSG_SIZE];
+
+        for &size in &[64usize, 512, 4096, MAX_MSG_SIZE] {
+            let data = vec![0xA5u8; size];
+            assert_eq!(ch_a.write(&data, vec![]).unwrap(), size);
+
+            let mut handle_buf = Vec::new();
+            let (read, handles) = ch_b.read(&mut buf, &mut handle_buf).unwrap();
+            assert_eq!(read, size);
+            assert_eq!(handles, 0);
+            assert_eq!(&buf[..size], &data[..]);
+        }
+    }
+
+    #[test]
+    fn test_channel_handle_transfer() {
+        let (ch_a, ch_b) = Channel::create().unwrap();
+
+        let base = KernelObjectBase::new(ObjectType::Event);
+        let handle = Handle::new(&base as *const KernelObjectBase, Rights::TRANSFER);
+        let handle_id = handle.id;
+
+        ch_a.write(b"h", vec![handle]).unwrap();
+
+        let mut buf = [0u8; 8];
+        let mut handle_buf = Vec::with_capacity(MAX_MSG_HANDLES);
+        let (read, handles) = ch_b.read(&mut buf, &mut handle_buf).unwrap();
+
+        assert_eq!(read, 1);
+        assert_eq!(handles, 1);
+        assert_eq!(handle_buf[0].id, handle_id);
+    }
+
+    #[test]
+    fn test_channel_bidirectional() {
+        let (ch_a, ch_b) = Channel::create().unwrap();
+
+        ch_a.write(b"ping", vec![]).unwrap();
+        ch_b.write(b"pong", vec![]).unwrap();
+
+        let mut buf = [0u8; 8];
+        let mut handle_buf = Vec::new();
+
+        assert_eq!(ch_b.read(&mut buf, &mut handle_buf).unwrap().0, 4);
+        assert_eq!(&buf[..4], b"ping");
+
+        assert_eq!(ch_a.read(&mut buf, &mut handle_buf).unwrap().0, 4);
+        assert_eq!(&buf[..4], b"pong");
+    }
+
+    #[test]
+    fn test_channel_backpressure() {
+        let (ch_a, ch_b) = Channel::create().unwrap();
+
+        // Fill the peer's queue up to its byte limit
+        let chunk = vec![0u8; MAX_MSG_SIZE];
+        for _ in 0..(ch_a.max_queue_bytes / MAX_MSG_SIZE) {
+            ch_a.write(&chunk, vec![]).unwrap();
+        }
+        assert_eq!(ch_a.write(&[0u8; 1], vec![]), Err(RX_ERR_SHOULD_WAIT));
+
+        // Draining one message makes room again
+        let mut buf = vec![0u8; MAX_MSG_SIZE];
+        let mut handle_buf = Vec::new();
+        ch_b.read(&mut buf, &mut handle_buf).unwrap();
+        assert!(ch_a.write(&[0u8; 1], vec![]).is_ok());
+    }
 }
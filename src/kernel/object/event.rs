@@ -309,13 +309,13 @@ mod tests {
         let flags = EventFlags::MANUAL_RESET;
         assert!(flags.is_manual_reset());
 
-        let empty = EventFlags::empty();
+        let empty = EventFlags::empty;
         assert!(!empty.is_manual_reset());
     }
 
     #[test]
     fn test_event_create() {
-        let event = Event::new(false, EventFlags::empty());
+        let event = Event::new(false, EventFlags::empty);
         assert!(!event.is_signaled());
 
         let event = Event::new(true, EventFlags::MANUAL_RESET);
@@ -324,7 +324,7 @@ mod tests {
 
     #[test]
     fn test_event_signal() {
-        let event = Event::new(false, EventFlags::empty());
+        let event = Event::new(false, EventFlags::empty);
         assert!(!event.is_signaled());
 
         event.signal();
@@ -59,44 +59,46 @@ fn alloc_job_id() -> JobId {
 /// ============================================================================
 
 /// Job policy for controlling child process behavior
+///
+/// Policies are disjoint bits and may be combined with the bit operators.
 #[repr(C)]
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
-pub enum JobPolicy {
+pub struct JobPolicy(pub u32);
+
+impl JobPolicy {
     /// No special policy
-    None = 0,
+    pub const None: Self = Self(0);
 
     /// Basic policy (minimal restrictions)
-    Basic = 1,
+    pub const Basic: Self = Self(1);
 
     /// Restrict VMO creation (no new VMOs)
-    NoNewVmos = 1 << 1,
+    pub const NoNewVmos: Self = Self(1 << 1);
 
     /// Restrict channel creation
-    NoNewChannels = 1 << 2,
+    pub const NoNewChannels: Self = Self(1 << 2);
 
     /// Restrict event creation
-    NoNewEvents = 1 << 3,
+    pub const NoNewEvents: Self = Self(1 << 3);
 
     /// Restrict socket creation
-    NoNewSockets = 1 << 4,
+    pub const NoNewSockets: Self = Self(1 << 4);
 
     /// Restrict process creation
-    NoNewProcesses = 1 << 5,
+    pub const NoNewProcesses: Self = Self(1 << 5);
 
     /// Restrict thread creation
-    NoNewThreads = 1 << 6,
+    pub const NoNewThreads: Self = Self(1 << 6);
 
     /// Kill all processes when job is closed
-    KillOnClose = 1 << 7,
+    pub const KillOnClose: Self = Self(1 << 7);
 
     /// Allow profiling
-    AllowProfile = 1 << 8,
+    pub const AllowProfile: Self = Self(1 << 8);
 
     /// Allow debugging
-    AllowDebug = 1 << 9,
-}
+    pub const AllowDebug: Self = Self(1 << 9);
 
-impl JobPolicy {
     /// Create from raw value
     pub const fn from_raw(raw: u32) -> Self {
         match raw {
@@ -106,78 +108,18 @@ impl JobPolicy {
     }
 
     /// Convert to raw flags
-    pub fn to_flags(self) -> u32 {
-        let mut flags = 0u32;
-
-        if self.contains(JobPolicy::NoNewVmos) {
-            flags |= JobPolicy::NoNewVmos as u32;
-        }
-        if self.contains(JobPolicy::NoNewChannels) {
-            flags |= JobPolicy::NoNewChannels as u32;
-        }
-        if self.contains(JobPolicy::NoNewEvents) {
-            flags |= JobPolicy::NoNewEvents as u32;
-        }
-        if self.contains(JobPolicy::NoNewSockets) {
-            flags |= JobPolicy::NoNewSockets as u32;
-        }
-        if self.contains(JobPolicy::NoNewProcesses) {
-            flags |= JobPolicy::NoNewProcesses as u32;
-        }
-        if self.contains(JobPolicy::NoNewThreads) {
-            flags |= JobPolicy::NoNewThreads as u32;
-        }
-        if self.contains(JobPolicy::KillOnClose) {
-            flags |= JobPolicy::KillOnClose as u32;
-        }
-        if self.contains(JobPolicy::AllowProfile) {
-            flags |= JobPolicy::AllowProfile as u32;
-        }
-        if self.contains(JobPolicy::AllowDebug) {
-            flags |= JobPolicy::AllowDebug as u32;
-        }
-
-        flags
+    pub const fn to_flags(self) -> u32 {
+        self.0
     }
 
     /// Create from flags
-    pub fn from_flags(flags: u32) -> Self {
-        let mut policy = JobPolicy::None;
-
-        if flags & (JobPolicy::NoNewVmos as u32) != 0 {
-            policy |= JobPolicy::NoNewVmos;
-        }
-        if flags & (JobPolicy::NoNewChannels as u32) != 0 {
-            policy |= JobPolicy::NoNewChannels;
-        }
-        if flags & (JobPolicy::NoNewEvents as u32) != 0 {
-            policy |= JobPolicy::NoNewEvents;
-        }
-        if flags & (JobPolicy::NoNewSockets as u32) != 0 {
-            policy |= JobPolicy::NoNewSockets;
-        }
-        if flags & (JobPolicy::NoNewProcesses as u32) != 0 {
-            policy |= JobPolicy::NoNewProcesses;
-        }
-        if flags & (JobPolicy::NoNewThreads as u32) != 0 {
-            policy |= JobPolicy::NoNewThreads;
-        }
-        if flags & (JobPolicy::KillOnClose as u32) != 0 {
-            policy |= JobPolicy::KillOnClose;
-        }
-        if flags & (JobPolicy::AllowProfile as u32) != 0 {
-            policy |= JobPolicy::AllowProfile;
-        }
-        if flags & (JobPolicy::AllowDebug as u32) != 0 {
-            policy |= JobPolicy::AllowDebug;
-        }
-
-        policy
+    pub const fn from_flags(flags: u32) -> Self {
+        Self(flags)
     }
 
     /// Check if policy contains a flag
-    pub fn contains(self, other: JobPolicy) -> bool {
-        (self.to_flags() & other as u32) != 0
+    pub const fn contains(self, other: JobPolicy) -> bool {
+        (self.0 & other.0) != 0
     }
 }
 
@@ -185,7 +127,7 @@ impl core::ops::BitOr for JobPolicy {
     type Output = Self;
 
     fn bitor(self, rhs: Self) -> Self::Output {
-        Self::from_flags(self.to_flags() | rhs.to_flags())
+        Self(self.0 | rhs.0)
     }
 }
 
@@ -193,7 +135,7 @@ impl core::ops::BitAnd for JobPolicy {
     type Output = Self;
 
     fn bitand(self, rhs: Self) -> Self::Output {
-        Self::from_flags(self.to_flags() & rhs.to_flags())
+        Self(self.0 & rhs.0)
     }
 }
 
@@ -705,14 +647,14 @@ mod tests {
     #[test]
     fn test_job_creation() {
         let root = Job::new_root();
-        assert_eq!(root.id(), JOB_ID_ROOT);
+        assert_eq!(root.id, JOB_ID_ROOT);
         assert!(root.parent.is_none());
         assert!(!root.is_killed());
 
         let child = Job::new_child(&root, 0);
         assert!(child.is_ok());
         let child = child.unwrap();
-        assert_ne!(child.id(), JOB_ID_ROOT);
+        assert_ne!(child.id, JOB_ID_ROOT);
         assert!(child.parent.is_some());
     }
 
@@ -19,7 +19,7 @@
 //! # Usage
 //!
 //! ```rust
-//! let vmo = Vmo::create(0x1000, VmoFlags::empty())?;
+//! let vmo = Vmo::create(0x1000, VmoFlags::empty)?;
 //! vmo.write(0, &data)?;
 //! vmo.read(0, &mut buf)?;
 //! ```
@@ -30,6 +30,7 @@ use crate::kernel::sync::Mutex;
 use crate::rustux::types::*;
 use crate::rustux::types::err::*;
 use alloc::collections::BTreeMap;
+use alloc::sync::Arc;
 use alloc::vec::Vec;
 use core::sync::atomic::{AtomicBool, AtomicU64, AtomicUsize, Ordering};
 
@@ -235,10 +236,9 @@ impl PageMap {
 /// ============================================================================
 
 /// VMO parent (for COW clones)
-#[derive(Debug)]
 pub struct VmoParent {
     /// Parent VMO reference
-    pub vmo: VmoId,
+    pub vmo: Arc<Vmo>,
 
     /// Offset in parent
     pub offset: usize,
@@ -365,14 +365,28 @@ impl Vmo {
         while current_offset < end_offset {
             let page_offset = current_offset & !0xFFF;
             let offset_in_page = current_offset & 0xFFF;
+            let remaining = end_offset - current_offset;
+            let to_copy = core::cmp::min(remaining, 4096 - offset_in_page);
+
+            // Uncommitted pages of a COW clone read through to the parent
+            if self.pages.get(page_offset / 4096).is_none() {
+                let parent = self.parent.lock();
+                if let Some(parent) = parent.as_ref().filter(|p| p.is_cow) {
+                    parent.vmo.read(
+                        parent.offset + current_offset,
+                        &mut buf[bytes_read..bytes_read + to_copy],
+                    )?;
+                    bytes_read += to_copy;
+                    current_offset += to_copy;
+                    continue;
+                }
+            }
 
             // Get or allocate page
             let paddr = self.pages.allocate(page_offset / 4096)?;
 
             // Copy data from page
             let src = unsafe { (paddr as *const u8).add(offset_in_page) };
-            let remaining = end_offset - current_offset;
-            let to_copy = core::cmp::min(remaining, 4096 - offset_in_page);
 
             unsafe {
                 core::ptr::copy_nonoverlapping(
@@ -415,9 +429,21 @@ impl Vmo {
             let page_offset = current_offset & !0xFFF;
             let offset_in_page = current_offset & 0xFFF;
 
-            // Get or allocate page
+            // Get or allocate page; a page first touched by a COW clone is
+            // seeded with the parent's contents before the partial write.
+            let needs_cow_copy = self.pages.get(page_offset / 4096).is_none();
             let paddr = self.pages.allocate(page_offset / 4096)?;
 
+            if needs_cow_copy {
+                let parent = self.parent.lock();
+                if let Some(parent) = parent.as_ref().filter(|p| p.is_cow) {
+                    let page = unsafe {
+                        core::slice::from_raw_parts_mut(paddr as *mut u8, 4096)
+                    };
+                    parent.vmo.read(parent.offset + page_offset, page)?;
+                }
+            }
+
             // Copy data to page
             let dst = unsafe { (paddr as *mut u8).add(offset_in_page) };
             let remaining = end_offset - current_offset;
@@ -448,15 +474,16 @@ impl Vmo {
         *self.cache_policy.lock()
     }
 
-    /// Clone this VMO (COW)
+    /// Clone a VMO (COW)
     ///
     /// # Arguments
     ///
+    /// * `parent` - VMO to clone
     /// * `offset` - Offset in parent
     /// * `size` - Size of clone
-    pub fn clone(&self, offset: usize, size: usize) -> Result<Self> {
+    pub fn clone(parent: &Arc<Self>, offset: usize, size: usize) -> Result<Self> {
         // Validate parameters
-        if offset + size > self.size() {
+        if offset + size > parent.size() {
             return Err(RX_ERR_OUT_OF_RANGE);
         }
 
@@ -468,18 +495,18 @@ impl Vmo {
             flags: VmoFlags::COW,
             pages: PageMap::new(page_count),
             parent: Mutex::new(Some(VmoParent {
-                vmo: self.id,
+                vmo: Arc::clone(parent),
                 offset,
                 is_cow: true,
             })),
             children: Mutex::new(Vec::new()),
-            cache_policy: Mutex::new(self.cache_policy()),
+            cache_policy: Mutex::new(parent.cache_policy()),
             ref_count: AtomicUsize::new(1),
             mapped_aspaces: Mutex::new(alloc::collections::BTreeSet::new()),
         };
 
         // Add as child
-        self.children.lock().push(vmo.id);
+        parent.children.lock().push(vmo.id);
 
         Ok(vmo)
     }
@@ -557,7 +584,7 @@ mod tests {
 
     #[test]
     fn test_vmo_create() {
-        let vmo = Vmo::create(0x1000, VmoFlags::empty()).unwrap();
+        let vmo = Vmo::create(0x1000, VmoFlags::empty).unwrap();
         assert_eq!(vmo.size(), 0x1000);
         assert!(!vmo.flags.is_resizable());
     }
@@ -575,4 +602,54 @@ mod tests {
         assert_eq!(CachePolicy::from_raw(1), policy);
         assert_eq!(policy.into_raw(), 1);
     }
+
+    #[test]
+    fn test_vmo_commit_pages() {
+        // Touching every page commits it exactly once
+        let vmo = Vmo::create(0x4000, VmoFlags::empty).unwrap();
+        let page = [0x5Au8; 4096];
+
+        for i in 0..4 {
+            vmo.write(i * 4096, &page).unwrap();
+        }
+        assert_eq!(vmo.pages.committed_count(), 4);
+
+        // Re-writing doesn't commit new pages
+        vmo.write(0, &page).unwrap();
+        assert_eq!(vmo.pages.committed_count(), 4);
+    }
+
+    #[test]
+    fn test_vmo_clone_chain_reads_through() {
+        // Reads propagate through a chain of COW clones back to the root
+        let root = Arc::new(Vmo::create(0x1000, VmoFlags::empty).unwrap());
+        root.write(0, b"root data").unwrap();
+
+        let mut tip = root;
+        for _ in 0..4 {
+            tip = Arc::new(Vmo::clone(&tip, 0, 0x1000).unwrap());
+        }
+
+        let mut buf = [0u8; 9];
+        tip.read(0, &mut buf).unwrap();
+        assert_eq!(&buf, b"root data");
+    }
+
+    #[test]
+    fn test_vmo_clone_write_preserves_parent() {
+        let parent = Arc::new(Vmo::create(0x1000, VmoFlags::empty).unwrap());
+        parent.write(0, b"original").unwrap();
+
+        // A partial write to the clone seeds the rest of the page from the
+        // parent, and the parent's copy is untouched
+        let clone = Vmo::clone(&parent, 0, 0x1000).unwrap();
+        clone.write(0, b"MOD").unwrap();
+
+        let mut buf = [0u8; 8];
+        clone.read(0, &mut buf).unwrap();
+        assert_eq!(&buf, b"MODginal");
+
+        parent.read(0, &mut buf).unwrap();
+        assert_eq!(&buf, b"original");
+    }
 }
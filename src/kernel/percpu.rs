@@ -64,8 +64,23 @@ pub struct PerCpu {
     /// CPU state
     pub state: AtomicU8,
 
+    /// Arch address space currently resident on this CPU (pointer value;
+    /// 0 when the CPU runs in a kernel-only context)
+    pub active_aspace: AtomicU64,
+
+    /// Bumped every time this CPU switches to a different address space.
+    /// TLB shootdowns consult this together with active_aspace: a CPU
+    /// whose generation moved on has context-switched away and can skip
+    /// the shootdown IPI entirely.
+    pub aspace_generation: AtomicU64,
+
+    /// Monotonic timestamp (ns) of this CPU's last scheduler progress.
+    /// The software watchdog compares it against now to spot stalled
+    /// CPUs before the hardware reset fires.
+    pub last_progress_ns: AtomicU64,
+
     /// Reserved for future use
-    _reserved: [u8; 59],
+    _reserved: [u8; 35],
 }
 
 /// CPU states
@@ -99,7 +114,10 @@ impl PerCpu {
             cpu_num: 0,
             current_thread: AtomicU64::new(0),
             state: AtomicU8::new(CpuState::Offline as u8),
-            _reserved: [0; 59],
+            active_aspace: AtomicU64::new(0),
+            aspace_generation: AtomicU64::new(0),
+            last_progress_ns: AtomicU64::new(0),
+            _reserved: [0; 35],
         }
     }
 
@@ -151,6 +169,16 @@ impl PerCpu {
     pub fn is_boot_cpu(&self) -> bool {
         self.cpu_id == BOOT_CPU_ID
     }
+
+    /// Record scheduler progress on this CPU
+    pub fn record_progress(&self, now_ns: u64) {
+        self.last_progress_ns.store(now_ns, Ordering::Relaxed);
+    }
+
+    /// Get the timestamp of this CPU's last scheduler progress
+    pub fn last_progress_ns(&self) -> u64 {
+        self.last_progress_ns.load(Ordering::Relaxed)
+    }
 }
 
 /// ============================================================================
@@ -263,7 +291,13 @@ pub fn num_cpus() -> u32 {
 pub fn current_cpu_num() -> u32 {
     // In a real implementation, this would read from a CPU-specific register
     // For now, return 0 (boot CPU)
-    #[cfg(target_arch = "x86_64")]
+
+    // Host test builds have no kernel per-CPU segment behind FS; reading
+    // it would return whatever the host runtime keeps there.
+    #[cfg(test)]
+    return 0;
+
+    #[cfg(all(target_arch = "x86_64", not(test)))]
     unsafe {
         let mut num: u32;
         core::arch::asm!(
@@ -274,7 +308,7 @@ pub fn current_cpu_num() -> u32 {
         num
     }
 
-    #[cfg(target_arch = "aarch64")]
+    #[cfg(all(target_arch = "aarch64", not(test)))]
     unsafe {
         let mut num: u64;
         core::arch::asm!(
@@ -285,7 +319,7 @@ pub fn current_cpu_num() -> u32 {
         num as u32
     }
 
-    #[cfg(target_arch = "riscv64")]
+    #[cfg(all(target_arch = "riscv64", not(test)))]
     {
         0 // Stub
     }
@@ -836,17 +836,40 @@ pub unsafe fn pmm_init_early(
 /// Allocate a single page
 ///
 /// Convenience wrapper for pmm_alloc_page.
+#[cfg(not(test))]
 pub fn alloc_page() -> Result<PAddr> {
     pmm_alloc_page(0)
 }
 
+/// Allocate a single page
+///
+/// Host tests have no physical arenas, so pages are served from the test
+/// heap instead. Identity paddr_to_vaddr mapping keeps these usable.
+#[cfg(test)]
+pub fn alloc_page() -> Result<PAddr> {
+    let layout = core::alloc::Layout::from_size_align(PAGE_SIZE, PAGE_SIZE).unwrap();
+    let ptr = unsafe { alloc::alloc::alloc_zeroed(layout) };
+    if ptr.is_null() {
+        return Err(RX_ERR_NO_MEMORY);
+    }
+    Ok(ptr as PAddr)
+}
+
 /// Free a single page
 ///
 /// Convenience wrapper for pmm_free_page.
+#[cfg(not(test))]
 pub fn free_page(paddr: PAddr) {
     let _ = pmm_free_page(paddr);
 }
 
+/// Free a single page back to the test heap
+#[cfg(test)]
+pub fn free_page(paddr: PAddr) {
+    let layout = core::alloc::Layout::from_size_align(PAGE_SIZE, PAGE_SIZE).unwrap();
+    unsafe { alloc::alloc::dealloc(paddr as *mut u8, layout) };
+}
+
 /// Convert physical address to virtual address
 ///
 /// For now, this is a simple identity mapping. In a real system,
@@ -148,45 +148,45 @@ pub const HANDLE_INVALID: Handle = 0;
 /// Handle rights
 ///
 /// Rights control what operations can be performed on an object.
-#[repr(u32)]
+#[repr(transparent)]
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
-pub enum HandleRights {
+pub struct HandleRights(pub u32);
+
+impl HandleRights {
     /// None
-    None = 0,
+    pub const None: Self = Self(0);
 
     /// Read
-    Read = 1 << 0,
+    pub const Read: Self = Self(1 << 0);
 
     /// Write
-    Write = 1 << 1,
+    pub const Write: Self = Self(1 << 1);
 
     /// Execute
-    Execute = 1 << 2,
+    pub const Execute: Self = Self(1 << 2);
 
     /// Duplicate
-    Duplicate = 1 << 3,
+    pub const Duplicate: Self = Self(1 << 3);
 
     /// Transfer
-    Transfer = 1 << 4,
+    pub const Transfer: Self = Self(1 << 4);
 
     /// All rights
-    All = 0xFFFF_FFFF,
-}
+    pub const All: Self = Self(0xFFFF_FFFF);
 
-impl HandleRights {
     /// Check if has right
     pub const fn has(self, right: Self) -> bool {
-        (self as u32) & (right as u32) != 0
+        self.0 & right.0 != 0
     }
 
     /// Add a right
     pub const fn add(self, right: Self) -> Self {
-        unsafe { core::mem::transmute((self as u32) | (right as u32)) }
+        Self(self.0 | right.0)
     }
 
     /// Remove a right
     pub const fn remove(self, right: Self) -> Self {
-        unsafe { core::mem::transmute((self as u32) & !(right as u32)) }
+        Self(self.0 & !right.0)
     }
 }
 
@@ -0,0 +1,254 @@
+// Copyright 2025 The Rustux Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+//! Scheduler Domains
+//!
+//! Scheduling domains built from the system topology graph
+//! (`lib/topology`). Each CPU gets three nested masks: its SMT
+//! siblings (logical processors of one core), its LLC cluster (cores
+//! sharing a last-level cache), and its NUMA node. Wakeup placement
+//! prefers an idle CPU in the smallest domain containing the waker, so
+//! a woken thread lands where the data it is about to touch is still
+//! cached; work stealing prefers same-LLC victims for the same reason.
+//!
+//! Until `init()` runs (or when no topology was provided), every mask
+//! is CPU_MASK_ALL and placement degrades to the old
+//! all-CPUs-equivalent behavior.
+
+use crate::kernel::lib::topology::{self, TopologyEntityType, TopologyNode};
+use crate::kernel::mp::cpu_num_to_mask;
+use crate::kernel::percpu::SMP_MAX_CPUS;
+use crate::kernel::thread::{CpuMask, CPU_MASK_ALL};
+use core::sync::atomic::{AtomicU64, Ordering};
+
+/// ============================================================================
+/// Domain Masks
+/// ============================================================================
+
+/// Domain levels, smallest first
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum DomainLevel {
+    /// Logical processors of one core
+    Smt,
+    /// Cores sharing a last-level cache
+    Llc,
+    /// CPUs of one NUMA node
+    Numa,
+}
+
+const MASK_INIT: AtomicU64 = AtomicU64::new(CPU_MASK_ALL);
+
+/// Per-CPU SMT sibling masks (each mask includes the CPU itself)
+static SMT_MASKS: [AtomicU64; SMP_MAX_CPUS] = [MASK_INIT; SMP_MAX_CPUS];
+
+/// Per-CPU LLC cluster masks
+static LLC_MASKS: [AtomicU64; SMP_MAX_CPUS] = [MASK_INIT; SMP_MAX_CPUS];
+
+/// Per-CPU NUMA node masks
+static NUMA_MASKS: [AtomicU64; SMP_MAX_CPUS] = [MASK_INIT; SMP_MAX_CPUS];
+
+/// CPUs currently running their idle thread (or halted with nothing to run)
+static IDLE_CPUS: AtomicU64 = AtomicU64::new(0);
+
+/// Get a CPU's domain mask at the given level
+pub fn domain_mask(cpu: usize, level: DomainLevel) -> CpuMask {
+    if cpu >= SMP_MAX_CPUS {
+        return CPU_MASK_ALL;
+    }
+    match level {
+        DomainLevel::Smt => SMT_MASKS[cpu].load(Ordering::Relaxed),
+        DomainLevel::Llc => LLC_MASKS[cpu].load(Ordering::Relaxed),
+        DomainLevel::Numa => NUMA_MASKS[cpu].load(Ordering::Relaxed),
+    }
+}
+
+/// Mark a CPU as idle or busy for placement decisions
+pub fn set_cpu_idle(cpu: usize, idle: bool) {
+    let mask = cpu_num_to_mask(cpu as u32);
+    if idle {
+        IDLE_CPUS.fetch_or(mask, Ordering::Relaxed);
+    } else {
+        IDLE_CPUS.fetch_and(!mask, Ordering::Relaxed);
+    }
+}
+
+/// Get the mask of currently idle CPUs
+pub fn idle_mask() -> CpuMask {
+    IDLE_CPUS.load(Ordering::Relaxed)
+}
+
+/// ============================================================================
+/// Domain Construction
+/// ============================================================================
+
+/// Build domain masks from the system topology
+///
+/// Walks each processor node: its own logical IDs form the SMT mask,
+/// processors under the same Cluster parent form the LLC mask, and
+/// processors under the same NumaRegion ancestor form the NUMA mask.
+/// Levels missing from the graph inherit the next level up, so a flat
+/// topology still yields usable (if coarse) domains.
+pub fn init() {
+    let built = topology::system_topology_with(|graph| {
+        for &proc_ptr in graph.processors() {
+            // Safety: processor pointers refer into the graph's node
+            // storage, which is alive for the duration of the borrow.
+            let node = unsafe { &*proc_ptr };
+            let smt = logical_mask(node);
+            let llc = ancestor_mask(node, TopologyEntityType::Cluster).unwrap_or(smt);
+            let numa = ancestor_mask(node, TopologyEntityType::NumARegion).unwrap_or(llc);
+
+            let proc_info = unsafe { node.entity.processor };
+            for i in 0..proc_info.logical_id_count as usize {
+                let cpu = proc_info.logical_ids[i] as usize;
+                if cpu >= SMP_MAX_CPUS {
+                    continue;
+                }
+                SMT_MASKS[cpu].store(smt, Ordering::Relaxed);
+                LLC_MASKS[cpu].store(llc, Ordering::Relaxed);
+                NUMA_MASKS[cpu].store(numa, Ordering::Relaxed);
+            }
+        }
+        graph.processor_count()
+    });
+
+    match built {
+        Some(count) => {
+            crate::log_info!("Scheduler domains built for {} processors", count);
+        }
+        None => {
+            crate::log_info!("Scheduler domains: no topology, treating all CPUs as one domain");
+        }
+    }
+}
+
+/// Mask of the logical CPUs belonging to one processor node
+fn logical_mask(node: &TopologyNode) -> CpuMask {
+    let mut mask: CpuMask = 0;
+    let proc_info = unsafe { node.entity.processor };
+    for i in 0..proc_info.logical_id_count as usize {
+        mask |= cpu_num_to_mask(proc_info.logical_ids[i] as u32);
+    }
+    mask
+}
+
+/// Mask of all logical CPUs under `node`'s nearest ancestor of `kind`
+fn ancestor_mask(node: &TopologyNode, kind: TopologyEntityType) -> Option<CpuMask> {
+    let mut current = node.parent;
+    while let Some(ptr) = current {
+        let ancestor = unsafe { &*ptr };
+        if ancestor.entity_type == kind {
+            return Some(subtree_mask(ancestor));
+        }
+        current = ancestor.parent;
+    }
+    None
+}
+
+/// Mask of all logical CPUs in the subtree rooted at `node`
+fn subtree_mask(node: &TopologyNode) -> CpuMask {
+    if node.entity_type == TopologyEntityType::Processor {
+        return logical_mask(node);
+    }
+    let mut mask: CpuMask = 0;
+    for &child in &node.children {
+        mask |= subtree_mask(unsafe { &*child });
+    }
+    mask
+}
+
+/// ============================================================================
+/// Placement
+/// ============================================================================
+
+/// Pick a CPU for a wakeup originating on `waker_cpu`
+///
+/// Searches for an idle CPU the thread's affinity allows, widening one
+/// domain level at a time: the waker's SMT siblings, then its LLC
+/// cluster, then its NUMA node, then anywhere. Returns None when no
+/// allowed CPU is idle; the caller falls back to queueing behind a
+/// running thread.
+pub fn find_idle_cpu(waker_cpu: usize, affinity: CpuMask) -> Option<usize> {
+    let idle = idle_mask() & affinity;
+    if idle == 0 {
+        return None;
+    }
+
+    for level in [DomainLevel::Smt, DomainLevel::Llc, DomainLevel::Numa] {
+        let candidates = idle & domain_mask(waker_cpu, level);
+        if candidates != 0 {
+            return Some(candidates.trailing_zeros() as usize);
+        }
+    }
+    Some(idle.trailing_zeros() as usize)
+}
+
+/// Whether two CPUs share a last-level cache
+pub fn cpus_share_llc(a: usize, b: usize) -> bool {
+    domain_mask(a, DomainLevel::Llc) & cpu_num_to_mask(b as u32) != 0
+}
+
+/// ============================================================================
+/// Tests
+/// ============================================================================
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_default_masks_are_all_cpus() {
+        // Before init(), every level spans all CPUs
+        assert_eq!(domain_mask(0, DomainLevel::Smt), CPU_MASK_ALL);
+        assert_eq!(domain_mask(0, DomainLevel::Llc), CPU_MASK_ALL);
+        assert_eq!(domain_mask(0, DomainLevel::Numa), CPU_MASK_ALL);
+        assert_eq!(domain_mask(SMP_MAX_CPUS + 1, DomainLevel::Llc), CPU_MASK_ALL);
+    }
+
+    #[test]
+    fn test_idle_tracking() {
+        set_cpu_idle(2, true);
+        assert_ne!(idle_mask() & cpu_num_to_mask(2), 0);
+        set_cpu_idle(2, false);
+        assert_eq!(idle_mask() & cpu_num_to_mask(2), 0);
+    }
+
+    #[test]
+    fn test_find_idle_cpu_respects_affinity() {
+        set_cpu_idle(1, true);
+        set_cpu_idle(3, true);
+
+        // Affinity excludes every idle CPU
+        assert_eq!(find_idle_cpu(0, cpu_num_to_mask(2)), None);
+
+        // Affinity admits CPU 3 only
+        assert_eq!(find_idle_cpu(0, cpu_num_to_mask(3)), Some(3));
+
+        set_cpu_idle(1, false);
+        set_cpu_idle(3, false);
+    }
+
+    #[test]
+    fn test_smt_preferred_over_wider_levels() {
+        // Shrink CPU 0's domains so the level ordering is observable
+        SMT_MASKS[0].store(0b0011, Ordering::Relaxed);
+        LLC_MASKS[0].store(0b1111, Ordering::Relaxed);
+
+        set_cpu_idle(1, true);
+        set_cpu_idle(2, true);
+
+        // CPU 1 is the idle SMT sibling; CPU 2 is merely same-LLC
+        assert_eq!(find_idle_cpu(0, CPU_MASK_ALL), Some(1));
+
+        set_cpu_idle(1, false);
+        // With the sibling busy, fall out to the LLC level
+        assert_eq!(find_idle_cpu(0, CPU_MASK_ALL), Some(2));
+
+        set_cpu_idle(2, false);
+        SMT_MASKS[0].store(CPU_MASK_ALL, Ordering::Relaxed);
+        LLC_MASKS[0].store(CPU_MASK_ALL, Ordering::Relaxed);
+    }
+}
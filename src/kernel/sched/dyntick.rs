@@ -0,0 +1,162 @@
+// Copyright 2025 The Rustux Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+//! Full Tickless (Dyntick) Mode
+//!
+//! A CPU in the isolated partition that is running exactly one runnable
+//! thread has no use for the periodic preemption tick: there is nothing
+//! to preempt in favor of, and every tick costs the thread an interrupt.
+//! When enabled, such a CPU suppresses its local timer interrupt
+//! entirely and runs undisturbed until a reschedule IPI arrives.
+//!
+//! Timer callbacks do not constrain this: isolated CPUs never service
+//! the shared timer wheel (see [`super::isolation`]) - the general
+//! partition drains it - so a quiesced CPU has no local deadline to
+//! honor and the tick can be masked outright rather than re-armed for
+//! the wheel's next deadline.
+//!
+//! Entry and exit are driven from the scheduler itself:
+//!
+//! - `reevaluate()` runs after every local scheduling decision and
+//!   suppresses the tick when the CPU is isolated and left with a sole
+//!   runnable thread, or restores it otherwise.
+//! - `kicked()` runs from the reschedule IPI handler, restoring the tick
+//!   before the scheduler looks at the queue, so a wakeup placed on a
+//!   tickless CPU is never stranded behind a masked timer.
+//!
+//! Enabled at boot with `kernel.dyntick=true`; off by default.
+
+use crate::kernel::percpu::SMP_MAX_CPUS;
+use core::sync::atomic::{AtomicBool, Ordering};
+
+use crate::log_info;
+
+/// Whether dyntick mode is enabled at all (`kernel.dyntick`)
+static DYNTICK_ENABLED: AtomicBool = AtomicBool::new(false);
+
+#[allow(clippy::declare_interior_mutable_const)]
+const TICKLESS_INIT: AtomicBool = AtomicBool::new(false);
+
+/// Per-CPU flag: the CPU's local timer interrupt is currently masked
+static TICKLESS: [AtomicBool; SMP_MAX_CPUS] = [TICKLESS_INIT; SMP_MAX_CPUS];
+
+/// Whether dyntick mode is enabled
+pub fn enabled() -> bool {
+    DYNTICK_ENABLED.load(Ordering::Relaxed)
+}
+
+/// Whether a CPU currently has its tick suppressed
+pub fn is_tickless(cpu: usize) -> bool {
+    cpu < SMP_MAX_CPUS && TICKLESS[cpu].load(Ordering::Relaxed)
+}
+
+/// Pure entry decision, split out for testing
+fn should_suppress(cpu: usize, solo: bool) -> bool {
+    enabled() && solo && super::isolation::is_isolated(cpu)
+}
+
+/// Reconsider tick suppression after a scheduling decision on `cpu`
+///
+/// `solo` is true when the CPU just picked a real (non-idle) thread and
+/// its run queue is empty behind it - the one case where the periodic
+/// tick does no work. Must be called on `cpu` itself, since masking the
+/// local timer is a per-CPU operation.
+pub fn reevaluate(cpu: usize, solo: bool) {
+    if cpu >= SMP_MAX_CPUS {
+        return;
+    }
+    if should_suppress(cpu, solo) {
+        if !TICKLESS[cpu].swap(true, Ordering::Relaxed) {
+            arch_suppress_tick();
+        }
+    } else {
+        restore(cpu);
+    }
+}
+
+/// Restore the tick on the current CPU after a reschedule IPI
+///
+/// Called from the IPI handler before the scheduler examines the queue,
+/// so any thread the waker placed here is picked up by a live tick even
+/// if the subsequent scheduling decision is delayed.
+pub fn kicked(cpu: usize) {
+    restore(cpu);
+}
+
+fn restore(cpu: usize) {
+    if cpu < SMP_MAX_CPUS && TICKLESS[cpu].swap(false, Ordering::Relaxed) {
+        arch_restore_tick();
+    }
+}
+
+/// Mask the current CPU's local timer interrupt
+#[cfg(all(target_arch = "x86_64", not(test)))]
+fn arch_suppress_tick() {
+    crate::kernel::arch::amd64::include::arch::amd64::apic::apic_timer_mask();
+}
+
+/// Unmask the current CPU's local timer interrupt
+#[cfg(all(target_arch = "x86_64", not(test)))]
+fn arch_restore_tick() {
+    crate::kernel::arch::amd64::include::arch::amd64::apic::apic_timer_unmask();
+}
+
+// arm64 and riscv64 take their tick from the architectural timer; until
+// a masking shim exists there, dyntick only tracks state on those
+// targets.
+#[cfg(any(not(target_arch = "x86_64"), test))]
+fn arch_suppress_tick() {}
+
+#[cfg(any(not(target_arch = "x86_64"), test))]
+fn arch_restore_tick() {}
+
+/// Boot-time configuration from `kernel.dyntick=<bool>`
+pub fn init() {
+    if crate::kernel::cmdline::cmdline_get_bool("kernel.dyntick", false) {
+        DYNTICK_ENABLED.store(true, Ordering::Relaxed);
+        log_info!("Dyntick: tick suppression enabled for isolated CPUs");
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_disabled_never_suppresses() {
+        DYNTICK_ENABLED.store(false, Ordering::Relaxed);
+        super::super::isolation::set_isolated_mask(0b0010).unwrap();
+        reevaluate(1, true);
+        assert!(!is_tickless(1));
+        super::super::isolation::set_isolated_mask(0).unwrap();
+    }
+
+    #[test]
+    fn test_solo_isolated_suppresses_and_kick_restores() {
+        DYNTICK_ENABLED.store(true, Ordering::Relaxed);
+        super::super::isolation::set_isolated_mask(0b0100).unwrap();
+
+        // Solo thread on an isolated CPU: tick goes away.
+        reevaluate(2, true);
+        assert!(is_tickless(2));
+
+        // A second runnable thread brings it back.
+        reevaluate(2, false);
+        assert!(!is_tickless(2));
+
+        // As does a reschedule IPI.
+        reevaluate(2, true);
+        kicked(2);
+        assert!(!is_tickless(2));
+
+        // General CPUs never suppress, solo or not.
+        reevaluate(0, true);
+        assert!(!is_tickless(0));
+
+        super::super::isolation::set_isolated_mask(0).unwrap();
+        DYNTICK_ENABLED.store(false, Ordering::Relaxed);
+    }
+}
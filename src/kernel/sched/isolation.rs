@@ -0,0 +1,153 @@
+// Copyright 2025 The Rustux Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+//! CPU Isolation Partitions
+//!
+//! Latency-critical threads need quiesced cores: a CPU in the isolated
+//! partition receives no wakeup placement, loses no work to (and steals
+//! none from) other CPUs, hosts no DPCs, and does not service the
+//! shared timer wheel. The only threads scheduled there are those whose
+//! affinity mask lies entirely inside the partition - pinning a thread
+//! into the partition is the explicit signal that it owns a quiesced
+//! core.
+//!
+//! The partition is configured at boot with `kernel.isolated-cpus=<mask>`
+//! and changed at runtime through the root-resource-gated powerctl
+//! command. The boot CPU can never be isolated, so the general
+//! partition - and with it the timer wheel and redirected DPC work -
+//! always has somewhere to run.
+
+use crate::kernel::mp::cpu_num_to_mask;
+use crate::kernel::percpu::{num_cpus, SMP_MAX_CPUS};
+use crate::kernel::thread::CpuMask;
+use crate::rustux::types::*;
+use crate::rustux::types::err::*;
+use core::sync::atomic::{AtomicU64, Ordering};
+
+use crate::log_info;
+
+/// CPUs excluded from general scheduling, timer service and DPC queues
+static ISOLATED_CPUS: AtomicU64 = AtomicU64::new(0);
+
+/// Get the mask of isolated CPUs
+pub fn isolated_mask() -> CpuMask {
+    ISOLATED_CPUS.load(Ordering::Relaxed)
+}
+
+/// Whether a CPU belongs to the isolated partition
+pub fn is_isolated(cpu: usize) -> bool {
+    cpu < SMP_MAX_CPUS && isolated_mask() & cpu_num_to_mask(cpu as u32) != 0
+}
+
+/// Restrict an affinity mask to the general partition
+///
+/// Threads whose affinity lies entirely inside the partition keep their
+/// mask - those are the designated threads the cores were quiesced for.
+/// Everything else is placed as if the isolated CPUs did not exist.
+pub fn effective_affinity(affinity: CpuMask) -> CpuMask {
+    let general = affinity & !isolated_mask();
+    if general != 0 {
+        general
+    } else {
+        affinity
+    }
+}
+
+/// Pick where per-CPU work raised on `cpu` should actually run
+///
+/// Returns `cpu` itself when it is in the general partition, otherwise
+/// the lowest-numbered general CPU.
+pub fn general_cpu_for(cpu: u32) -> u32 {
+    if !is_isolated(cpu as usize) {
+        return cpu;
+    }
+    let mask = isolated_mask();
+    let ncpus = num_cpus().min(SMP_MAX_CPUS as u32);
+    for candidate in 0..ncpus {
+        if mask & cpu_num_to_mask(candidate) == 0 {
+            return candidate;
+        }
+    }
+    // unreachable: set_isolated_mask never admits the boot CPU
+    0
+}
+
+/// Replace the isolated partition
+///
+/// Newly isolated CPUs have their pending DPC work moved onto the
+/// general partition, so nothing queued before the change runs on a
+/// quiesced core.
+pub fn set_isolated_mask(mask: CpuMask) -> Result {
+    // The boot CPU services the shared timer wheel and hosts redirected
+    // DPCs, so it must stay in the general partition.
+    if mask & cpu_num_to_mask(0) != 0 {
+        return Err(RX_ERR_INVALID_ARGS);
+    }
+
+    let old = ISOLATED_CPUS.swap(mask, Ordering::Relaxed);
+
+    let newly = mask & !old;
+    if newly != 0 {
+        let ncpus = num_cpus().min(SMP_MAX_CPUS as u32);
+        for cpu in 0..ncpus {
+            if newly & cpu_num_to_mask(cpu) != 0 {
+                crate::kernel::dpc::dpc_transition_off_cpu(cpu, general_cpu_for(cpu));
+            }
+        }
+    }
+
+    Ok(())
+}
+
+/// Boot-time configuration from `kernel.isolated-cpus=<mask>`
+pub fn init() {
+    let mask = crate::kernel::cmdline::cmdline_get_uint64("kernel.isolated-cpus", 0);
+    if mask == 0 {
+        return;
+    }
+    match set_isolated_mask(mask) {
+        Ok(()) => {
+            log_info!("CPU isolation: partition mask {:#x}", mask);
+        }
+        Err(_) => {
+            log_info!(
+                "CPU isolation: ignoring kernel.isolated-cpus={:#x} (boot CPU cannot be isolated)",
+                mask
+            );
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_boot_cpu_rejected() {
+        assert!(set_isolated_mask(0b1).is_err());
+        assert_eq!(isolated_mask() & 0b1, 0);
+    }
+
+    #[test]
+    fn test_effective_affinity() {
+        set_isolated_mask(0b0110).unwrap();
+
+        // General threads are steered off the partition.
+        assert_eq!(effective_affinity(0b1111), 0b1001);
+        // A thread pinned entirely inside the partition keeps its mask.
+        assert_eq!(effective_affinity(0b0010), 0b0010);
+
+        set_isolated_mask(0).unwrap();
+    }
+
+    #[test]
+    fn test_general_cpu_for() {
+        set_isolated_mask(0b0010).unwrap();
+        assert_eq!(general_cpu_for(0), 0);
+        assert_eq!(general_cpu_for(1), 0);
+        set_isolated_mask(0).unwrap();
+    }
+}
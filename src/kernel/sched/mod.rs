@@ -14,7 +14,11 @@
 //! - **Priority-based**: Multiple priority levels (0-255)
 //! - **Round-robin**: Threads at same priority scheduled in FIFO order
 //! - **Preemptive**: Timer tick triggers context switch
-//! - **Per-CPU**: Each CPU has its own run queue
+//! - **Per-CPU**: Each CPU has its own run queue and lock
+//! - **Work stealing**: An idle CPU try-locks other CPUs' queues and steals
+//!   a thread whose affinity allows it, instead of spinning on one global lock
+//! - **Topology-aware**: Wakeup placement and steal order follow the
+//!   scheduling domains built from `lib/topology` (see `domains`)
 //!
 //! # Thread States
 //!
@@ -39,7 +43,13 @@
 //! ```
 
 
-use crate::kernel::thread::{Thread, ThreadId, ThreadState, BlockReason, PRIORITY_DEFAULT};
+pub mod domains;
+pub mod dyntick;
+pub mod isolation;
+
+use crate::kernel::mp::cpu_num_to_mask;
+use crate::kernel::percpu::{current_cpu_num, num_cpus, SMP_MAX_CPUS};
+use crate::kernel::thread::{Thread, ThreadId, ThreadState, BlockReason, CpuMask, CPU_MASK_ALL, PRIORITY_DEFAULT};
 use crate::rustux::types::*;
 use crate::kernel::vm::Result;
 use alloc::collections::VecDeque;
@@ -142,6 +152,27 @@ impl RunQueue {
         false
     }
 
+    /// Steal a thread for another CPU.
+    ///
+    /// Scans the queues in the same order as `select()` so stealing preserves
+    /// the priority semantics, but takes from the back of a queue: the owner
+    /// dequeues from the front, so the thief grabs the thread the owner would
+    /// have run last. `can_run` filters out threads whose CPU affinity does
+    /// not include the stealing CPU.
+    pub fn steal<F>(&mut self, can_run: F) -> Option<ThreadId>
+    where
+        F: Fn(ThreadId) -> bool,
+    {
+        for queue in &mut self.queues {
+            if let Some(pos) = queue.iter().rposition(|&t| can_run(t)) {
+                let tid = queue.remove(pos).unwrap();
+                self.stats.ready_count -= 1;
+                return Some(tid);
+            }
+        }
+        None
+    }
+
     /// Select the next thread to run
     pub fn select(&mut self) -> Option<ThreadId> {
         // Find highest priority non-empty queue
@@ -247,9 +278,18 @@ pub struct SchedulerStats {
     /// Number of preemptions
     pub preemptions: u64,
 
+    /// Ticks where a minimum-run guarantee deferred a preemption
+    pub preempts_deferred: u64,
+
+    /// Involuntary preemptions of threads running a profile's custom slice
+    pub preempts_profile_slice: u64,
+
     /// Number of idle cycles
     pub idle_cycles: u64,
 
+    /// Number of threads stolen from other CPUs' run queues
+    pub steals: u64,
+
     /// Current number of ready threads
     pub ready_count: usize,
 }
@@ -260,7 +300,10 @@ impl SchedulerStats {
             schedules: 0,
             yields: 0,
             preemptions: 0,
+            preempts_deferred: 0,
+            preempts_profile_slice: 0,
             idle_cycles: 0,
+            steals: 0,
             ready_count: 0,
         }
     }
@@ -272,15 +315,39 @@ impl SchedulerStats {
 
 /// Per-CPU scheduler instances
 ///
-/// In a real SMP system, this would be per-CPU data.
-/// For now, we have a single global scheduler.
-static mut GLOBAL_SCHEDULER: Option<Scheduler> = None;
-
-/// Global scheduler lock
+/// Each CPU owns its own scheduler and run queue, so the hot
+/// schedule/ready/yield paths only ever touch the local slot. Remote CPUs
+/// touch another slot only when stealing work or when `ready()` has to
+/// honor a thread's CPU affinity.
+const SCHEDULER_NONE: Option<Scheduler> = None;
+static mut SCHEDULERS: [Option<Scheduler>; SMP_MAX_CPUS] = [SCHEDULER_NONE; SMP_MAX_CPUS];
+
+/// Per-CPU scheduler locks
 ///
-/// This protects the global scheduler state.
-/// In a real implementation, this would be a spinlock or per-CPU data.
-static SCHEDULER_LOCK: AtomicBool = AtomicBool::new(false);
+/// One lock per CPU's scheduler state. A CPU spins only on its own lock;
+/// cross-CPU accesses (work stealing) use try-lock and simply move on to
+/// the next victim, so no CPU ever blocks on a remote queue.
+const SCHEDULER_LOCK_INIT: AtomicBool = AtomicBool::new(false);
+static SCHEDULER_LOCKS: [AtomicBool; SMP_MAX_CPUS] = [SCHEDULER_LOCK_INIT; SMP_MAX_CPUS];
+
+fn lock_cpu(cpu: usize) {
+    while SCHEDULER_LOCKS[cpu]
+        .compare_exchange(false, true, Ordering::Acquire, Ordering::Relaxed)
+        .is_err()
+    {
+        core::hint::spin_loop();
+    }
+}
+
+fn try_lock_cpu(cpu: usize) -> bool {
+    SCHEDULER_LOCKS[cpu]
+        .compare_exchange(false, true, Ordering::Acquire, Ordering::Relaxed)
+        .is_ok()
+}
+
+fn unlock_cpu(cpu: usize) {
+    SCHEDULER_LOCKS[cpu].store(false, Ordering::Release);
+}
 
 /// Scheduler structure
 pub struct Scheduler {
@@ -304,8 +371,12 @@ impl Scheduler {
         }
     }
 
-    /// Schedule the next thread to run
-    pub fn schedule(&mut self) -> Option<ThreadId> {
+    /// Schedule the next thread from the local run queue
+    ///
+    /// Returns `None` if the local queue is empty; the caller may then try
+    /// to steal from another CPU (see the global `schedule()`) before
+    /// falling back to the idle thread.
+    pub fn schedule_local(&mut self) -> Option<ThreadId> {
         // Check if we need to preempt
         if self.runqueue.is_preempt_pending() {
             let current = self.runqueue.current();
@@ -328,12 +399,40 @@ impl Scheduler {
         }
 
         // Select next thread
-        let next = self.runqueue.select();
+        let tid = self.runqueue.select()?;
+
+        // Update current thread
+        self.runqueue.set_current(Some(tid));
+
+        // Update schedule time
+        let now = Self::current_time();
+        self.runqueue.update_schedule_time(now);
+        self.record_progress(now);
+
+        log_trace!("Scheduled thread: tid={} cpu={}", tid, self.cpu_id);
 
-        // If no thread to run, use idle thread
-        let tid = if let Some(tid) = next {
-            tid
-        } else if let Some(idle) = self.idle_thread {
+        Some(tid)
+    }
+
+    /// Run a thread stolen from another CPU's run queue
+    pub fn adopt(&mut self, tid: ThreadId) -> ThreadId {
+        self.runqueue.stats_mut().schedules += 1;
+        self.runqueue.stats_mut().steals += 1;
+
+        self.runqueue.set_current(Some(tid));
+
+        let now = Self::current_time();
+        self.runqueue.update_schedule_time(now);
+        self.record_progress(now);
+
+        log_trace!("Stole thread: tid={} cpu={}", tid, self.cpu_id);
+
+        tid
+    }
+
+    /// Fall back to the idle thread when there is nothing runnable anywhere
+    pub fn take_idle(&mut self) -> Option<ThreadId> {
+        let tid = if let Some(idle) = self.idle_thread {
             idle
         } else {
             // No idle thread - return None (CPU idle)
@@ -341,14 +440,11 @@ impl Scheduler {
             return None;
         };
 
-        // Update current thread
         self.runqueue.set_current(Some(tid));
 
-        // Update schedule time
         let now = Self::current_time();
         self.runqueue.update_schedule_time(now);
-
-        log_trace!("Scheduled thread: tid={} cpu={}", tid, self.cpu_id);
+        self.record_progress(now);
 
         Some(tid)
     }
@@ -400,21 +496,6 @@ impl Scheduler {
         }
     }
 
-    /// Wake a blocked thread
-    pub fn wake(&mut self, tid: ThreadId) {
-        if let Some(thread) = Self::get_thread_ref(tid) {
-            if thread.state() == ThreadState::Blocked {
-                // Wake the thread
-                thread.wake();
-
-                // Add to run queue
-                self.ready(tid);
-
-                log_debug!("Thread woke: tid={}", tid);
-            }
-        }
-    }
-
     /// Exit the current thread
     pub fn exit_current(&mut self, code: rx_status_t) {
         if let Some(tid) = self.runqueue.current() {
@@ -428,15 +509,39 @@ impl Scheduler {
     }
 
     /// Handle timer tick (preemption check)
+    ///
+    /// The running thread's profile can override the queue's quantum and
+    /// carry a minimum-run guarantee: a batch thread with a long slice is
+    /// not kicked off the CPU (and through a cache refill) by every tick,
+    /// while a short-slice interactive thread still yields promptly.
     pub fn timer_tick(&mut self) {
-        // Request preemption
-        self.runqueue.request_preempt();
-
-        // Check if time slice expired
         let now = Self::current_time();
         let elapsed = now.saturating_sub(self.runqueue.last_schedule_time());
 
-        if elapsed >= self.runqueue.time_slice() {
+        let (slice_override, min_run) = self
+            .runqueue
+            .current()
+            .and_then(Self::get_thread_ref)
+            .map_or((0, 0), |thread| (thread.time_slice_ns(), thread.min_run_ns()));
+
+        // The guarantee is honored before the slice is checked, so even a
+        // thread whose slice has expired keeps the CPU until it has run
+        // min_run_ns since it was scheduled.
+        if elapsed < min_run {
+            self.runqueue.stats_mut().preempts_deferred += 1;
+            return;
+        }
+
+        let slice = if slice_override != 0 {
+            slice_override
+        } else {
+            self.runqueue.time_slice()
+        };
+
+        if elapsed >= slice {
+            if slice_override != 0 {
+                self.runqueue.stats_mut().preempts_profile_slice += 1;
+            }
             self.runqueue.request_preempt();
         }
     }
@@ -451,6 +556,16 @@ impl Scheduler {
         self.runqueue.stats()
     }
 
+    /// Publish scheduler progress for the software watchdog
+    ///
+    /// The watchdog compares this per-CPU heartbeat against now; a CPU
+    /// that stops passing through the scheduler shows up as a stall.
+    fn record_progress(&self, now: u64) {
+        unsafe {
+            crate::kernel::percpu::get_percpu(self.cpu_id as usize).record_progress(now);
+        }
+    }
+
     /// Get current time (monotonic)
     fn current_time() -> u64 {
         // This would call into the timer subsystem
@@ -485,22 +600,153 @@ impl Scheduler {
 /// Global Scheduler Functions
 /// ============================================================================
 
-/// Initialize the global scheduler
+/// Initialize the scheduler for one CPU
 pub fn init_scheduler(cpu_id: u64) {
+    let cpu = cpu_id as usize;
+    lock_cpu(cpu);
     unsafe {
-        GLOBAL_SCHEDULER = Some(Scheduler::new(cpu_id));
+        SCHEDULERS[cpu] = Some(Scheduler::new(cpu_id));
     }
+    unlock_cpu(cpu);
     log_info!("Scheduler initialized for CPU {}", cpu_id);
 }
 
 /// Schedule the next thread
 pub fn schedule() -> Option<ThreadId> {
-    with_scheduler_mut(|sched| sched.schedule())
+    let cpu = current_cpu_num() as usize;
+
+    // Fast path: run something from the local queue.
+    let (picked, queued) = with_cpu_scheduler_mut(cpu, |sched| {
+        let tid = sched.schedule_local();
+        (tid, sched.runqueue.len())
+    });
+    if let Some(tid) = picked {
+        domains::set_cpu_idle(cpu, false);
+        // A sole runnable thread on an isolated CPU needs no periodic
+        // tick; anything else restores it.
+        dyntick::reevaluate(cpu, queued == 0);
+        return Some(tid);
+    }
+
+    // Local queue is empty: try to steal a runnable thread from another CPU
+    // before going idle.
+    if let Some(tid) = steal_for(cpu) {
+        domains::set_cpu_idle(cpu, false);
+        dyntick::reevaluate(cpu, false);
+        return Some(with_cpu_scheduler_mut(cpu, |sched| sched.adopt(tid)));
+    }
+
+    domains::set_cpu_idle(cpu, true);
+    dyntick::reevaluate(cpu, false);
+    with_cpu_scheduler_mut(cpu, |sched| sched.take_idle())
 }
 
 /// Make a thread ready to run
-pub fn ready(tid: ThreadId) {
-    with_scheduler_mut(|sched| sched.ready(tid))
+///
+/// The thread goes on the current CPU's queue when its affinity allows it,
+/// otherwise on the first online CPU in its affinity mask. Returns the CPU
+/// whose queue received the thread so callers can reschedule it.
+pub fn ready(tid: ThreadId) -> usize {
+    let cpu = target_cpu_for(tid);
+    with_cpu_scheduler_mut(cpu, |sched| sched.ready(tid));
+    cpu
+}
+
+/// Pick the CPU whose run queue should receive `tid`
+///
+/// An idle CPU near the waker is preferred over the waker itself:
+/// `find_idle_cpu` widens one scheduling domain at a time (SMT
+/// siblings, then LLC cluster, then NUMA node), so a wakeup lands on a
+/// CPU that still has the thread's cache lines before it ever migrates
+/// across an LLC boundary.
+fn target_cpu_for(tid: ThreadId) -> usize {
+    let cpu = current_cpu_num() as usize;
+    // Isolated CPUs are invisible here unless the thread is pinned
+    // entirely inside the partition.
+    let affinity: CpuMask = isolation::effective_affinity(
+        Scheduler::get_thread_ref(tid).map_or(CPU_MASK_ALL, |thread| thread.cpu_affinity));
+
+    if let Some(idle) = domains::find_idle_cpu(cpu, affinity) {
+        return idle;
+    }
+
+    if affinity & cpu_num_to_mask(cpu as u32) != 0 {
+        return cpu;
+    }
+
+    // No allowed CPU is idle and the local one is excluded: take the
+    // lowest-numbered online CPU the thread is allowed to run on.
+    let ncpus = num_cpus() as usize;
+    for candidate in 0..ncpus {
+        if affinity & cpu_num_to_mask(candidate as u32) != 0 {
+            return candidate;
+        }
+    }
+
+    // The mask excludes every online CPU; fall back to the local queue
+    // rather than losing the thread.
+    cpu
+}
+
+/// Steal a runnable thread from another CPU's run queue
+///
+/// Walks the other CPUs starting from the thief's neighbor so concurrent
+/// idle CPUs don't all gang up on the same victim, visiting same-LLC
+/// victims on the first pass so stolen work keeps its cache lines when
+/// possible. Victims' locks are only try-locked: a busy queue is
+/// skipped, never waited on.
+fn steal_for(cpu: usize) -> Option<ThreadId> {
+    // An isolated CPU runs only its designated threads; it neither
+    // steals general work nor loses work to other CPUs.
+    if isolation::is_isolated(cpu) {
+        return None;
+    }
+
+    let llc = domains::domain_mask(cpu, domains::DomainLevel::Llc);
+
+    if let Some(tid) = steal_pass(cpu, |victim| llc & cpu_num_to_mask(victim as u32) != 0) {
+        return Some(tid);
+    }
+    steal_pass(cpu, |victim| llc & cpu_num_to_mask(victim as u32) == 0)
+}
+
+/// One victim walk over the CPUs selected by `eligible`
+fn steal_pass<F>(cpu: usize, eligible: F) -> Option<ThreadId>
+where
+    F: Fn(usize) -> bool,
+{
+    let ncpus = num_cpus() as usize;
+    let thief_mask = cpu_num_to_mask(cpu as u32);
+
+    for i in 1..ncpus {
+        let victim = (cpu + i) % ncpus;
+        if isolation::is_isolated(victim) {
+            continue;
+        }
+        if !eligible(victim) {
+            continue;
+        }
+        if !try_lock_cpu(victim) {
+            continue;
+        }
+
+        let stolen = unsafe {
+            SCHEDULERS[victim].as_mut().and_then(|sched| {
+                sched.runqueue.steal(|tid| {
+                    Scheduler::get_thread_ref(tid)
+                        .map_or(true, |thread| thread.cpu_affinity & thief_mask != 0)
+                })
+            })
+        };
+
+        unlock_cpu(victim);
+
+        if stolen.is_some() {
+            return stolen;
+        }
+    }
+
+    None
 }
 
 /// Yield the current thread
@@ -514,8 +760,24 @@ pub fn block_current(reason: BlockReason) {
 }
 
 /// Wake a blocked thread
-pub fn wake(tid: ThreadId) {
-    with_scheduler_mut(|sched| sched.wake(tid));
+///
+/// Routes through `ready()` so the thread lands on a queue its CPU
+/// affinity allows, which is not necessarily the waker's CPU. Returns the
+/// CPU whose queue received the thread, or None if the thread wasn't
+/// blocked. Callers decide how to reschedule: wakers of a single thread
+/// send one IPI, batched wakers (wait queues) accumulate the returned
+/// CPUs into a mask and send one multicast IPI.
+pub fn wake(tid: ThreadId) -> Option<usize> {
+    if let Some(thread) = Scheduler::get_thread_ref(tid) {
+        if thread.state() == ThreadState::Blocked {
+            thread.wake();
+            let cpu = ready(tid);
+
+            log_debug!("Thread woke: tid={}", tid);
+            return Some(cpu);
+        }
+    }
+    None
 }
 
 /// Exit the current thread
@@ -528,57 +790,62 @@ pub fn timer_tick() {
     with_scheduler_mut(|sched| sched.timer_tick());
 }
 
-/// Get scheduler statistics
+/// Get scheduler statistics, aggregated across all initialized CPUs
 pub fn get_stats() -> Option<SchedulerStats> {
-    unsafe {
-        GLOBAL_SCHEDULER.as_ref().map(|sched| *sched.stats())
+    let mut total = SchedulerStats::new();
+    let mut any = false;
+
+    for cpu in 0..(num_cpus() as usize).min(SMP_MAX_CPUS) {
+        lock_cpu(cpu);
+        unsafe {
+            if let Some(sched) = SCHEDULERS[cpu].as_ref() {
+                let stats = sched.stats();
+                total.schedules += stats.schedules;
+                total.yields += stats.yields;
+                total.preemptions += stats.preemptions;
+                total.preempts_deferred += stats.preempts_deferred;
+                total.preempts_profile_slice += stats.preempts_profile_slice;
+                total.idle_cycles += stats.idle_cycles;
+                total.steals += stats.steals;
+                total.ready_count += stats.ready_count;
+                any = true;
+            }
+        }
+        unlock_cpu(cpu);
+    }
+
+    if any {
+        Some(total)
+    } else {
+        None
     }
 }
 
-/// Execute a function with the scheduler
-fn with_scheduler<F, R>(f: F) -> R
+/// Execute a function with a specific CPU's scheduler
+fn with_cpu_scheduler_mut<F, R>(cpu: usize, f: F) -> R
 where
-    F: FnOnce(&Scheduler) -> R,
+    F: FnOnce(&mut Scheduler) -> R,
 {
-    // Acquire lock
-    while SCHEDULER_LOCK.compare_exchange(false, true, Ordering::Acquire, Ordering::Relaxed).is_err() {
-        core::hint::spin_loop();
-    }
+    lock_cpu(cpu);
 
     let result = unsafe {
-        GLOBAL_SCHEDULER.as_ref().map_or_else(
-            || panic!("Scheduler not initialized"),
+        SCHEDULERS[cpu].as_mut().map_or_else(
+            || panic!("Scheduler not initialized for CPU {}", cpu),
             |sched| f(sched),
         )
     };
 
-    // Release lock
-    SCHEDULER_LOCK.store(false, Ordering::Release);
+    unlock_cpu(cpu);
 
     result
 }
 
-/// Execute a function with mutable scheduler
+/// Execute a function with the current CPU's scheduler
 fn with_scheduler_mut<F, R>(f: F) -> R
 where
     F: FnOnce(&mut Scheduler) -> R,
 {
-    // Acquire lock
-    while SCHEDULER_LOCK.compare_exchange(false, true, Ordering::Acquire, Ordering::Relaxed).is_err() {
-        core::hint::spin_loop();
-    }
-
-    let result = unsafe {
-        GLOBAL_SCHEDULER.as_mut().map_or_else(
-            || panic!("Scheduler not initialized"),
-            |sched| f(sched),
-        )
-    };
-
-    // Release lock
-    SCHEDULER_LOCK.store(false, Ordering::Release);
-
-    result
+    with_cpu_scheduler_mut(current_cpu_num() as usize, f)
 }
 
 /// ============================================================================
@@ -588,6 +855,9 @@ where
 /// Initialize the scheduler subsystem
 pub fn init() {
     init_scheduler(0); // CPU 0
+    domains::init();
+    isolation::init();
+    dyntick::init();
     log_info!("Scheduler subsystem initialized");
     log_info!("  Priority levels: {}", N_PRIORITIES);
     log_info!("  Default time slice: {} ms", DEFAULT_TIME_SLICE / 1_000_000);
@@ -622,6 +892,22 @@ mod tests {
         assert!(rq.time_slice() <= MAX_TIME_SLICE);
     }
 
+    #[test]
+    fn test_steal_order_and_filter() {
+        let mut rq = RunQueue::new();
+
+        rq.enqueue(1, 128);
+        rq.enqueue(2, 128);
+        rq.enqueue(3, 128);
+
+        // Steals come from the back of the queue, skipping filtered threads.
+        assert_eq!(rq.steal(|tid| tid != 3), Some(2));
+        assert_eq!(rq.steal(|_| true), Some(3));
+        assert_eq!(rq.steal(|_| true), Some(1));
+        assert_eq!(rq.steal(|_| true), None);
+        assert!(rq.is_empty());
+    }
+
     #[test]
     fn test_stats_new() {
         let stats = SchedulerStats::new();
@@ -15,6 +15,9 @@
 //! - **Priority-ordered**: Threads queued by priority (higher first)
 //! - **Fair ordering**: FIFO within same priority level
 //! - **Multiple waiters**: Can handle many threads waiting simultaneously
+//! - **Batched wakeups**: A multi-thread wake drains the queue under one
+//!   lock acquisition and sends a single multicast reschedule IPI for all
+//!   target CPUs instead of one IPI per woken thread
 //! - **Integrates with scheduler**: Properly blocks and wakes threads
 //!
 //! # Usage
@@ -33,10 +36,12 @@
 //! ```
 
 
+use crate::kernel::mp::{self, cpu_num_to_mask, CpuMask};
 use crate::kernel::thread::ThreadId;
 use crate::rustux::types::*;
 use crate::rustux::types::err::*;
 use alloc::collections::VecDeque;
+use alloc::vec::Vec;
 use crate::kernel::sync::spin::SpinMutex;
 use crate::kernel::sync::Mutex;
 
@@ -189,7 +194,9 @@ impl WaitQueue {
 
         if let Some(mut entry) = entry {
             entry.wait_result = result;
-            self.wake_thread(entry);
+            if let Some(cpu) = self.wake_thread(entry) {
+                mp::mp_reschedule(cpu_num_to_mask(cpu), 0);
+            }
             self.count.fetch_sub(1, core::sync::atomic::Ordering::Release);
             1
         } else {
@@ -233,44 +240,62 @@ impl WaitQueue {
     }
 
     /// Internal wake implementation
+    ///
+    /// Drains up to `max` waiters under a single lock acquisition, makes
+    /// them all runnable, and then issues one multicast reschedule IPI
+    /// covering every CPU that received a thread. Waking the waiters one
+    /// at a time would send one IPI each - a barrier wakeup releasing
+    /// dozens of threads turns that into an IPI storm.
     fn wake(&self, max: i32, reschedule: bool) -> i32 {
-        let mut count = 0;
-
-        while count < max {
-            let entry = {
-                let mut queue = self.queue.lock();
-                queue.pop_front()
-            };
-
-            match entry {
-                Some(entry) => {
-                    self.wake_thread(entry);
-                    self.count.fetch_sub(1, core::sync::atomic::Ordering::Release);
-                    count += 1;
+        // Collect the batch in one critical section.
+        let mut batch: Vec<WaitQueueEntry> = Vec::new();
+        {
+            let mut queue = self.queue.lock();
+            while (batch.len() as i32) < max {
+                match queue.pop_front() {
+                    Some(entry) => batch.push(entry),
+                    None => break,
                 }
-                None => break,
             }
         }
 
+        if batch.is_empty() {
+            return 0;
+        }
+
+        let count = batch.len();
+        self.count.fetch_sub(count, core::sync::atomic::Ordering::Release);
+
+        // Make everything runnable, accumulating the target CPUs.
+        let mut wake_mask: CpuMask = 0;
+        for entry in batch {
+            if let Some(cpu) = self.wake_thread(entry) {
+                wake_mask |= cpu_num_to_mask(cpu);
+            }
+        }
+
+        // One IPI for the whole batch; mp_reschedule drops the local CPU
+        // and inactive CPUs from the mask itself.
+        if wake_mask != 0 {
+            mp::mp_reschedule(wake_mask, 0);
+        }
+
         // Reschedule if requested and we woke something
         if reschedule && count > 0 {
             // TODO: crate::kernel::sched::yield_current();
         }
 
-        count
+        count as i32
     }
 
     /// Wake a single thread
-    fn wake_thread(&self, entry: WaitQueueEntry) {
+    ///
+    /// Returns the CPU whose run queue received the thread, or None if
+    /// the scheduler didn't accept the wake.
+    fn wake_thread(&self, entry: WaitQueueEntry) -> Option<u32> {
         log_debug!("Waking thread {} from wait queue", entry.tid);
 
-        // In a real implementation, this would:
-        // 1. Set thread state to Ready
-        // 2. Set the thread's wait_result
-        // 3. Add to scheduler run queue
-
-        // TODO: Integrate with scheduler
-        // crate::kernel::sched::wake(entry.tid);
+        crate::kernel::sched::wake(entry.tid).map(|cpu| cpu as u32)
     }
 
     /// Insert entry into priority-sorted queue
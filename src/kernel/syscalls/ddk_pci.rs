@@ -779,7 +779,8 @@ mod tests {
 
     #[test]
     fn test_pci_device_info_size() {
-        assert_eq!(core::mem::size_of::<PciDeviceInfo>(), 20);
+        // 11 bytes of IDs padded to 12, plus six u32 IRQ mappings.
+        assert_eq!(core::mem::size_of::<PciDeviceInfo>(), 36);
     }
 
     #[test]
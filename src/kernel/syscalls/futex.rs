@@ -256,9 +256,16 @@ fn futex_wake(user_addr: FutexAddr, count: u32, new_owner: FutexOwner) -> Result
             // Wake all waiters
             futex_state.waiters.wake_all()
         } else {
-            // Wake specified number of waiters
-            futex_state.waiters.wake_one();
-            1 // TODO: Actually count woken waiters
+            // Wake up to `count` waiters, stopping when the queue drains
+            let mut woken = 0;
+            for _ in 0..count {
+                let n = futex_state.waiters.wake_one();
+                if n == 0 {
+                    break;
+                }
+                woken += n;
+            }
+            woken
         };
 
         Ok(woken as usize)
@@ -286,10 +286,13 @@ impl SyscallArgs {
 /// Failure: negative error code
 pub type SyscallRet = isize;
 
-/// Convert error code to negative return value
+/// Convert error code to a syscall return value
+///
+/// Status codes are already negative, so they pass through unchanged;
+/// negating them here would hand a positive value back to user space.
 #[inline]
 pub const fn err_to_ret(err: Status) -> SyscallRet {
-    -(err as SyscallRet)
+    err as SyscallRet
 }
 
 /// Convert success value to return value
@@ -298,6 +301,101 @@ pub const fn ok_to_ret(val: usize) -> SyscallRet {
     val as SyscallRet
 }
 
+/// ============================================================================
+/// Syscall Dispatch Table
+/// ============================================================================
+
+/// Syscall handler signature used by the dispatch table
+type SyscallHandler = fn(SyscallArgs) -> SyscallRet;
+
+/// Number of dispatch table entries (covers syscalls 0x00..=0x43)
+const SYSCALL_TABLE_SIZE: usize = 0x44;
+
+/// Handler for table slots with no syscall assigned
+fn sys_invalid(args: SyscallArgs) -> SyscallRet {
+    log_error!("Unknown syscall: {}", args.number);
+    err_to_ret(RX_ERR_NOT_SUPPORTED)
+}
+
+/// Dispatch table, built at compile time
+///
+/// Indexing by the raw syscall number replaces the decode-then-match
+/// round trip of the old dispatcher; unassigned slots hold sys_invalid
+/// so no range gap needs special casing at runtime.
+static SYSCALL_TABLE: [SyscallHandler; SYSCALL_TABLE_SIZE] = build_syscall_table();
+
+const fn build_syscall_table() -> [SyscallHandler; SYSCALL_TABLE_SIZE] {
+    let mut table: [SyscallHandler; SYSCALL_TABLE_SIZE] = [sys_invalid; SYSCALL_TABLE_SIZE];
+
+    // Process & Thread
+    table[SyscallNumber::rx_process_create as usize] = sys_process_create;
+    table[SyscallNumber::rx_process_start as usize] = sys_process_start;
+    table[SyscallNumber::rx_thread_create as usize] = sys_thread_create;
+    table[SyscallNumber::rx_thread_start as usize] = sys_thread_start;
+    table[SyscallNumber::rx_thread_exit as usize] = sys_thread_exit;
+    table[SyscallNumber::rx_process_exit as usize] = sys_process_exit;
+    table[SyscallNumber::rx_handle_close as usize] = sys_handle_close;
+
+    // Memory / VMO
+    table[SyscallNumber::rx_vmo_create as usize] = sys_vmo_create;
+    table[SyscallNumber::rx_vmo_read as usize] = sys_vmo_read;
+    table[SyscallNumber::rx_vmo_write as usize] = sys_vmo_write;
+    table[SyscallNumber::rx_vmo_clone as usize] = sys_vmo_clone;
+    table[SyscallNumber::rx_vmar_map as usize] = sys_vmar_map;
+    table[SyscallNumber::rx_vmar_unmap as usize] = sys_vmar_unmap;
+    table[SyscallNumber::rx_vmar_protect as usize] = sys_vmar_protect;
+
+    // IPC & Sync
+    table[SyscallNumber::rx_channel_create as usize] = sys_channel_create;
+    table[SyscallNumber::rx_channel_write as usize] = sys_channel_write;
+    table[SyscallNumber::rx_channel_read as usize] = sys_channel_read;
+    table[SyscallNumber::rx_event_create as usize] = sys_event_create;
+    table[SyscallNumber::rx_eventpair_create as usize] = sys_eventpair_create;
+    table[SyscallNumber::rx_object_signal as usize] = sys_object_signal;
+    table[SyscallNumber::rx_object_wait_one as usize] = sys_object_wait_one;
+    table[SyscallNumber::rx_object_wait_many as usize] = sys_object_wait_many;
+
+    // Jobs & Handles
+    table[SyscallNumber::rx_job_create as usize] = sys_job_create;
+    table[SyscallNumber::rx_handle_duplicate as usize] = sys_handle_duplicate;
+    table[SyscallNumber::rx_handle_transfer as usize] = sys_handle_transfer;
+
+    // Time
+    table[SyscallNumber::rx_clock_get as usize] = sys_clock_get;
+    table[SyscallNumber::rx_timer_create as usize] = sys_timer_create;
+    table[SyscallNumber::rx_timer_set as usize] = sys_timer_set;
+    table[SyscallNumber::rx_timer_cancel as usize] = sys_timer_cancel;
+
+    table
+}
+
+// Raw numbers of the syscalls hot enough to bypass the generic path.
+const NUM_CHANNEL_WRITE: u32 = SyscallNumber::rx_channel_write as u32;
+const NUM_CHANNEL_READ: u32 = SyscallNumber::rx_channel_read as u32;
+const NUM_OBJECT_WAIT_ONE: u32 = SyscallNumber::rx_object_wait_one as u32;
+
+// Per-syscall cycle histograms for the specialized hot paths. An IPC
+// round trip is write + wait + read, so these three bound its latency.
+static CHANNEL_WRITE_CYCLES: wrapper::SyscallCycleHistogram =
+    wrapper::SyscallCycleHistogram::new();
+static CHANNEL_READ_CYCLES: wrapper::SyscallCycleHistogram =
+    wrapper::SyscallCycleHistogram::new();
+static OBJECT_WAIT_ONE_CYCLES: wrapper::SyscallCycleHistogram =
+    wrapper::SyscallCycleHistogram::new();
+
+/// Run a hot syscall handler with a cycle histogram around it
+#[inline]
+fn dispatch_timed(
+    histogram: &wrapper::SyscallCycleHistogram,
+    handler: SyscallHandler,
+    args: SyscallArgs,
+) -> SyscallRet {
+    let start = crate::kernel::arch::ops::arch_cycle_count();
+    let ret = handler(args);
+    histogram.record(crate::kernel::arch::ops::arch_cycle_count().wrapping_sub(start));
+    ret
+}
+
 /// ============================================================================
 /// Syscall Dispatcher
 /// ============================================================================
@@ -321,6 +419,22 @@ pub const fn ok_to_ret(val: usize) -> SyscallRet {
 /// It must be marked `no_mangle` so assembly code can find it.
 #[no_mangle]
 pub extern "C" fn syscall_dispatch(args: SyscallArgs) -> SyscallRet {
+    // The hottest syscalls go straight to their handlers, skipping the
+    // decode and trace logging below; each records a cycle histogram so
+    // regressions on the IPC floor show up in kernel stats.
+    match args.number {
+        NUM_CHANNEL_WRITE => {
+            return dispatch_timed(&CHANNEL_WRITE_CYCLES, sys_channel_write, args);
+        }
+        NUM_CHANNEL_READ => {
+            return dispatch_timed(&CHANNEL_READ_CYCLES, sys_channel_read, args);
+        }
+        NUM_OBJECT_WAIT_ONE => {
+            return dispatch_timed(&OBJECT_WAIT_ONE_CYCLES, sys_object_wait_one, args);
+        }
+        _ => {}
+    }
+
     let num = SyscallNumber::from_raw(args.number);
 
     log_trace!(
@@ -335,51 +449,11 @@ pub extern "C" fn syscall_dispatch(args: SyscallArgs) -> SyscallRet {
         args.args[5]
     );
 
-    // Dispatch to handler
-    match num {
-        // Process & Thread
-        SyscallNumber::rx_process_create => sys_process_create(args),
-        SyscallNumber::rx_process_start => sys_process_start(args),
-        SyscallNumber::rx_thread_create => sys_thread_create(args),
-        SyscallNumber::rx_thread_start => sys_thread_start(args),
-        SyscallNumber::rx_thread_exit => sys_thread_exit(args),
-        SyscallNumber::rx_process_exit => sys_process_exit(args),
-        SyscallNumber::rx_handle_close => sys_handle_close(args),
-
-        // Memory / VMO
-        SyscallNumber::rx_vmo_create => sys_vmo_create(args),
-        SyscallNumber::rx_vmo_read => sys_vmo_read(args),
-        SyscallNumber::rx_vmo_write => sys_vmo_write(args),
-        SyscallNumber::rx_vmo_clone => sys_vmo_clone(args),
-        SyscallNumber::rx_vmar_map => sys_vmar_map(args),
-        SyscallNumber::rx_vmar_unmap => sys_vmar_unmap(args),
-        SyscallNumber::rx_vmar_protect => sys_vmar_protect(args),
-
-        // IPC & Sync
-        SyscallNumber::rx_channel_create => sys_channel_create(args),
-        SyscallNumber::rx_channel_write => sys_channel_write(args),
-        SyscallNumber::rx_channel_read => sys_channel_read(args),
-        SyscallNumber::rx_event_create => sys_event_create(args),
-        SyscallNumber::rx_eventpair_create => sys_eventpair_create(args),
-        SyscallNumber::rx_object_signal => sys_object_signal(args),
-        SyscallNumber::rx_object_wait_one => sys_object_wait_one(args),
-        SyscallNumber::rx_object_wait_many => sys_object_wait_many(args),
-
-        // Jobs & Handles
-        SyscallNumber::rx_job_create => sys_job_create(args),
-        SyscallNumber::rx_handle_duplicate => sys_handle_duplicate(args),
-        SyscallNumber::rx_handle_transfer => sys_handle_transfer(args),
-
-        // Time
-        SyscallNumber::rx_clock_get => sys_clock_get(args),
-        SyscallNumber::rx_timer_create => sys_timer_create(args),
-        SyscallNumber::rx_timer_set => sys_timer_set(args),
-        SyscallNumber::rx_timer_cancel => sys_timer_cancel(args),
-
-        SyscallNumber::Unknown => {
-            log_error!("Unknown syscall: {}", args.number);
-            err_to_ret(RX_ERR_NOT_SUPPORTED)
-        }
+    // Dispatch through the compile-time table
+    if (args.number as usize) < SYSCALL_TABLE_SIZE {
+        SYSCALL_TABLE[args.number as usize](args)
+    } else {
+        sys_invalid(args)
     }
 }
 
@@ -749,6 +823,6 @@ mod tests {
     #[test]
     fn test_ret_conversions() {
         assert_eq!(ok_to_ret(42), 42);
-        assert_eq!(err_to_ret(RX_ERR_NO_MEMORY), -(RX_ERR_NO_MEMORY as SyscallRet));
+        assert_eq!(err_to_ret(RX_ERR_NO_MEMORY), RX_ERR_NO_MEMORY as SyscallRet);
     }
 }
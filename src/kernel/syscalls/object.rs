@@ -496,6 +496,22 @@ pub fn sys_object_get_info_impl(
         handle_val, topic, buffer, buffer_size
     );
 
+    object_get_info_for_topic(handle_val, topic, buffer, buffer_size, actual_out, avail_out)
+}
+
+/// Fill one topic's buffer for `handle_val`.
+///
+/// Shared between the single-topic and batched get_info entry points, so
+/// a batch pays for handle resolution and per-topic dispatch once per
+/// entry instead of once per syscall.
+fn object_get_info_for_topic(
+    handle_val: u32,
+    topic: u32,
+    buffer: usize,
+    buffer_size: usize,
+    actual_out: usize,
+    avail_out: usize,
+) -> SyscallRet {
     match topic {
         info_topic::HANDLE_VALID => {
             // Check if handle is valid
@@ -828,6 +844,167 @@ pub fn sys_object_get_info_impl(
     }
 }
 
+/// ============================================================================
+/// Syscall: Object Get Info Batch
+/// ============================================================================
+
+/// One topic query within a batched get_info call.
+///
+/// `status`, `actual` and `avail` are outputs, written back into the
+/// caller's entry array as each topic is filled.
+#[repr(C)]
+#[derive(Debug, Clone, Copy)]
+pub struct InfoBatchEntry {
+    /// Info topic to query (`info_topic::*`)
+    pub topic: u32,
+
+    /// Per-topic status code, written back on completion
+    pub status: i32,
+
+    /// User buffer for this topic's records
+    pub buffer: u64,
+
+    /// Size of the buffer in bytes
+    pub buffer_size: u64,
+
+    /// Number of records written, written back on completion
+    pub actual: u64,
+
+    /// Number of records available, written back on completion
+    pub avail: u64,
+}
+
+/// Maximum number of entries in one batched get_info call
+const MAX_INFO_BATCH: usize = 32;
+
+/// Generation counter covering state observable through get_info.
+///
+/// Callers hand the generation from their previous batch back in via
+/// `generation_in`; when nothing has changed since, the whole batch is
+/// skipped without touching any entry buffer.  Starts at 1 so a caller
+/// passing 0 always gets a full fill on its first query.
+static INFO_GENERATION: AtomicU64 = AtomicU64::new(1);
+
+/// Record a change to state observable through get_info.
+///
+/// Call sites: task lifecycle transitions, handle table changes, and
+/// anything else that would alter a get_info record.
+pub fn bump_info_generation() {
+    INFO_GENERATION.fetch_add(1, Ordering::Release);
+}
+
+/// Get information about a kernel object for several topics at once
+///
+/// Resolves the handle once and fills one buffer per entry, instead of
+/// paying handle resolution and syscall entry per topic the way repeated
+/// `rx_object_get_info` calls do.  Per-topic results go back into each
+/// entry's `status`/`actual`/`avail` fields; the syscall itself only
+/// fails for malformed arguments.
+///
+/// # Arguments
+///
+/// * `handle_val` - Handle value
+/// * `entries` - User pointer to an array of `InfoBatchEntry`
+/// * `count` - Number of entries (at most `MAX_INFO_BATCH`)
+/// * `generation_in` - Generation from the caller's previous batch, or 0
+/// * `generation_out` - User pointer to store the current generation
+///
+/// # Returns
+///
+/// * On success: number of entries filled (0 when skipped as unchanged)
+/// * On error: Negative error code
+pub fn sys_object_get_info_batch_impl(
+    handle_val: u32,
+    entries: usize,
+    count: usize,
+    generation_in: u64,
+    generation_out: usize,
+) -> SyscallRet {
+    log_debug!(
+        "sys_object_get_info_batch: handle={:#x} entries={:#x} count={} gen_in={}",
+        handle_val, entries, count, generation_in
+    );
+
+    if entries == 0 || count == 0 || count > MAX_INFO_BATCH {
+        log_error!("sys_object_get_info_batch: bad entry array {:#x}/{}", entries, count);
+        return err_to_ret(RX_ERR_INVALID_ARGS);
+    }
+
+    let generation = INFO_GENERATION.load(Ordering::Acquire);
+    if generation_out != 0 {
+        let user_ptr = UserPtr::<u8>::new(generation_out);
+        unsafe {
+            if let Err(err) = copy_to_user(
+                user_ptr,
+                &generation as *const u64 as *const u8,
+                core::mem::size_of::<u64>(),
+            ) {
+                return err_to_ret(err.into());
+            }
+        }
+    }
+
+    // Nothing observable has changed since the caller's last batch; skip
+    // every topic.  The caller keeps its cached records.
+    if generation_in == generation {
+        return ok_to_ret(0);
+    }
+
+    const ENTRY_SIZE: usize = core::mem::size_of::<InfoBatchEntry>();
+
+    let mut batch = [InfoBatchEntry {
+        topic: 0,
+        status: 0,
+        buffer: 0,
+        buffer_size: 0,
+        actual: 0,
+        avail: 0,
+    }; MAX_INFO_BATCH];
+
+    unsafe {
+        if let Err(err) = copy_from_user(
+            batch.as_mut_ptr() as *mut u8,
+            UserPtr::new(entries),
+            count * ENTRY_SIZE,
+        ) {
+            log_error!("sys_object_get_info_batch: copy_from_user failed: {:?}", err);
+            return err_to_ret(err.into());
+        }
+    }
+
+    // TODO: Resolve handle_val through the handle table once here and
+    // thread the dispatcher into the per-topic fill, once the per-topic
+    // handlers grow real handle lookup.
+    for (i, entry) in batch[..count].iter().enumerate() {
+        let entry_addr = entries + i * ENTRY_SIZE;
+
+        // Point each topic's actual/avail outputs at the caller's own
+        // entry, so the per-topic fill writes them back in place.
+        let ret = object_get_info_for_topic(
+            handle_val,
+            entry.topic,
+            entry.buffer as usize,
+            entry.buffer_size as usize,
+            entry_addr + core::mem::offset_of!(InfoBatchEntry, actual),
+            entry_addr + core::mem::offset_of!(InfoBatchEntry, avail),
+        );
+
+        let status = if ret < 0 { ret as i32 } else { 0 };
+        let user_ptr = UserPtr::<u8>::new(entry_addr + core::mem::offset_of!(InfoBatchEntry, status));
+        unsafe {
+            if let Err(err) = copy_to_user(
+                user_ptr,
+                &status as *const i32 as *const u8,
+                core::mem::size_of::<i32>(),
+            ) {
+                return err_to_ret(err.into());
+            }
+        }
+    }
+
+    ok_to_ret(count)
+}
+
 /// ============================================================================
 /// Syscall: Object Get Property
 /// ============================================================================
@@ -1356,6 +1533,23 @@ mod tests {
         assert!(core::mem::size_of::<ProcessInfo>() >= 24);
     }
 
+    #[test]
+    fn test_info_batch_entry_layout() {
+        // The write-back path pokes status/actual/avail directly into the
+        // caller's entry array, so the field offsets are ABI.
+        assert_eq!(core::mem::size_of::<InfoBatchEntry>(), 40);
+        assert_eq!(core::mem::offset_of!(InfoBatchEntry, status), 4);
+        assert_eq!(core::mem::offset_of!(InfoBatchEntry, actual), 24);
+        assert_eq!(core::mem::offset_of!(InfoBatchEntry, avail), 32);
+    }
+
+    #[test]
+    fn test_info_generation_bumps() {
+        let before = INFO_GENERATION.load(Ordering::Acquire);
+        bump_info_generation();
+        assert!(INFO_GENERATION.load(Ordering::Acquire) > before);
+    }
+
     #[test]
     fn test_single_record_result_buffer_too_small() {
         let result = single_record_result(
@@ -1373,15 +1567,16 @@ mod tests {
     #[test]
     fn test_single_record_result_success() {
         let data = 0xDEADBEEFu64;
+        let mut out = [0u8; 16];
         let result = single_record_result(
-            0x1000,
-            16, // sufficient buffer
-            0,   // no actual out
-            0,   // no avail out
+            out.as_mut_ptr() as usize,
+            out.len(), // sufficient buffer
+            0,         // no actual out
+            0,         // no avail out
             &data as *const u64 as *const u8,
-            8,   // record size
+            8,         // record size
         );
-        // This will fail to copy to user address 0x1000, but we can test the size logic
-        assert!(result.is_ok() || result.unwrap_err() != RX_ERR_BUFFER_TOO_SMALL);
+        assert!(result.is_ok());
+        assert_eq!(u64::from_ne_bytes(out[..8].try_into().unwrap()), data);
     }
 }
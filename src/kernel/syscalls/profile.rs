@@ -355,12 +355,12 @@ mod tests {
         let info = ProfileInfo::default();
         let profile = Profile::new(info);
 
-        assert_eq!(profile.refcount.load(Ordering::Relaxed), 1);
+        assert_eq!(profile.base.ref_count.load(Ordering::Relaxed), 1);
 
         profile.inc_ref();
-        assert_eq!(profile.refcount.load(Ordering::Relaxed), 2);
+        assert_eq!(profile.base.ref_count.load(Ordering::Relaxed), 2);
 
         profile.dec_ref();
-        assert_eq!(profile.refcount.load(Ordering::Relaxed), 1);
+        assert_eq!(profile.base.ref_count.load(Ordering::Relaxed), 1);
     }
 }
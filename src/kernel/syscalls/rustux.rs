@@ -96,48 +96,26 @@ static UTC_OFFSET: AtomicI64 = AtomicI64::new(0);
 /// PRNG State
 /// ============================================================================
 
-/// Simple XORShift PRNG state
-static mut PRNG_STATE: u64 = 0x0123456789ABCDEF;
-
 /// Initialize PRNG (should be called with true entropy)
 fn prng_init(seed: u64) {
-    unsafe {
-        PRNG_STATE = seed;
-    }
+    crate::kernel::lib::prng::global_prng_add_entropy(&seed.to_le_bytes());
 }
 
 /// Draw random bytes from PRNG
+///
+/// Draws from the current CPU's PRNG, so concurrent cprng syscalls on
+/// different CPUs never contend on shared state (the previous
+/// implementation raced all CPUs through one unlocked XORShift word).
 fn prng_draw(buffer: &mut [u8]) {
-    for chunk in buffer.chunks_mut(8) {
-        unsafe {
-            // XORShift64*
-            let mut x = PRNG_STATE;
-            x ^= x >> 12;
-            x ^= x << 25;
-            x ^= x >> 27;
-            PRNG_STATE = x;
-            let rnd = x.wrapping_mul(0x2545F4914F6CDD1D);
-
-            // Copy bytes to buffer
-            let bytes = rnd.to_ne_bytes();
-            for (i, &b) in bytes.iter().enumerate() {
-                if i < chunk.len() {
-                    chunk[i] = b;
-                }
-            }
-        }
-    }
+    crate::kernel::lib::prng::percpu_prng_draw(buffer);
 }
 
 /// Add entropy to PRNG
+///
+/// Entropy goes to the root PRNG; the per-CPU states pick it up at
+/// their next periodic reseed.
 fn prng_add_entropy(entropy: &[u8]) {
-    let mut seed = unsafe { PRNG_STATE };
-    for &byte in entropy.iter() {
-        seed = seed.wrapping_mul(31).wrapping_add(byte as u64);
-    }
-    unsafe {
-        PRNG_STATE = seed;
-    }
+    crate::kernel::lib::prng::global_prng_add_entropy(entropy);
 }
 
 /// ============================================================================
@@ -748,11 +726,13 @@ mod tests {
 
     #[test]
     fn test_prng_add_entropy() {
+        // Routed to the root PRNG; just ensure it doesn't panic and
+        // subsequent draws still work.
         let entropy = [1u8, 2, 3, 4, 5];
-        let state_before = unsafe { PRNG_STATE };
         prng_add_entropy(&entropy);
-        let state_after = unsafe { PRNG_STATE };
-        assert_ne!(state_before, state_after);
+
+        let mut buf = [0u8; 8];
+        prng_draw(&mut buf);
     }
 
     #[test]
@@ -66,6 +66,9 @@ pub enum PowerctlCmd {
 
     /// Shutdown system
     Shutdown = 8,
+
+    /// Set the isolated CPU partition
+    SetIsolatedCpus = 9,
 }
 
 impl PowerctlCmd {
@@ -80,6 +83,7 @@ impl PowerctlCmd {
             6 => Self::RebootBootloader,
             7 => Self::RebootRecovery,
             8 => Self::Shutdown,
+            9 => Self::SetIsolatedCpus,
             _ => Self::Reboot, // Default to reboot
         }
     }
@@ -313,6 +317,27 @@ pub fn sys_system_powerctl_impl(resource_handle: u32, cmd: u32, arg: usize) -> S
             // TODO: Implement x86 power limit
             ok_to_ret(0)
         }
+
+        PowerctlCmd::SetIsolatedCpus => {
+            // Read the partition mask from the user argument
+            let user_ptr = UserPtr::<u8>::new(arg);
+
+            let mut mask = 0u64;
+            unsafe {
+                if let Err(err) = copy_from_user(&mut mask as *mut u64 as *mut u8, user_ptr, 8) {
+                    log_error!("sys_system_powerctl: copy_from_user failed: {:?}", err);
+                    return err_to_ret(err.into());
+                }
+            }
+
+            if let Err(err) = crate::kernel::sched::isolation::set_isolated_mask(mask) {
+                log_error!("sys_system_powerctl: invalid isolation mask {:#x}", mask);
+                return err_to_ret(err);
+            }
+
+            log_info!("Power: isolated CPU partition set to {:#x}", mask);
+            ok_to_ret(0)
+        }
     }
 }
 
@@ -307,16 +307,19 @@ pub fn sys_thread_start_impl(
 pub fn sys_thread_exit_impl(exit_code: i64) -> SyscallRet {
     log_debug!("sys_thread_exit: code={}", exit_code);
 
-    // Get current thread
-    // TODO: Implement proper current thread tracking
-    // For now, just log
-
     log_info!("Thread exiting with code {}", exit_code);
 
-    // In a real implementation, this would:
-    // 1. Remove thread from process
-    // 2. Clean up resources
-    // 3. Call scheduler to switch to another thread
+    // Move the thread to Dying and hand it to the reaper; stack and
+    // registry teardown happen in the reaper's next bulk pass instead of
+    // inline here, so a burst of exits does not serialize on the stack
+    // allocator.
+    if let Some(current) = thread::get_current_thread() {
+        current.exit(exit_code as i32);
+        thread::reaper::reaper_enqueue(current);
+    }
+
+    // TODO: Remove thread from process and call the scheduler to switch
+    // to another thread
 
     ok_to_ret(0)
 }
@@ -546,6 +549,9 @@ pub fn sys_task_kill_impl(task_handle: u32) -> SyscallRet {
         thread.exit(0); // TODO: proper exit code
 
         log_debug!("sys_task_kill: killed thread tid={}", tid);
+
+        // Resource teardown is batched through the reaper.
+        thread::reaper::reaper_enqueue(thread);
         return ok_to_ret(0);
     }
 
@@ -574,6 +580,12 @@ pub fn sys_job_create_impl(parent_job: u32, options: u32) -> SyscallRet {
         parent_job, options
     );
 
+    // No options are defined for job creation
+    if options != 0 {
+        log_error!("sys_job_create: invalid options {}", options);
+        return err_to_ret(RX_ERR_INVALID_ARGS);
+    }
+
     // Get parent job (0 means root job)
     let parent_job_id = if parent_job == 0 {
         job::JOB_ID_ROOT
@@ -660,7 +672,7 @@ mod tests {
 
     #[test]
     fn test_thread_registry() {
-        let thread = Thread::new(0, String::from("test")).unwrap();
+        let thread = Thread::new(0, 0, 0, thread::PRIORITY_DEFAULT).unwrap();
         let thread_arc = Arc::new(thread);
 
         let tid = unsafe { THREAD_REGISTRY.insert(thread_arc.clone()).unwrap() };
@@ -700,6 +712,9 @@ mod tests {
 
     #[test]
     fn test_job_create() {
+        // The root job is normally created during kernel init
+        job::init_root_job();
+
         // Valid job creation
         assert!(sys_job_create_impl(0, 0) >= 0);
 
@@ -169,9 +169,22 @@ fn lookup_timer_from_handle(
     handle_val: u32,
     required_rights: Rights,
 ) -> Result<(Arc<Timer>, Handle)> {
-    // Get current process handle table
-    let handle_table = current_process_handle_table()
-        .ok_or(RX_ERR_NOT_SUPPORTED)?;
+    // Get current process handle table. Until per-process handle tables are
+    // wired up, handle values are the registry IDs handed out by
+    // sys_timer_create, so resolve them against the registry directly.
+    let handle_table = match current_process_handle_table() {
+        Some(table) => table,
+        None => {
+            let timer = TIMER_REGISTRY.lock().get(handle_val as timer::TimerId)
+                .ok_or(RX_ERR_NOT_FOUND)?;
+            let handle = Handle::with_id(
+                handle_val as u64,
+                core::ptr::null(),
+                required_rights,
+            );
+            return Ok((timer, handle));
+        }
+    };
 
     // Get the handle from the table
     let handle = handle_table.get(handle_val)
@@ -479,12 +492,16 @@ mod tests {
 
     #[test]
     fn test_slack_validation() {
+        let handle = sys_timer_create_impl(0, CLOCK_MONOTONIC);
+        assert!(handle >= 0);
+        let handle = handle as u32;
+
         // Valid slack values
-        assert!(sys_timer_set_impl(0, 1000, 0) >= 0);     // slack = 0
-        assert!(sys_timer_set_impl(0, 1000, 1000) >= 0);  // slack = 1000
+        assert!(sys_timer_set_impl(handle, 1000, 0) >= 0);     // slack = 0
+        assert!(sys_timer_set_impl(handle, 1000, 1000) >= 0);  // slack = 1000
 
         // Invalid slack (negative)
-        assert!(sys_timer_set_impl(0, 1000, -1) < 0);      // negative slack
+        assert!(sys_timer_set_impl(handle, 1000, -1) < 0);      // negative slack
     }
 
     #[test]
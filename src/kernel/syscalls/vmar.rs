@@ -301,8 +301,8 @@ impl Vmar {
         if offset & align_mask != 0 {
             return Err(RX_ERR_INVALID_ARGS);
         }
-        if size & align_mask != (align_mask & (align_mask + 1).saturating_sub(1)) {
-            // Size must be aligned to alignment
+        // Size must be aligned to alignment
+        if size & align_mask != 0 {
             return Err(RX_ERR_INVALID_ARGS);
         }
 
@@ -485,7 +485,7 @@ pub fn sys_vmo_clone_impl(
     };
 
     // Clone the VMO (COW)
-    let vmo = match (*parent_vmo).clone(offset, size) {
+    let vmo = match Vmo::clone(&parent_vmo, offset, size) {
         Ok(vmo) => vmo,
         Err(err) => {
             log_error!("sys_vmo_clone: VMO clone failed: {:?}", err);
@@ -571,7 +571,7 @@ mod tests {
 
     #[test]
     fn test_vmo_registry_insert_get() {
-        let vmo = Vmo::create(0x1000, VmoFlags::empty()).unwrap();
+        let vmo = Vmo::create(0x1000, VmoFlags::empty).unwrap();
         let vmo_arc = Arc::new(vmo);
 
         let id = VMO_REGISTRY.lock().insert(vmo_arc.clone()).unwrap();
@@ -583,7 +583,7 @@ mod tests {
 
     #[test]
     fn test_vmo_registry_remove() {
-        let vmo = Vmo::create(0x1000, VmoFlags::empty()).unwrap();
+        let vmo = Vmo::create(0x1000, VmoFlags::empty).unwrap();
         let vmo_arc = Arc::new(vmo);
 
         let id = VMO_REGISTRY.lock().insert(vmo_arc.clone()).unwrap();
@@ -598,48 +598,48 @@ mod tests {
         let vmo_resizable = Vmo::create(0x1000, VmoFlags::RESIZABLE).unwrap();
         assert!(vmo_resizable.flags.is_resizable());
 
-        let vmo_normal = Vmo::create(0x1000, VmoFlags::empty()).unwrap();
+        let vmo_normal = Vmo::create(0x1000, VmoFlags::empty).unwrap();
         assert!(!vmo_normal.flags.is_resizable());
     }
 
     #[test]
     fn test_vmo_size_validation() {
         // Invalid: zero size
-        assert!(Vmo::create(0, VmoFlags::empty()).is_err());
+        assert!(Vmo::create(0, VmoFlags::empty).is_err());
 
         // Invalid: not page-aligned
-        assert!(Vmo::create(0x1001, VmoFlags::empty()).is_err());
+        assert!(Vmo::create(0x1001, VmoFlags::empty).is_err());
 
         // Valid: page-aligned
-        assert!(Vmo::create(0x1000, VmoFlags::empty()).is_ok());
+        assert!(Vmo::create(0x1000, VmoFlags::empty).is_ok());
     }
 
     #[test]
     fn test_vmo_read_write() {
-        let vmo = Vmo::create(0x1000, VmoFlags::empty()).unwrap();
+        let vmo = Vmo::create(0x1000, VmoFlags::empty).unwrap();
         let data = b"Hello, World!";
 
         // Write data
         let written = vmo.write(0, data).unwrap();
         assert_eq!(written, data.len());
 
-        // Read back
+        // Read back; VMO reads fill the whole buffer, zero-filled past the data
         let mut buf = [0u8; 64];
         let read = vmo.read(0, &mut buf).unwrap();
-        assert_eq!(read, data.len());
+        assert_eq!(read, buf.len());
         assert_eq!(&buf[..data.len()], data);
     }
 
     #[test]
     fn test_vmo_clone() {
-        let parent = Vmo::create(0x2000, VmoFlags::empty()).unwrap();
+        let parent = Vmo::create(0x2000, VmoFlags::empty).unwrap();
         let parent_arc = Arc::new(parent);
 
         let data = b"Hello, clone!";
         parent_arc.write(0, data).unwrap();
 
         // Clone the VMO
-        let clone = parent_arc.clone(0, 0x1000).unwrap();
+        let clone = Vmo::clone(&parent_arc, 0, 0x1000).unwrap();
 
         // Verify clone is a COW clone
         assert!(clone.flags.is_cow());
@@ -647,7 +647,7 @@ mod tests {
         // Read from clone should get parent's data
         let mut buf = [0u8; 64];
         let read = clone.read(0, &mut buf).unwrap();
-        assert_eq!(read, data.len());
+        assert_eq!(read, buf.len());
         assert_eq!(&buf[..data.len()], data);
     }
 
@@ -666,7 +666,7 @@ mod tests {
 
     #[test]
     fn test_vmo_resize_non_resizable() {
-        let vmo = Vmo::create(0x1000, VmoFlags::empty()).unwrap();
+        let vmo = Vmo::create(0x1000, VmoFlags::empty).unwrap();
 
         // Should fail - not resizable
         assert!(vmo.resize(0x2000).is_err());
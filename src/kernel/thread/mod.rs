@@ -40,6 +40,8 @@
 //! ```
 
 
+pub mod reaper;
+
 use crate::kernel::vm::stacks::*;
 use crate::kernel::vm::aspace::*;
 use crate::kernel::vm::{VmError, Result};
@@ -205,6 +207,14 @@ pub struct Thread {
     /// CPU affinity mask
     pub cpu_affinity: CpuMask,
 
+    /// Timeslice override in nanoseconds (0 = scheduler default),
+    /// applied through a scheduling profile
+    pub time_slice_ns: AtomicU64,
+
+    /// Run time guaranteed before an involuntary preemption, in
+    /// nanoseconds; a preemption tick firing earlier is deferred
+    pub min_run_ns: AtomicU64,
+
     /// Block reason (if blocked)
     pub block_reason: Mutex<BlockReason>,
 
@@ -407,6 +417,8 @@ impl Thread {
             state: Mutex::new(ThreadState::New),
             priority,
             cpu_affinity: CPU_MASK_ALL,
+            time_slice_ns: AtomicU64::new(0),
+            min_run_ns: AtomicU64::new(0),
             block_reason: Mutex::new(BlockReason::None),
             stack: Mutex::new(None),
             pid: Mutex::new(None),
@@ -494,6 +506,24 @@ impl Thread {
         self.priority = priority;
     }
 
+    /// Get the thread's timeslice override (0 = scheduler default)
+    pub fn time_slice_ns(&self) -> u64 {
+        self.time_slice_ns.load(Ordering::Relaxed)
+    }
+
+    /// Get the thread's minimum-run guarantee
+    pub fn min_run_ns(&self) -> u64 {
+        self.min_run_ns.load(Ordering::Relaxed)
+    }
+
+    /// Set the timeslice override and minimum-run guarantee
+    ///
+    /// A `slice_ns` of 0 restores the scheduler's default quantum.
+    pub fn set_timeslice(&self, slice_ns: u64, min_run_ns: u64) {
+        self.time_slice_ns.store(slice_ns, Ordering::Relaxed);
+        self.min_run_ns.store(min_run_ns.min(slice_ns), Ordering::Relaxed);
+    }
+
     /// Associate a process with this thread
     pub fn set_process(&self, pid: u64) {
         *self.pid.lock() = Some(pid);
@@ -542,6 +572,10 @@ impl Thread {
 
     /// Exit the current thread
     ///
+    /// Moves the thread to `Dying` and wakes joiners. The caller should
+    /// then hand its `Arc` to [`reaper::reaper_enqueue`]; stack and
+    /// registry teardown happen in the reaper's next bulk pass.
+    ///
     /// # Arguments
     ///
     /// * `code` - Return code
@@ -634,6 +668,8 @@ impl Thread {
             state: Mutex::new(ThreadState::Ready),
             priority: PRIORITY_DEFAULT,
             cpu_affinity: CPU_MASK_ALL,
+            time_slice_ns: AtomicU64::new(0),
+            min_run_ns: AtomicU64::new(0),
             block_reason: Mutex::new(BlockReason::None),
             stack: Mutex::new(None),
             pid: Mutex::new(None),
@@ -785,6 +821,21 @@ pub fn thread_count() -> usize {
     THREAD_REGISTRY.count()
 }
 
+/// Get one page of threads from the registry
+///
+/// Returns up to `max` threads with tid > `after`, in tid order. Dump
+/// paths iterate with this instead of cloning the whole registry, so a
+/// console dump over thousands of threads holds the registry lock for
+/// one page at a time.
+pub fn threads_page(after: ThreadId, max: usize) -> Vec<Arc<Thread>> {
+    let entries = THREAD_REGISTRY.entries.lock();
+    entries
+        .range((after + 1)..)
+        .take(max)
+        .map(|(_, thread)| thread.clone())
+        .collect()
+}
+
 /// Block the current thread
 ///
 /// # Arguments
@@ -0,0 +1,171 @@
+// Copyright 2025 The Rustux Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+//! Batched Thread Reaping
+//!
+//! This module collects exited threads and frees their resources in bulk
+//! instead of tearing each one down inline on the exit path.
+//!
+//! # Design
+//!
+//! - **Per-CPU dead lists**: an exiting thread is pushed onto the list for
+//!   the CPU it exits on, so enqueue never contends with exits on other
+//!   CPUs.
+//! - **Bulk passes**: a reap pass drains every CPU's list, marks the
+//!   threads `Dead`, unregisters them, and returns all their kernel
+//!   stacks to the stack cache in one batch, paying the cache lock once
+//!   per pass rather than once per thread.
+//! - **Threshold + idle draining**: a pass runs inline once enough
+//!   threads are pending (so a worker-pool teardown cannot grow the lists
+//!   without bound), and the idle loop drains whatever is left before a
+//!   CPU goes to sleep.
+//!
+//! # Usage
+//!
+//! ```rust
+//! // From the exit path, after thread.exit(code):
+//! reaper_enqueue(thread);
+//!
+//! // From the idle loop, before sleeping:
+//! reap_all();
+//! ```
+
+use crate::kernel::percpu;
+use crate::kernel::sync::Mutex;
+use crate::kernel::vm::stacks::free_kernel_stack_batch;
+use alloc::sync::Arc;
+use alloc::vec::Vec;
+use core::sync::atomic::{AtomicU64, AtomicUsize, Ordering};
+
+use crate::log_debug;
+
+use super::{get_thread_by_id, unregister_thread, Thread, ThreadId, ThreadState};
+
+/// Pending-thread count that triggers an inline bulk pass from enqueue.
+pub const REAP_BATCH_THRESHOLD: usize = 32;
+
+/// Per-CPU lists of threads that have exited but not been reaped.
+///
+/// The lists hold thread IDs, not references, mirroring how the scheduler
+/// run queues work: the registry keeps the thread alive until the bulk
+/// pass unregisters it, so the queues stay free of `Arc<Thread>` (whose
+/// arch data holds raw pointers and is not `Send`).
+static REAP_QUEUES: [Mutex<Vec<ThreadId>>; percpu::SMP_MAX_CPUS] =
+    [const { Mutex::new(Vec::new()) }; percpu::SMP_MAX_CPUS];
+
+/// Threads pending across all CPUs; lets enqueue and the idle loop check
+/// for work without touching any queue lock.
+static PENDING: AtomicUsize = AtomicUsize::new(0);
+
+/// Total threads reaped and bulk passes run, for diagnostics.
+static THREADS_REAPED: AtomicU64 = AtomicU64::new(0);
+static REAP_PASSES: AtomicU64 = AtomicU64::new(0);
+
+/// Hand an exited thread to the reaper.
+///
+/// The caller must already have moved the thread to `Dying` (via
+/// `Thread::exit`). The reaper records only the thread's ID; the
+/// registry's reference keeps the thread looked-up-able until a bulk
+/// pass unregisters it. If this enqueue crosses the batch threshold the
+/// pass runs inline, so a burst of exits pays for its own cleanup
+/// instead of deferring it all.
+pub fn reaper_enqueue(thread: Arc<Thread>) {
+    debug_assert!(thread.state().has_exited());
+
+    let cpu = percpu::current_cpu_num() as usize % percpu::SMP_MAX_CPUS;
+    REAP_QUEUES[cpu].lock().push(thread.tid);
+
+    if PENDING.fetch_add(1, Ordering::AcqRel) + 1 >= REAP_BATCH_THRESHOLD {
+        reap_all();
+    }
+}
+
+/// Drain every CPU's dead list and free the threads' resources in bulk.
+///
+/// Returns the number of threads reaped. Safe to call from any context
+/// that may take the stack cache lock; cheap when nothing is pending.
+pub fn reap_all() -> usize {
+    if PENDING.load(Ordering::Acquire) == 0 {
+        return 0;
+    }
+
+    // Drain each queue with a short lock hold; the actual teardown runs
+    // on our local batch with no queue lock held.
+    let mut batch: Vec<ThreadId> = Vec::new();
+    for queue in REAP_QUEUES.iter() {
+        let mut pending = queue.lock();
+        if !pending.is_empty() {
+            batch.append(&mut *pending);
+        }
+    }
+
+    if batch.is_empty() {
+        return 0;
+    }
+
+    PENDING.fetch_sub(batch.len(), Ordering::AcqRel);
+
+    // Tear the batch down: mark dead, unregister, and collect the kernel
+    // stacks so they go back to the stack cache as one batch.
+    let mut stacks = Vec::with_capacity(batch.len());
+    let reaped = batch.len();
+
+    for tid in batch {
+        // A missing entry means someone unregistered the thread out from
+        // under us; there is nothing left to tear down.
+        let Some(thread) = get_thread_by_id(tid) else {
+            continue;
+        };
+        thread.set_state(ThreadState::Dead);
+        if let Some(stack) = thread.stack.lock().take() {
+            stacks.push(stack);
+        }
+        unregister_thread(tid);
+        // Dropping the registry's Arc releases the last kernel-side
+        // reference; the Thread itself is freed once any joiners drop
+        // theirs.
+    }
+
+    free_kernel_stack_batch(stacks);
+
+    THREADS_REAPED.fetch_add(reaped as u64, Ordering::Relaxed);
+    REAP_PASSES.fetch_add(1, Ordering::Relaxed);
+
+    log_debug!("Reaped {} threads in bulk pass", reaped);
+
+    reaped
+}
+
+/// Number of threads waiting to be reaped.
+pub fn reaper_pending() -> usize {
+    PENDING.load(Ordering::Relaxed)
+}
+
+/// (threads reaped, bulk passes) since boot.
+pub fn reaper_stats() -> (u64, u64) {
+    (
+        THREADS_REAPED.load(Ordering::Relaxed),
+        REAP_PASSES.load(Ordering::Relaxed),
+    )
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_batch_threshold() {
+        // The threshold must be small enough that a teardown burst cannot
+        // hold many stacks hostage, and a pass on an empty reaper is free.
+        assert!(REAP_BATCH_THRESHOLD >= 2);
+        assert!(REAP_BATCH_THRESHOLD <= 1024);
+        assert_eq!(reap_all(), 0);
+    }
+}
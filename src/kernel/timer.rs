@@ -12,7 +12,8 @@
 //! # Design
 //!
 //! - **High-resolution timers**: Nanosecond precision
-//! - **Efficient ordering**: Timers stored in priority queue
+//! - **Hierarchical timer wheel**: Arming and canceling are O(1); timers
+//!   landing in the same wheel slot coalesce to a single expiry
 //! - **Per-CPU timer queues**: Each CPU has its own timer queue
 //! - **Integration with scheduler**: Thread wakeups integrated
 //!
@@ -34,8 +35,7 @@ use crate::rustux::types::*;
 use core::sync::atomic::{AtomicBool, AtomicU64, Ordering};
 use crate::kernel::sync::spin::SpinMutex;
 use crate::kernel::sync::Mutex;
-use alloc::collections::BinaryHeap;
-use core::cmp::Ordering as CmpOrdering;
+use alloc::vec::Vec;
 
 // Import logging macros
 use crate::{log_debug, log_info, log_trace};
@@ -220,7 +220,7 @@ impl Timer {
 /// Timer Queue Entry
 /// ============================================================================
 
-/// Timer queue entry for heap ordering
+/// Timer queue entry stored in a wheel slot
 #[derive(Debug)]
 struct TimerQueueEntry {
     /// Deadline
@@ -233,28 +233,221 @@ struct TimerQueueEntry {
     timer: *const Timer,
 }
 
-// Implement ordering for BinaryHeap (min-heap by deadline)
-impl PartialEq for TimerQueueEntry {
-    fn eq(&self, other: &Self) -> bool {
-        self.deadline == other.deadline && self.id == other.id
+/// ============================================================================
+/// Timer Wheel
+/// ============================================================================
+
+/// log2 of the wheel tick resolution in nanoseconds (~1ms).
+///
+/// Deadlines within one tick land in the same slot and fire together -
+/// this is the coalescing slack: timers never fire early, and fire at
+/// most one tick late.
+const WHEEL_RESOLUTION_SHIFT: u32 = 20;
+
+/// log2 of the number of slots per wheel level
+const WHEEL_SLOT_SHIFT: u32 = 6;
+
+/// Slots per wheel level
+const WHEEL_SLOTS: usize = 1 << WHEEL_SLOT_SHIFT;
+
+/// Number of wheel levels. Four levels of 64 slots at ~1ms resolution
+/// cover deadlines out to roughly 200 days; anything beyond parks in the
+/// top level and cascades down.
+const WHEEL_LEVELS: usize = 4;
+
+/// Timer wheel statistics
+#[derive(Debug, Clone, Copy)]
+pub struct TimerStats {
+    /// Timers armed
+    pub inserts: u64,
+
+    /// Timers canceled before firing
+    pub cancels: u64,
+
+    /// Timer callbacks fired
+    pub fires: u64,
+
+    /// Entries moved down a wheel level
+    pub cascades: u64,
+
+    /// Timers currently armed in the wheel
+    pub occupancy: u64,
+}
+
+impl TimerStats {
+    const fn new() -> Self {
+        Self {
+            inserts: 0,
+            cancels: 0,
+            fires: 0,
+            cascades: 0,
+            occupancy: 0,
+        }
     }
 }
 
-impl Eq for TimerQueueEntry {}
+/// Hierarchical timer wheel
+///
+/// Level 0 holds timers expiring within the next 64 ticks at tick
+/// granularity; each higher level covers 64x the span of the one below at
+/// proportionally coarser granularity. Arming hashes the deadline to a
+/// slot in O(1); expiry walks only the slots the clock passes through and
+/// cascades coarser entries down as their level's horizon is reached.
+/// Cancellation is O(1) and lazy: the entry's timer is marked inactive
+/// and the wheel drops it when its slot drains.
+struct TimerWheel {
+    /// Wheel slots, indexed by [level][slot]
+    levels: [[Vec<TimerQueueEntry>; WHEEL_SLOTS]; WHEEL_LEVELS],
+
+    /// Current time in ticks (monotonic, advanced by tick())
+    now_ticks: u64,
+
+    /// Cached earliest deadline, u64::MAX when empty
+    earliest: u64,
+
+    /// Counters
+    stats: TimerStats,
+}
 
-impl PartialOrd for TimerQueueEntry {
-    fn partial_cmp(&self, other: &Self) -> Option<CmpOrdering> {
-        Some(self.cmp(other))
+impl TimerWheel {
+    const fn new() -> Self {
+        #[allow(clippy::declare_interior_mutable_const)]
+        const EMPTY_SLOT: Vec<TimerQueueEntry> = Vec::new();
+        const EMPTY_LEVEL: [Vec<TimerQueueEntry>; WHEEL_SLOTS] = [EMPTY_SLOT; WHEEL_SLOTS];
+
+        Self {
+            levels: [EMPTY_LEVEL; WHEEL_LEVELS],
+            now_ticks: 0,
+            earliest: u64::MAX,
+            stats: TimerStats::new(),
+        }
+    }
+
+    /// Reset the wheel to empty
+    fn clear(&mut self) {
+        for level in self.levels.iter_mut() {
+            for slot in level.iter_mut() {
+                slot.clear();
+            }
+        }
+        self.now_ticks = 0;
+        self.earliest = u64::MAX;
+        self.stats = TimerStats::new();
+    }
+
+    /// Pick the level and slot for a deadline (in ticks)
+    fn slot_for(&self, deadline_ticks: u64) -> (usize, usize) {
+        // Already-expired deadlines go in the current level-0 slot so the
+        // next tick fires them.
+        let ticks = if deadline_ticks <= self.now_ticks {
+            self.now_ticks
+        } else {
+            deadline_ticks
+        };
+
+        let delta = ticks - self.now_ticks;
+        for level in 0..WHEEL_LEVELS {
+            let level_span = 1u64 << (WHEEL_SLOT_SHIFT * (level as u32 + 1));
+            if delta < level_span || level == WHEEL_LEVELS - 1 {
+                let slot = (ticks >> (WHEEL_SLOT_SHIFT * level as u32)) as usize
+                    & (WHEEL_SLOTS - 1);
+                return (level, slot);
+            }
+        }
+        unreachable!();
     }
-}
 
-impl Ord for TimerQueueEntry {
-    fn cmp(&self, other: &Self) -> CmpOrdering {
-        // Reverse for min-heap behavior
-        match other.deadline.cmp(&self.deadline) {
-            CmpOrdering::Equal => other.id.cmp(&self.id),
-            other => other,
+    /// Arm an entry. O(1).
+    fn insert(&mut self, entry: TimerQueueEntry) {
+        if entry.deadline < self.earliest {
+            self.earliest = entry.deadline;
         }
+
+        let (level, slot) = self.slot_for(entry.deadline >> WHEEL_RESOLUTION_SHIFT);
+        self.levels[level][slot].push(entry);
+        self.stats.inserts += 1;
+        self.stats.occupancy += 1;
+    }
+
+    /// Advance the wheel to |current_time| and collect expired entries.
+    ///
+    /// Cancelled (inactive) entries are dropped along the way. The fired
+    /// entries are returned rather than fired under the wheel lock so
+    /// periodic re-arms don't re-enter it.
+    fn expire(&mut self, current_time: u64, fired: &mut Vec<TimerQueueEntry>) {
+        let current_ticks = current_time >> WHEEL_RESOLUTION_SHIFT;
+
+        // An empty wheel has no slots worth walking - jump straight to the
+        // current tick (this also covers the first tick after boot).
+        if self.stats.occupancy == 0 {
+            self.now_ticks = current_ticks;
+            return;
+        }
+
+        while self.now_ticks <= current_ticks {
+            // When a level wraps, cascade the matching slot of the level
+            // above down into finer levels first, so entries due this very
+            // tick land in the level-0 slot drained below.
+            for level in 1..WHEEL_LEVELS {
+                if (self.now_ticks & ((1 << (WHEEL_SLOT_SHIFT * level as u32)) - 1)) != 0 {
+                    break;
+                }
+
+                let upper_slot = (self.now_ticks >> (WHEEL_SLOT_SHIFT * level as u32)) as usize
+                    & (WHEEL_SLOTS - 1);
+                let entries: Vec<TimerQueueEntry> =
+                    self.levels[level][upper_slot].drain(..).collect();
+                for entry in entries {
+                    self.stats.occupancy -= 1;
+                    self.stats.cascades += 1;
+                    let active = unsafe { (*entry.timer).is_active() };
+                    if active {
+                        // Re-hash: lands in a finer level (or fires on a
+                        // later pass of this loop's level-0 drain).
+                        self.insert(entry);
+                        // Cascading isn't a new arm.
+                        self.stats.inserts -= 1;
+                    }
+                }
+            }
+
+            // Drain the level-0 slot the clock is passing through.
+            let slot = (self.now_ticks as usize) & (WHEEL_SLOTS - 1);
+            for entry in self.levels[0][slot].drain(..) {
+                self.stats.occupancy -= 1;
+                let active = unsafe { (*entry.timer).is_active() };
+                if active {
+                    self.stats.fires += 1;
+                    fired.push(entry);
+                }
+            }
+
+            if self.now_ticks == current_ticks {
+                break;
+            }
+            self.now_ticks += 1;
+        }
+
+        // The cached minimum may have just fired; recompute it.
+        if self.earliest <= current_time {
+            self.recompute_earliest();
+        }
+    }
+
+    /// Recompute the cached earliest deadline by scanning live entries
+    fn recompute_earliest(&mut self) {
+        let mut earliest = u64::MAX;
+        for level in self.levels.iter() {
+            for slot in level.iter() {
+                for entry in slot.iter() {
+                    let active = unsafe { (*entry.timer).is_active() };
+                    if active && entry.deadline < earliest {
+                        earliest = entry.deadline;
+                    }
+                }
+            }
+        }
+        self.earliest = earliest;
     }
 }
 
@@ -265,8 +458,8 @@ impl Ord for TimerQueueEntry {
 /// Global timer ID counter
 static mut TIMER_ID_COUNTER: u64 = 0;
 
-/// Global timer queue
-static mut TIMER_QUEUE: Mutex<BinaryHeap<TimerQueueEntry>> = Mutex::new(BinaryHeap::new());
+/// Global timer wheel
+static mut TIMER_QUEUE: Mutex<TimerWheel> = Mutex::new(TimerWheel::new());
 
 /// Next timer ID (for tie-breaking)
 fn next_timer_id() -> u64 {
@@ -295,12 +488,13 @@ pub fn timer_init() {
 /// Returns the deadline of the next timer to fire, or u64::MAX if no timers.
 pub fn next_deadline() -> u64 {
     let queue = unsafe { TIMER_QUEUE.lock() };
+    queue.earliest
+}
 
-    if let Some(entry) = queue.peek() {
-        entry.deadline
-    } else {
-        u64::MAX
-    }
+/// Get timer wheel statistics
+pub fn timer_stats() -> TimerStats {
+    let queue = unsafe { TIMER_QUEUE.lock() };
+    queue.stats
 }
 
 /// Process pending timers
@@ -308,16 +502,34 @@ pub fn next_deadline() -> u64 {
 /// Should be called from timer interrupt handler.
 /// Fires all timers whose deadline has passed.
 pub fn timer_tick(current_time: u64) {
-    // In a real implementation, this would:
-    // 1. Lock the timer queue
-    // 2. Pop all timers with deadline <= current_time
-    // 3. Fire each timer
-    // 4. Re-queue periodic timers
-
     log_trace!("Timer tick: time={}", current_time);
+
+    // Isolated CPUs don't service the shared wheel, so timer callbacks
+    // never run on a quiesced core. The boot CPU can never be isolated,
+    // which keeps the wheel drained.
+    let cpu = crate::kernel::percpu::current_cpu_num() as usize;
+    if crate::kernel::sched::isolation::is_isolated(cpu) {
+        return;
+    }
+
+    let mut fired = Vec::new();
+    unsafe {
+        TIMER_QUEUE.lock().expire(current_time, &mut fired);
+    }
+
+    // Fire outside the wheel lock: periodic callbacks re-arm via
+    // insert_timer, which takes it again.
+    for entry in fired {
+        let timer = unsafe { &*entry.timer };
+        timer.fire();
+
+        if timer.is_periodic() && timer.is_active() {
+            insert_timer(timer);
+        }
+    }
 }
 
-/// Insert a timer into the global queue
+/// Insert a timer into the global queue. O(1).
 ///
 /// # Arguments
 ///
@@ -331,25 +543,26 @@ pub fn insert_timer(timer: &Timer) {
     };
 
     unsafe {
-        TIMER_QUEUE.lock().push(entry);
+        TIMER_QUEUE.lock().insert(entry);
     }
 
     timer.slot.store(id, Ordering::Release);
 }
 
-/// Remove a timer from the global queue
+/// Remove a timer from the global queue. O(1).
+///
+/// Cancellation is lazy: the timer is marked inactive and the wheel
+/// drops its entry when the containing slot next drains.
 ///
 /// # Arguments
 ///
 /// * `timer` - Timer to remove
 pub fn remove_timer(timer: &Timer) {
-    let slot = timer.slot.load(Ordering::Acquire);
-
-    // In a real implementation, this would search and remove
-    // For now, just mark as inactive
     timer.active.store(false, Ordering::Release);
 
-    let _ = slot;
+    unsafe {
+        TIMER_QUEUE.lock().stats.cancels += 1;
+    }
 }
 
 /// ============================================================================
@@ -424,7 +637,7 @@ mod tests {
 
     #[test]
     fn test_timer_deadline() {
-        let timer = Timer::new();
+        let mut timer = Timer::new();
         timer.set_deadline(1000);
         assert_eq!(timer.deadline(), 1000);
         assert!(!timer.is_periodic());
@@ -432,7 +645,7 @@ mod tests {
 
     #[test]
     fn test_timer_periodic() {
-        let timer = Timer::new();
+        let mut timer = Timer::new();
         timer.set_periodic(1000, 100);
         assert_eq!(timer.deadline(), 1000);
         assert!(timer.is_periodic());
@@ -454,6 +667,88 @@ mod tests {
         assert!(!timer.is_active());
     }
 
+    #[test]
+    fn test_wheel_slot_for() {
+        let wheel = TimerWheel::new();
+
+        // Near deadlines hash to level 0, farther ones to coarser levels.
+        assert_eq!(wheel.slot_for(1), (0, 1));
+        assert_eq!(wheel.slot_for(63), (0, 63));
+        assert_eq!(wheel.slot_for(64), (1, 1));
+        assert_eq!(wheel.slot_for(64 * 64), (2, 1));
+        assert_eq!(wheel.slot_for(64 * 64 * 64), (3, 1));
+    }
+
+    #[test]
+    fn test_wheel_insert_expire() {
+        let mut wheel = TimerWheel::new();
+        let timer = Timer::new();
+        timer.set_deadline(5 << WHEEL_RESOLUTION_SHIFT);
+        timer.activate();
+
+        wheel.insert(TimerQueueEntry {
+            deadline: timer.deadline(),
+            id: 1,
+            timer: &timer,
+        });
+        assert_eq!(wheel.stats.occupancy, 1);
+        assert_eq!(wheel.earliest, timer.deadline());
+
+        // Not due yet.
+        let mut fired = Vec::new();
+        wheel.expire(4 << WHEEL_RESOLUTION_SHIFT, &mut fired);
+        assert!(fired.is_empty());
+
+        // Due now.
+        wheel.expire(6 << WHEEL_RESOLUTION_SHIFT, &mut fired);
+        assert_eq!(fired.len(), 1);
+        assert_eq!(wheel.stats.fires, 1);
+        assert_eq!(wheel.stats.occupancy, 0);
+        assert_eq!(wheel.earliest, u64::MAX);
+    }
+
+    #[test]
+    fn test_wheel_cascade() {
+        let mut wheel = TimerWheel::new();
+        let timer = Timer::new();
+        // 100 ticks out: parks in level 1, cascades to level 0 en route.
+        timer.set_deadline(100 << WHEEL_RESOLUTION_SHIFT);
+        timer.activate();
+
+        wheel.insert(TimerQueueEntry {
+            deadline: timer.deadline(),
+            id: 1,
+            timer: &timer,
+        });
+
+        let mut fired = Vec::new();
+        wheel.expire(101 << WHEEL_RESOLUTION_SHIFT, &mut fired);
+        assert_eq!(fired.len(), 1);
+        assert!(wheel.stats.cascades >= 1);
+        assert_eq!(wheel.stats.occupancy, 0);
+    }
+
+    #[test]
+    fn test_wheel_lazy_cancel() {
+        let mut wheel = TimerWheel::new();
+        let timer = Timer::new();
+        timer.set_deadline(2 << WHEEL_RESOLUTION_SHIFT);
+        timer.activate();
+
+        wheel.insert(TimerQueueEntry {
+            deadline: timer.deadline(),
+            id: 1,
+            timer: &timer,
+        });
+        timer.cancel();
+
+        // The cancelled entry is dropped when its slot drains, not fired.
+        let mut fired = Vec::new();
+        wheel.expire(3 << WHEEL_RESOLUTION_SHIFT, &mut fired);
+        assert!(fired.is_empty());
+        assert_eq!(wheel.stats.occupancy, 0);
+    }
+
     #[test]
     fn test_time_conversions() {
         assert_eq!(ns_to_us(1_000_000), 1_000);
@@ -15,6 +15,34 @@ use crate::rustux::types::*;
 /// Result type for VM operations
 pub type Result = core::result::Result<(), Status>;
 
+/// ============================================================================
+/// Mapping Flags
+/// ============================================================================
+///
+/// Cache policy occupies the low two bits of the mapping flags, matching
+/// `include/vm/arch_vm_aspace.h`. Architectures without a distinct
+/// device or write-combining type treat those policies as uncached.
+
+/// Normal write-back cached memory
+pub const ARCH_MMU_FLAG_CACHED: u64 = 0 << 0;
+/// Uncached memory
+pub const ARCH_MMU_FLAG_UNCACHED: u64 = 1 << 0;
+/// Uncached device memory (UNCACHED on arches without the distinction)
+pub const ARCH_MMU_FLAG_UNCACHED_DEVICE: u64 = 2 << 0;
+/// Write-combining memory, for framebuffers and streaming device buffers
+pub const ARCH_MMU_FLAG_WRITE_COMBINING: u64 = 3 << 0;
+/// Mask covering the cache policy bits
+pub const ARCH_MMU_FLAG_CACHE_MASK: u64 = 3 << 0;
+
+/// Mapping is accessible from user mode
+pub const ARCH_MMU_FLAG_PERM_USER: u64 = 1 << 2;
+/// Mapping is readable
+pub const ARCH_MMU_FLAG_PERM_READ: u64 = 1 << 3;
+/// Mapping is writable
+pub const ARCH_MMU_FLAG_PERM_WRITE: u64 = 1 << 4;
+/// Mapping is executable
+pub const ARCH_MMU_FLAG_PERM_EXECUTE: u64 = 1 << 5;
+
 /// Architecture-specific VM address space interface
 pub trait ArchVmAspaceInterface {
     /// Create a new address space
@@ -24,6 +52,10 @@ pub trait ArchVmAspaceInterface {
     fn destroy(&mut self);
 
     /// Map a physical page
+    ///
+    /// `flags` combines ARCH_MMU_FLAG_PERM_* permission bits with an
+    /// ARCH_MMU_FLAG_* cache policy; the policy selects the memory
+    /// type (x86 PAT index, arm64 MAIR attribute) of the mapping.
     fn map(&mut self, pa: PAddr, va: VAddr, flags: u64) -> Result;
 
     /// Unmap a virtual page
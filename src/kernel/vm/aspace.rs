@@ -345,7 +345,7 @@ impl AddressSpace {
 
         // Set user flag if this is a user address space
         let flags = if self.is_user() {
-            flags | PageTableFlags::User as u64
+            flags | PageTableFlags::User.0
         } else {
             flags
         };
@@ -372,7 +372,7 @@ impl AddressSpace {
 
         // Set user flag if this is a user address space
         let flags = if self.is_user() {
-            flags | PageTableFlags::User as u64
+            flags | PageTableFlags::User.0
         } else {
             flags
         };
@@ -487,7 +487,7 @@ mod tests {
 
     #[test]
     fn test_vm_mapping() {
-        let mapping = VmMapping::new(0x1000, 0x2000, 0x8000, MemProt::READ, MappingFlags::Anonymous);
+        let mapping = VmMapping::new(0x1000, 0x2000, 0x8000, MemProt::Read, MappingFlags::Anonymous);
 
         assert_eq!(mapping.base, 0x1000);
         assert_eq!(mapping.size, 0x2000);
@@ -500,15 +500,15 @@ mod tests {
 
     #[test]
     fn test_mapping_overlaps() {
-        let mapping1 = VmMapping::new(0x1000, 0x2000, 0, MemProt::READ, MappingFlags::None);
-        let mapping2 = VmMapping::new(0x2000, 0x2000, 0, MemProt::READ, MappingFlags::None);
-        let mapping3 = VmMapping::new(0x4000, 0x1000, 0, MemProt::READ, MappingFlags::None);
+        let mapping1 = VmMapping::new(0x1000, 0x2000, 0, MemProt::Read, MappingFlags::None);
+        let mapping2 = VmMapping::new(0x3000, 0x1000, 0, MemProt::Read, MappingFlags::None);
+        let mapping3 = VmMapping::new(0x4000, 0x1000, 0, MemProt::Read, MappingFlags::None);
 
         // Adjacent mappings don't overlap
         assert!(!mapping1.overlaps(&mapping2));
 
         // Overlapping mapping
-        let mapping4 = VmMapping::new(0x1500, 0x1000, 0, MemProt::READ, MappingFlags::None);
+        let mapping4 = VmMapping::new(0x1500, 0x1000, 0, MemProt::Read, MappingFlags::None);
         assert!(mapping1.overlaps(&mapping4));
 
         // Non-overlapping
@@ -175,7 +175,7 @@ fn map_kernel_region(aspace: &AddressSpace, desc: KernelMapDesc) -> Result {
     let pt_flags = PageTableFlags::from_prot(desc.prot);
 
     // Kernel mappings don't have user flag
-    let base_flags = pt_flags & !(PageTableFlags::User as u64);
+    let base_flags = pt_flags & !PageTableFlags::User.0;
 
     // Determine physical address (use virt if phys is 0)
     let paddr = if desc.phys_addr == 0 {
@@ -548,7 +548,7 @@ mod tests {
 
         let formatted = result.format();
         // The format should contain the addresses
-        assert!(formatted.to_string().contains("ffff800000100000"));
+        assert!(format!("{}", formatted).contains("ffff800000100000"));
     }
 
     #[test]
@@ -418,26 +418,29 @@ pub const fn page_index_to_virt(page_index: usize) -> VAddr {
 /// ============================================================================
 
 /// Memory protection flags that are consistent across architectures
-#[repr(u8)]
+///
+/// Protections are bit combinations; named values cover the common cases
+/// and arbitrary combinations (e.g. read + execute) remain representable.
+#[repr(transparent)]
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
-pub enum MemProt {
+pub struct MemProt(pub u8);
+
+impl MemProt {
     /// No access
-    None = 0,
+    pub const None: Self = Self(0);
 
     /// Read-only
-    Read = 1 << 0,
+    pub const Read: Self = Self(1 << 0);
 
     /// Write (implies read)
-    Write = 1 << 1,
+    pub const Write: Self = Self(1 << 1);
 
     /// Read + Write
-    ReadWrite = 1 << 0 | 1 << 1,
+    pub const ReadWrite: Self = Self(1 << 0 | 1 << 1);
 
     /// Execute (Write-Xor-Execute enforced)
-    Execute = 1 << 2,
-}
+    pub const Execute: Self = Self(1 << 2);
 
-impl MemProt {
     /// No access
     pub const NONE: u8 = 0;
 
@@ -451,30 +454,30 @@ impl MemProt {
     pub const EXEC: u8 = 1 << 2;
 
     /// Read + Write
-    pub const RW: u8 = Self::READ as u8 | Self::WRITE as u8;
+    pub const RW: u8 = Self::READ | Self::WRITE;
 
     /// Read + Execute
-    pub const RX: u8 = Self::READ as u8 | Self::EXEC as u8;
+    pub const RX: u8 = Self::READ | Self::EXEC;
 
     /// Read + Write + Execute (should be disallowed by W^X)
-    pub const RWX: u8 = Self::READ as u8 | Self::WRITE as u8 | Self::EXEC as u8;
+    pub const RWX: u8 = Self::READ | Self::WRITE | Self::EXEC;
 
     /// Check if read is enabled
     #[inline]
     pub const fn can_read(self) -> bool {
-        (self as u8 & Self::READ) != 0
+        (self.0 & Self::READ) != 0
     }
 
     /// Check if write is enabled
     #[inline]
     pub const fn can_write(self) -> bool {
-        (self as u8 & Self::WRITE) != 0
+        (self.0 & Self::WRITE) != 0
     }
 
     /// Check if execute is enabled
     #[inline]
     pub const fn can_execute(self) -> bool {
-        (self as u8 & Self::EXEC) != 0
+        (self.0 & Self::EXEC) != 0
     }
 
     /// Validate that W^X is enforced (no W + X together)
@@ -507,20 +510,7 @@ impl core::ops::BitOr for MemProt {
     type Output = Self;
 
     fn bitor(self, rhs: Self) -> Self::Output {
-        // Convert to u8, OR them together, and convert back
-        let val = (self as u8) | (rhs as u8);
-        // Map back to enum variant
-        match val {
-            0 => MemProt::None,
-            1 => MemProt::Read,
-            2 => MemProt::Write,
-            3 => MemProt::ReadWrite,
-            4 => MemProt::Execute,
-            5 => MemProt::Read | MemProt::Execute, // R + X
-            6 => MemProt::Write | MemProt::Execute, // W + X (invalid but possible)
-            7 => MemProt::ReadWrite | MemProt::Execute, // R + W + X (invalid but possible)
-            _ => MemProt::None,
-        }
+        Self(self.0 | rhs.0)
     }
 }
 
@@ -423,20 +423,22 @@ mod tests {
 
     #[test]
     fn test_mem_prot() {
-        assert!(MemProt::READ.can_read());
-        assert!(!MemProt::READ.can_write());
-        assert!(!MemProt::READ.can_execute());
-
-        assert!(MemProt::WRITE.can_write());
-        assert!(MemProt::WRITE.can_read()); // Write implies read
-
-        assert!(MemProt::EXEC.can_execute());
-        assert!(!MemProt::EXEC.can_write());
-
-        // W^X validation
-        assert!(MemProt::READ.is_valid_wxorx());
-        assert!(MemProt::WRITE.is_valid_wxorx());
-        assert!(MemProt::EXEC.is_valid_wxorx());
-        assert!((MemProt::WRITE | MemProt::EXEC).is_valid_wxorx()); // Invalid!
+        assert!(MemProt::Read.can_read());
+        assert!(!MemProt::Read.can_write());
+        assert!(!MemProt::Read.can_execute());
+
+        assert!(MemProt::Write.can_write());
+        assert!(MemProt::ReadWrite.can_read());
+        assert!(MemProt::ReadWrite.can_write());
+
+        assert!(MemProt::Execute.can_execute());
+        assert!(!MemProt::Execute.can_write());
+
+        // W^X validation: no single variant combines write and execute,
+        // so every variant must pass
+        assert!(MemProt::Read.is_valid_wxorx());
+        assert!(MemProt::Write.is_valid_wxorx());
+        assert!(MemProt::ReadWrite.is_valid_wxorx());
+        assert!(MemProt::Execute.is_valid_wxorx());
     }
 }
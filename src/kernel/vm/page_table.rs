@@ -33,44 +33,49 @@ use core::fmt;
 /// ============================================================================
 
 /// Page table entry flags that are consistent across architectures
-#[repr(u64)]
+///
+/// Individual flags are disjoint bits and may be combined; hardware entries
+/// routinely carry several of them at once.
+#[repr(transparent)]
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
-pub enum PageTableFlags {
+pub struct PageTableFlags(pub u64);
+
+impl PageTableFlags {
     /// Invalid / not present
-    None = 0,
+    pub const None: Self = Self(0);
 
     /// Present / valid mapping
-    Present = 1 << 0,
+    pub const Present: Self = Self(1 << 0);
 
     /// Writable
-    Write = 1 << 1,
+    pub const Write: Self = Self(1 << 1);
 
     /// User-accessible (not kernel-only)
-    User = 1 << 2,
+    pub const User: Self = Self(1 << 2);
 
     /// Write-through caching
-    WriteThrough = 1 << 3,
+    pub const WriteThrough: Self = Self(1 << 3);
 
     /// Cache disable
-    CacheDisable = 1 << 4,
+    pub const CacheDisable: Self = Self(1 << 4);
 
     /// Accessed flag (set by hardware)
-    Accessed = 1 << 5,
+    pub const Accessed: Self = Self(1 << 5);
 
     /// Dirty flag (set by hardware for writable mappings)
-    Dirty = 1 << 6,
+    pub const Dirty: Self = Self(1 << 6);
 
     /// Global mapping (not flushed on TLB shootdown)
-    Global = 1 << 8,
+    pub const Global: Self = Self(1 << 8);
 
     /// No-execute / execute-never
-    NoExecute = 1 << 63,
+    pub const NoExecute: Self = Self(1 << 63);
 
     /// Device memory (uncacheable, device attributes)
-    Device = 1 << 9,
+    pub const Device: Self = Self(1 << 9);
 
     /// Normal memory (write-back cacheable)
-    Normal = 1 << 10,
+    pub const Normal: Self = Self(1 << 10);
 }
 
 impl PageTableFlags {
@@ -78,45 +83,45 @@ impl PageTableFlags {
     pub const NONE: u64 = 0;
 
     /// Present + writable (kernel-private, data)
-    pub const KERNEL_DATA: u64 = (Self::Present as u64) | (Self::Write as u64);
+    pub const KERNEL_DATA: u64 = Self::Present.0 | Self::Write.0;
 
     /// Present + read-only (kernel-private, code)
-    pub const KERNEL_CODE: u64 = (Self::Present as u64);
+    pub const KERNEL_CODE: u64 = Self::Present.0;
 
     /// Present + user + writable (user data)
-    pub const USER_DATA: u64 = (Self::Present as u64) | (Self::Write as u64) | (Self::User as u64);
+    pub const USER_DATA: u64 = Self::Present.0 | Self::Write.0 | Self::User.0;
 
     /// Present + user + read-only (user code)
-    pub const USER_CODE: u64 = (Self::Present as u64) | (Self::User as u64);
+    pub const USER_CODE: u64 = Self::Present.0 | Self::User.0;
 
     /// Create flags from raw bits
     pub const fn from_bits(bits: u64) -> Self {
-        unsafe { core::mem::transmute(bits) }
+        Self(bits)
     }
 
     /// Convert to raw bits
     pub const fn bits(self) -> u64 {
-        self as u64
+        self.0
     }
 
     /// Check if present flag is set
     pub const fn is_present(self) -> bool {
-        (self as u64 & Self::Present as u64) != 0
+        (self.0 & Self::Present.0) != 0
     }
 
     /// Check if writable flag is set
     pub const fn is_writable(self) -> bool {
-        (self as u64 & Self::Write as u64) != 0
+        (self.0 & Self::Write.0) != 0
     }
 
     /// Check if user-accessible flag is set
     pub const fn is_user(self) -> bool {
-        (self as u64 & Self::User as u64) != 0
+        (self.0 & Self::User.0) != 0
     }
 
     /// Check if no-execute flag is set
     pub const fn is_no_execute(self) -> bool {
-        (self as u64 & Self::NoExecute as u64) != 0
+        (self.0 & Self::NoExecute.0) != 0
     }
 
     /// Check if this mapping allows execution
@@ -126,15 +131,15 @@ impl PageTableFlags {
 
     /// Convert memory protection to page table flags
     pub const fn from_prot(prot: MemProt) -> u64 {
-        let mut flags = Self::Present as u64;
+        let mut flags = Self::Present.0;
 
         if prot.can_write() {
-            flags |= Self::Write as u64;
+            flags |= Self::Write.0;
         }
 
         // W^X: Execute flag is inverted (NoExecute)
         if !prot.can_execute() {
-            flags |= Self::NoExecute as u64;
+            flags |= Self::NoExecute.0;
         }
 
         // For user mappings, set user bit
@@ -167,13 +172,13 @@ impl PageTableFlags {
 
     /// Apply W^X policy to flags
     pub const fn enforce_wxorx(self) -> u64 {
-        let bits = self as u64;
-        let has_write = (bits & Self::Write as u64) != 0;
-        let has_execute = (bits & Self::NoExecute as u64) == 0;
+        let bits = self.0;
+        let has_write = (bits & Self::Write.0) != 0;
+        let has_execute = (bits & Self::NoExecute.0) == 0;
 
         if has_write && has_execute {
             // Clear execute if both write and execute are set
-            bits | Self::NoExecute as u64
+            bits | Self::NoExecute.0
         } else {
             bits
         }
@@ -550,22 +555,21 @@ mod tests {
 
     #[test]
     fn test_flags() {
-        let flags = PageTableFlags::KERNEL_DATA;
+        let flags = PageTableFlags::from_bits(PageTableFlags::KERNEL_DATA);
         assert!(flags.is_present());
         assert!(flags.is_writable());
         assert!(!flags.is_user());
-
-        let flags = PageTableFlags::from_bits(PageTableFlags::KERNEL_DATA);
         assert_eq!(flags.bits(), PageTableFlags::KERNEL_DATA);
     }
 
     #[test]
     fn test_wxorx() {
         // W + X should be rejected
-        let bad_flags = PageTableFlags::Write | PageTableFlags::Present;
+        let bad_flags =
+            PageTableFlags::from_bits(PageTableFlags::Write.0 | PageTableFlags::Present.0);
         let enforced = bad_flags.enforce_wxorx();
         // Should have NoExecute set
-        assert!(enforced & PageTableFlags::NoExecute as u64 != 0);
+        assert!(enforced & PageTableFlags::NoExecute.0 != 0);
     }
 
     #[test]
@@ -693,7 +693,7 @@ mod tests {
 
     #[test]
     fn test_fault_flags() {
-        let flags = PageFaultFlags::WRITE | PageFaultFlags::USER;
+        let flags = PageFaultFlags(PageFaultFlags::WRITE.0 | PageFaultFlags::USER.0);
         assert!(flags.is_write());
         assert!(flags.is_user());
         assert!(!flags.is_read());
@@ -37,6 +37,7 @@ use crate::kernel::vm::aspace::*;
 use crate::kernel::vm::{VmError, Result};
 use crate::kernel::pmm;
 use crate::kernel::sync::Mutex;
+use alloc::vec::Vec;
 use core::sync::atomic::{AtomicU64, Ordering};
 
 // Import logging macros
@@ -61,6 +62,9 @@ pub const STACK_ALIGN: usize = 16;
 /// Number of guard pages
 pub const GUARD_PAGES: usize = 1;
 
+/// Maximum number of freed default-size stacks kept for reuse
+pub const MAX_CACHED_STACKS: usize = 64;
+
 /// ============================================================================
 /// Kernel Stack Descriptor
 /// ============================================================================
@@ -153,6 +157,9 @@ pub struct StackStats {
 
     /// Number of stack overflows detected
     pub overflows: u64,
+
+    /// Stacks currently sitting in the reuse cache
+    pub cached_stacks: u64,
 }
 
 /// Stack allocator for kernel stacks
@@ -166,6 +173,10 @@ pub struct StackAllocator {
     /// Total size of stack region
     total_size: usize,
 
+    /// Freed default-size stacks held for reuse. Reusing a stack skips
+    /// both the VA carve-out and the pmm round trip on the next alloc.
+    cache: Mutex<Vec<KernelStack>>,
+
     /// Statistics
     stats: Mutex<StackStats>,
 }
@@ -177,11 +188,13 @@ impl StackAllocator {
             base_vaddr,
             next_offset: AtomicU64::new(0),
             total_size,
+            cache: Mutex::new(Vec::new()),
             stats: Mutex::new(StackStats {
                 total_stacks: 0,
                 active_stacks: 0,
                 total_memory: 0,
                 overflows: 0,
+                cached_stacks: 0,
             }),
         }
     }
@@ -193,6 +206,28 @@ impl StackAllocator {
             return Err(VmError::InvalidArgs);
         }
 
+        // Reuse a cached stack when possible; only default-size stacks
+        // are cached, so a size match is a full match.
+        if size == DEFAULT_KERNEL_STACK_SIZE {
+            if let Some(mut stack) = self.cache.lock().pop() {
+                stack.owner_id = owner_id;
+
+                {
+                    let mut stats = self.stats.lock();
+                    stats.active_stacks += 1;
+                    stats.cached_stacks -= 1;
+                }
+
+                log_debug!(
+                    "Reused cached stack: owner={} top={:#x}",
+                    owner_id,
+                    stack.top
+                );
+
+                return Ok(stack);
+            }
+        }
+
         // Align to page size
         let total_size = page_align_up(size) + (GUARD_PAGES * PAGE_SIZE);
 
@@ -250,27 +285,86 @@ impl StackAllocator {
         Ok(stack)
     }
 
-    /// Free a kernel stack
-    pub fn free_stack(&self, stack: KernelStack) {
-        // Free physical pages
+    /// Release a stack's physical pages back to the pmm
+    fn release_pages(stack: &KernelStack) {
         for i in 0..stack.num_pages {
             let paddr = (stack.phys_base + (i * PAGE_SIZE)) as u64;
             pmm::pmm_free_page(paddr);
         }
+    }
+
+    /// Free a kernel stack
+    ///
+    /// Default-size stacks go back to the reuse cache while it has room;
+    /// everything else returns to the pmm.
+    pub fn free_stack(&self, stack: KernelStack) {
+        let mut cached = false;
+
+        if stack.size == DEFAULT_KERNEL_STACK_SIZE {
+            let mut cache = self.cache.lock();
+            if cache.len() < MAX_CACHED_STACKS {
+                cache.push(stack.clone());
+                cached = true;
+            }
+        }
+
+        if !cached {
+            Self::release_pages(&stack);
+        }
 
         // Update statistics
         {
             let mut stats = self.stats.lock();
             stats.active_stacks -= 1;
+            if cached {
+                stats.cached_stacks += 1;
+            }
         }
 
         log_debug!(
-            "Freed stack: owner={} base={:#x}",
+            "Freed stack: owner={} base={:#x} cached={}",
             stack.owner_id,
-            stack.base
+            stack.base,
+            cached
         );
     }
 
+    /// Free a batch of kernel stacks
+    ///
+    /// Takes the cache and stats locks once for the whole batch, so the
+    /// reaper can return a teardown's worth of stacks without paying a
+    /// lock round trip per thread.
+    pub fn free_stack_batch(&self, stacks: Vec<KernelStack>) {
+        if stacks.is_empty() {
+            return;
+        }
+
+        let freed = stacks.len();
+        let mut cached = 0u64;
+
+        {
+            let mut cache = self.cache.lock();
+            for stack in stacks {
+                if stack.size == DEFAULT_KERNEL_STACK_SIZE
+                    && cache.len() < MAX_CACHED_STACKS
+                {
+                    cache.push(stack);
+                    cached += 1;
+                } else {
+                    Self::release_pages(&stack);
+                }
+            }
+        }
+
+        {
+            let mut stats = self.stats.lock();
+            stats.active_stacks -= freed as u64;
+            stats.cached_stacks += cached;
+        }
+
+        log_debug!("Freed {} stacks in batch ({} cached)", freed, cached);
+    }
+
     /// Get allocator statistics
     pub fn stats(&self) -> StackStats {
         self.stats.lock().clone()
@@ -359,6 +453,20 @@ pub fn free_kernel_stack(stack: KernelStack) {
     }
 }
 
+/// Free a batch of kernel stacks
+///
+/// Used by the thread reaper to return many stacks in one pass.
+pub fn free_kernel_stack_batch(stacks: Vec<KernelStack>) {
+    unsafe {
+        match &GLOBAL_STACK_ALLOCATOR {
+            Some(alloc) => alloc.free_stack_batch(stacks),
+            None => {
+                log_error!("Stack allocator not initialized");
+            }
+        }
+    }
+}
+
 /// Get stack allocator statistics
 pub fn get_stack_stats() -> Option<StackStats> {
     unsafe {
@@ -429,6 +537,14 @@ mod tests {
         assert_eq!(DEFAULT_KERNEL_STACK_SIZE, 64 * 1024);
     }
 
+    #[test]
+    fn test_cache_capacity() {
+        // The cache bounds how much stack memory an idle system can hold
+        // back from the pmm: cap times the default stack footprint.
+        assert!(MAX_CACHED_STACKS > 0);
+        assert!(MAX_CACHED_STACKS * DEFAULT_KERNEL_STACK_SIZE <= 16 * 1024 * 1024);
+    }
+
     #[test]
     fn test_stack_alignment() {
         assert_eq!(STACK_ALIGN, 16);
@@ -10,7 +10,8 @@
 //! The actual kernel initialization happens in the kernel module.
 
 #![no_std]
-#![no_main]
+// The test harness provides its own `main`; keep `no_main` for kernel builds only.
+#![cfg_attr(not(test), no_main)]
 #![feature(core_intrinsics)]
 #![feature(asm)]
 #![feature(asm_experimental_arch)]
@@ -347,6 +348,7 @@ fn panic(_info: &PanicInfo) -> ! {
 /// Exception handling personality function
 ///
 /// This is required by the compiler even though we don't use exceptions.
+#[cfg(not(test))]
 #[no_mangle]
 pub extern "C" fn rust_eh_personality() -> ! {
     loop {